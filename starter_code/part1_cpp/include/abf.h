@@ -0,0 +1,113 @@
+/**
+ * @file abf.h
+ * @brief ABF++ (Angle Based Flattening) parameterization
+ *
+ * Implementation in abf.cpp. Takes the same island input as
+ * lscm_parameterize and returns UVs in the same layout, so the two
+ * backends are interchangeable per island.
+ */
+
+#ifndef ABF_H
+#define ABF_H
+
+#include "mesh.h"
+#include "topology.h"
+#include "lscm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Which method produced the UVs of an abf_parameterize_ex call
+ */
+typedef enum {
+    ABF_RESULT_ABF = 0,            /**< Converged ABF++ angles, laid out by angle-based LSCM */
+    ABF_RESULT_LSCM_FALLBACK = 1   /**< Plain LSCM: no boundary, no convergence within the
+                                        iteration cap or time budget, or a failed solve */
+} ABFResult;
+
+/**
+ * @brief Iteration counts and timings of one abf_parameterize_ex call
+ */
+typedef struct {
+    int result;                  /**< ABFResult */
+    int iterations;              /**< Newton steps taken */
+    int interior_vertices;       /**< Vertices with planarity and length constraints */
+    double gradient_norm;        /**< Largest |∇L| entry after the last step (radians) */
+    double solve_seconds;        /**< Newton iterations, including factorizations */
+    double layout_seconds;       /**< Angle-based LSCM (or the fallback LSCM) */
+} ABFStats;
+
+/**
+ * @brief Optional inputs for abf_parameterize_ex
+ *
+ * A zero-initialised struct (or NULL) gives the same behaviour as
+ * abf_parameterize.
+ */
+typedef struct {
+    double time_budget_seconds;     /**< Stop Newton and fall back to LSCM when the next step would
+                                         exceed this (0 = no budget) */
+    int max_iterations;             /**< Newton step cap (0 = 20) */
+    double tolerance;               /**< Converged when every |∇L| entry is below this, in
+                                         radians (0 = 1e-6) */
+    const HalfEdgeMesh* halfedge;   /**< Passed to LSCM (may be NULL) */
+    const int* face_island_ids;     /**< Passed to LSCM (may be NULL) */
+    int* local_to_global;           /**< Optional output (capacity 3 * num_faces): mesh vertex
+                                         of each returned UV, in the same order */
+    int* num_local_out;             /**< Optional output: number of returned UVs */
+    int num_threads;                /**< Threads for the LSCM layout (0 = all hardware threads) */
+    ABFStats* stats;                /**< Optional output: iterations and timings */
+    const LSCMOptions* lscm;        /**< Optional settings for the LSCM layout and fallback
+                                         (solver, precision, CG, multigrid, initial_uvs, stats);
+                                         the fields above replace its adjacency, outputs and
+                                         threads, and corner_angles is set by ABF++ */
+} ABFOptions;
+
+/**
+ * @brief Parameterize a UV island with ABF++
+ *
+ * Algorithm:
+ * 1. Target angles β: the 3D corner angles, scaled to sum to 2π around
+ *    interior vertices; weights 1/β²
+ * 2. Newton iterations on the angles α minimising Σ (α - β)² / β² subject
+ *    to triangle sums (π), planarity (2π around interior vertices) and the
+ *    sine-rule length consistency around interior vertices
+ * 3. Each step eliminates the angles and the per-triangle multipliers
+ *    (both diagonal blocks), leaving one sparse SPD system over the
+ *    2 x interior-vertex multipliers, solved with LDLT (pattern analysed once)
+ * 4. Lay out the triangles from the angles with angle-based LSCM
+ *
+ * Falls back to plain LSCM when the island is closed, Newton does not
+ * converge within max_iterations or the time budget, or a solve fails.
+ *
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @return Array of UVs [u,v, u,v, ...] for island vertices, normalized to
+ *         [0,1]², in lscm_parameterize order
+ * @note Caller must free returned array
+ */
+float* abf_parameterize(const Mesh* mesh,
+                        const int* face_indices,
+                        int num_faces);
+
+/**
+ * @brief Parameterize a UV island with ABF++, with explicit options
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @param options Optional inputs (may be NULL)
+ * @return Array of UVs [u,v, u,v, ...] for island vertices
+ * @note Caller must free returned array
+ */
+float* abf_parameterize_ex(const Mesh* mesh,
+                           const int* face_indices,
+                           int num_faces,
+                           const ABFOptions* options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ABF_H */
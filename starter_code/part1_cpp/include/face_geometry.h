@@ -0,0 +1,92 @@
+/**
+ * @file face_geometry.h
+ * @brief Cached per-face normals/areas and per-edge sharpness
+ *
+ * Implementation in face_geometry.cpp (AVX2 / NEON kernels with a scalar
+ * fallback; AVX2 is selected at run time from the CPU features)
+ */
+
+#ifndef FACE_GEOMETRY_H
+#define FACE_GEOMETRY_H
+
+#include "mesh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Per-face geometry in structure-of-arrays layout
+ *
+ * Normals are unit length (zero for degenerate or invalid faces), areas are
+ * half the cross-product length.
+ */
+typedef struct {
+    int num_faces;         /**< Number of faces */
+    float* nx;             /**< Normal x per face */
+    float* ny;             /**< Normal y per face */
+    float* nz;             /**< Normal z per face */
+    float* area;           /**< 3D area per face */
+} FaceGeometry;
+
+/**
+ * @brief Compute normals and areas of all faces in one pass
+ * @param mesh Input mesh
+ * @return Newly allocated buffers, or NULL on error
+ * @note Caller must free with free_face_geometry()
+ */
+FaceGeometry* compute_face_geometry(const Mesh* mesh);
+
+/**
+ * @brief Free face geometry memory
+ * @param geom Buffers to free (may be NULL)
+ */
+void free_face_geometry(FaceGeometry* geom);
+
+/**
+ * @brief Edge sharpness from cached normals: 1 - dot(n0, n1)
+ *
+ * 0 for coplanar faces, 1 at 90°, 2 for folded-back faces. Boundary edges
+ * (f1 = -1) get 1.
+ *
+ * @param geom Face normals
+ * @param edge_faces Adjacent faces per edge [f0,f1, ...] (2 * num_edges)
+ * @param num_edges Number of edges
+ * @param sharpness_out Output: sharpness per edge (num_edges)
+ */
+void compute_edge_sharpness(const FaceGeometry* geom,
+                            const int* edge_faces,
+                            int num_edges,
+                            float* sharpness_out);
+
+/**
+ * @brief Label every interior edge as sharp (1) or smooth (0)
+ *
+ * An edge is sharp when the angle between its face normals exceeds
+ * angle_threshold, i.e. sharpness > 1 - cos(angle_threshold). Boundary
+ * edges are always 0. One SIMD compare pass over the cached sharpness, so
+ * a threshold sweep can re-run this without touching topology or normals.
+ *
+ * @param edge_sharpness Cached sharpness per edge (num_edges)
+ * @param edge_faces Adjacent faces per edge [f0,f1, ...] (2 * num_edges)
+ * @param num_edges Number of edges
+ * @param angle_threshold Dihedral threshold in degrees
+ * @param sharp_out Output: 1 = sharp, 0 = smooth or boundary (num_edges)
+ * @return Number of sharp edges
+ */
+int classify_sharp_edges(const float* edge_sharpness,
+                         const int* edge_faces,
+                         int num_edges,
+                         float angle_threshold,
+                         unsigned char* sharp_out);
+
+/**
+ * @brief Name of the kernel in use on this CPU ("avx2", "neon" or "scalar")
+ */
+const char* face_geometry_kernel_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACE_GEOMETRY_H */
@@ -9,6 +9,7 @@
 #define LSCM_H
 
 #include "mesh.h"
+#include "topology.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,7 +24,7 @@ extern "C" {
  *    - For each triangle, add energy contribution
  *    - Energy: ||∇u - R_90°(∇v)||²
  * 3. Set boundary conditions (pin 2 vertices to prevent degeneracy)
- * 4. Solve sparse linear system
+ * 4. Solve sparse linear system (symmetric normal equations, LDLT)
  * 5. Normalize UVs to [0,1]²
  *
  * @param mesh Input mesh
@@ -44,12 +45,225 @@ float* lscm_parameterize(const Mesh* mesh,
                          const int* face_indices,
                          int num_faces);
 
+/**
+ * @brief Linear solver used by lscm_parameterize_ex
+ */
+typedef enum {
+    LSCM_SOLVER_LDLT = 0,        /**< SPD normal equations, SimplicialLDLT with AMD ordering (default) */
+    LSCM_SOLVER_SPARSE_LU = 1,   /**< Reference square system, SparseLU */
+    LSCM_SOLVER_CHOLMOD = 2,     /**< SPD normal equations, CHOLMOD supernodal LLT
+                                      (LDLT when built without UVUNWRAP_ENABLE_CHOLMOD) */
+    LSCM_SOLVER_CG = 3,          /**< SPD normal equations, preconditioned conjugate gradient
+                                      (inexact, warm-startable) */
+    LSCM_SOLVER_MULTIGRID = 4    /**< Edge-collapse hierarchy, coarse LDLT + CG smoothing per level
+                                      (approximate, linear memory; LDLT switches to it above
+                                      LSCMOptions::mg_auto_vertices when that is set) */
+} LSCMSolver;
+
+/**
+ * @brief Preconditioner for LSCM_SOLVER_CG
+ */
+typedef enum {
+    LSCM_PRECOND_JACOBI = 0,     /**< Diagonal scaling: no setup cost (default) */
+    LSCM_PRECOND_ICHOL = 1       /**< Incomplete Cholesky with AMD ordering: fewer iterations */
+} LSCMPreconditioner;
+
+/**
+ * @brief Arithmetic of the LDLT / SparseLU factorization
+ *
+ * The system is always assembled in double. Float factors take half the
+ * memory and bandwidth but bypass the factorization cache.
+ */
+typedef enum {
+    LSCM_PRECISION_DOUBLE = 0,   /**< Double factor and solve (default) */
+    LSCM_PRECISION_FLOAT = 1,    /**< Float factor and solve; residual reported, not enforced */
+    LSCM_PRECISION_MIXED = 2     /**< Float factor, then iterative refinement against the double
+                                      residual until refine_tolerance; a double factorization
+                                      if refinement stalls */
+} LSCMPrecision;
+
+/**
+ * @brief How a direct solve used the factorization cache
+ */
+typedef enum {
+    LSCM_CACHE_UNUSED = 0,        /**< Cache disabled, or an iterative / CHOLMOD solve */
+    LSCM_CACHE_MISS = 1,          /**< Full symbolic analysis + numeric factorization */
+    LSCM_CACHE_SYMBOLIC_HIT = 2,  /**< Same connectivity, new geometry: numeric factorization only */
+    LSCM_CACHE_NUMERIC_HIT = 3    /**< Same connectivity and geometry: cached factor reused */
+} LSCMCacheResult;
+
+/**
+ * @brief Timings and sizes of one lscm_parameterize_ex call
+ *
+ * factor_nonzeros counts the stored factor entries (L for LDLT/CHOLMOD,
+ * L + U for SparseLU, 0 for CG), a proxy for the solver's memory use. For
+ * CG, factor_seconds is the preconditioner setup.
+ */
+typedef struct {
+    double assemble_seconds;     /**< Matrix assembly */
+    double factor_seconds;       /**< Ordering + numeric factorization */
+    double solve_seconds;        /**< Triangular solves */
+    long long matrix_nonzeros;   /**< Stored entries of the reduced system */
+    long long factor_nonzeros;   /**< Stored entries of the factor(s) */
+    int solver_used;             /**< LSCMSolver that produced the result (after any fallback) */
+    int cache_result;            /**< LSCMCacheResult of the factorization */
+    int iterations;              /**< CG iterations, summed over multigrid levels (0 for direct solvers) */
+    double residual;             /**< Relative residual |b - Ax| / |b| of CG, multigrid and float /
+                                      mixed solves (0 for double direct solvers) */
+    int mg_levels;               /**< Multigrid levels including the island itself (0 otherwise) */
+    int precision_used;          /**< LSCMPrecision of the factor that produced the result */
+    int refinement_steps;        /**< Mixed precision: refinement solves after the first */
+} LSCMStats;
+
+/**
+ * @brief Optional inputs for lscm_parameterize_ex
+ *
+ * A zero-initialised struct (or NULL) gives the same behaviour as
+ * lscm_parameterize.
+ */
+typedef struct {
+    const HalfEdgeMesh* halfedge;   /**< Shared adjacency from build_topology (may be NULL) */
+    const int* face_island_ids;     /**< Island ID per face; with halfedge, boundary
+                                         detection walks half-edges instead of counting edges */
+    int* local_to_global;           /**< Optional output (capacity 3 * num_faces): mesh vertex
+                                         of each returned UV, in the same order */
+    int* num_local_out;             /**< Optional output: number of returned UVs */
+    int num_threads;                /**< Threads for matrix assembly on large islands
+                                         (0 = all hardware threads) */
+    int solver;                     /**< LSCMSolver (0 = LDLT); SparseLU is the fallback
+                                         if a Cholesky factorization fails */
+    LSCMStats* stats;               /**< Optional output: timings and sizes */
+    double cg_tolerance;            /**< CG relative residual target |b - Ax| / |b| (0 = 1e-6) */
+    int cg_max_iterations;          /**< CG iteration cap (0 = twice the number of unknowns) */
+    int cg_preconditioner;          /**< LSCMPreconditioner (0 = Jacobi) */
+    const float* initial_uvs;       /**< Optional CG starting UVs per mesh vertex (2 * num_vertices),
+                                         e.g. the previous unwrap; NULL = planar projection */
+    int mg_coarse_vertices;         /**< Multigrid: stop coarsening at this many vertices (0 = 4096) */
+    int mg_smoothing_iterations;    /**< Multigrid: CG sweeps on the finest level, sqrt(n / n_level)
+                                         times as many on coarser levels (0 = 30) */
+    int precision;                  /**< LSCMPrecision of the LDLT / SparseLU solve (0 = double) */
+    double refine_tolerance;        /**< Mixed precision: relative residual target (0 = 1e-10) */
+    const float* corner_angles;     /**< Optional target angles in radians, 3 per face in
+                                         face_indices order: triangles take their shape from
+                                         these instead of the 3D positions (angle-based LSCM,
+                                         see abf.h); multigrid is not used with them */
+    int mg_auto_vertices;           /**< LSCM_SOLVER_LDLT: islands above this many vertices use
+                                         the multigrid solver instead, whose memory stays linear
+                                         (0 = never; e.g. 1 << 19 where a factor would not fit) */
+} LSCMOptions;
+
+/**
+ * @brief Parameterize a UV island using LSCM, with optional shared adjacency
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @param options Optional inputs (may be NULL)
+ * @return Array of UVs [u,v, u,v, ...] for vertices in island
+ * @note Caller must free returned array
+ */
+float* lscm_parameterize_ex(const Mesh* mesh,
+                            const int* face_indices,
+                            int num_faces,
+                            const LSCMOptions* options);
+
+/**
+ * @brief One island's pinned LSCM system, as the solvers receive it
+ *
+ * Unknowns are (u, v) of the free local vertices in local order, the two
+ * pins left out: free vertex c is block c minus the number of pins before
+ * it. Columns are stored compressed with ascending rows. The normal
+ * equations keep only the lower triangle (plus one upper entry per
+ * diagonal block).
+ */
+typedef struct {
+    int num_local;               /**< Island vertices n */
+    int* local_to_global;        /**< Mesh vertex of each local vertex (num_local) */
+    int pins[2];                 /**< Local indices of the pinned vertices */
+    double pin_uvs[4];           /**< Pinned UVs (u0, v0, u1, v1) */
+    int size;                    /**< Rows and columns: 2 * (num_local - 2) */
+    int* col_offsets;            /**< Column starts (size + 1) */
+    int* row_indices;            /**< Row of each stored entry (col_offsets[size]) */
+    double* values;              /**< Value of each stored entry (col_offsets[size]) */
+    double* rhs;                 /**< Right-hand side: pinned columns times pin_uvs, negated (size) */
+} LSCMLinearSystem;
+
+/**
+ * @brief Assemble the pinned LSCM system lscm_parameterize_ex would solve
+ *
+ * Same vertex numbering, pins and assembly as the solver, for tests and
+ * tools that inspect the matrix.
+ *
+ * @param mesh Input mesh
+ * @param face_indices Indices of faces in this island
+ * @param num_faces Number of faces in island
+ * @param normal_equations Non-zero: SPD normal equations (LDLT, CG); zero:
+ *                         the square system SparseLU solves
+ * @param options Uses halfedge, face_island_ids, num_threads and
+ *                corner_angles (may be NULL)
+ * @return Newly allocated system, or NULL for an island under 3 vertices
+ *         or whose boundary collapses to one point
+ * @note Caller must free with free_lscm_system()
+ */
+LSCMLinearSystem* lscm_assemble_system(const Mesh* mesh,
+                                       const int* face_indices,
+                                       int num_faces,
+                                       int normal_equations,
+                                       const LSCMOptions* options);
+
+/**
+ * @brief Free a system returned by lscm_assemble_system
+ */
+void free_lscm_system(LSCMLinearSystem* system);
+
+/**
+ * @brief Factorization cache counters and size
+ */
+typedef struct {
+    long long misses;            /**< Full factorizations (new or changed connectivity) */
+    long long symbolic_hits;     /**< Symbolic analysis reused, numeric factorization redone */
+    long long numeric_hits;      /**< Numeric factorization reused (unchanged geometry) */
+    long long evictions;         /**< Entries dropped to stay within the budget */
+    long long bytes;             /**< Estimated memory held by cached factors */
+    long long budget_bytes;      /**< Current budget (0 = disabled) */
+    int entries;                 /**< Cached factorizations */
+} LSCMCacheStats;
+
+/**
+ * @brief Set the memory budget of the LSCM factorization cache
+ *
+ * The LDLT and SparseLU paths keep their factorizations keyed by island
+ * connectivity (face indices, their corners and the pins), so re-unwrapping
+ * an unchanged island skips the symbolic analysis, and also the numeric
+ * factorization if its geometry is unchanged. Least-recently-used entries
+ * are evicted beyond the budget. Default 0: the cache is off, so one-shot
+ * unwraps hold no factors afterwards; interactive callers that re-unwrap
+ * the same mesh opt in with a budget (e.g. 256 MB).
+ *
+ * @param budget_bytes Budget in bytes (0 = disable and free all entries)
+ */
+void lscm_cache_set_budget(long long budget_bytes);
+
+/**
+ * @brief Free all cached factorizations and reset the counters
+ */
+void lscm_cache_clear(void);
+
+/**
+ * @brief Read the factorization cache counters
+ * @param stats_out Output counters
+ */
+void lscm_cache_get_stats(LSCMCacheStats* stats_out);
+
 /**
  * @brief Helper: Find boundary vertices in an island
+ *
+ * Vertices come in boundary-loop order (see find_boundary_loops), each
+ * listed once.
+ *
  * @param mesh Input mesh
  * @param face_indices Faces in island
  * @param num_faces Number of faces
- * @param boundary_out Output array of boundary vertex indices
+ * @param boundary_out Output array of boundary vertex indices (NULL if none)
  * @return Number of boundary vertices
  */
 int find_boundary_vertices(const Mesh* mesh,
@@ -57,6 +271,28 @@ int find_boundary_vertices(const Mesh* mesh,
                           int num_faces,
                           int** boundary_out);
 
+/**
+ * @brief Helper: Boundary of an island as ordered vertex loops
+ *
+ * Each loop follows the island's boundary sides in face orientation, so
+ * consecutive vertices (and the last and first) share a boundary edge. A
+ * vertex where loops touch is visited once per loop passing through it.
+ *
+ * @param mesh Input mesh
+ * @param face_indices Faces in island
+ * @param num_faces Number of faces
+ * @param vertices_out Output loop vertices, loop after loop (NULL if none)
+ * @param loop_offsets_out Output loop starts (num_loops + 1); loop l is
+ *                         vertices[offsets[l] .. offsets[l+1]) (NULL if none)
+ * @return Number of loops (0 for a closed island)
+ * @note Caller must free() both arrays
+ */
+int find_boundary_loops(const Mesh* mesh,
+                        const int* face_indices,
+                        int num_faces,
+                        int** vertices_out,
+                        int** loop_offsets_out);
+
 /**
  * @brief Helper: Normalize UVs to unit square [0,1]²
  * @param uvs UV array to normalize (modified in-place)
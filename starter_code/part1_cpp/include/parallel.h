@@ -0,0 +1,185 @@
+/**
+ * @file parallel.h
+ * @brief Small threading helpers shared by the engine (C++ only)
+ *
+ * INTERNAL - not part of the C API. Used by the .cpp stages to split
+ * loops over faces/edges across std::thread workers, and to run
+ * independent per-island jobs on a small work-stealing pool.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#ifdef __cplusplus
+
+#include <stddef.h>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Resolve a requested thread count
+ * @param requested 0 = one per hardware thread, otherwise the exact count
+ * @return Thread count >= 1
+ */
+inline int resolve_thread_count(int requested) {
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? (int)hw : 1;
+}
+
+/**
+ * @brief Cap a thread count so each thread gets at least min_items_per_thread
+ */
+inline int limit_thread_count(int num_threads, size_t num_items, size_t min_items_per_thread) {
+    if (min_items_per_thread == 0) min_items_per_thread = 1;
+    size_t useful = num_items / min_items_per_thread;
+    if (useful < 1) useful = 1;
+    if ((size_t)num_threads > useful) num_threads = (int)useful;
+    return num_threads < 1 ? 1 : num_threads;
+}
+
+/**
+ * @brief Range [begin, end) handled by chunk t of num_chunks over n items
+ *
+ * Chunks are contiguous and in order, so concatenating per-chunk output
+ * gives the same sequence as a serial loop.
+ */
+inline void chunk_range(size_t n, int t, int num_chunks, size_t* begin, size_t* end) {
+    *begin = n * (size_t)t / (size_t)num_chunks;
+    *end = n * (size_t)(t + 1) / (size_t)num_chunks;
+}
+
+/**
+ * @brief Run fn(t, begin, end) for each of num_threads contiguous chunks of [0, n)
+ *
+ * Chunk 0 runs on the calling thread. With num_threads <= 1 this is a plain
+ * function call, so serial callers pay nothing.
+ */
+template <typename Fn>
+void parallel_for_chunks(int num_threads, size_t n, Fn fn) {
+    if (num_threads <= 1) {
+        fn(0, (size_t)0, n);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; ++t) {
+        size_t b, e;
+        chunk_range(n, t, num_threads, &b, &e);
+        workers.emplace_back([&fn, t, b, e]() { fn(t, b, e); });
+    }
+
+    size_t b0, e0;
+    chunk_range(n, 0, num_threads, &b0, &e0);
+    fn(0, b0, e0);
+
+    for (std::thread& w : workers) w.join();
+}
+
+/**
+ * @brief Sort with num_threads chunk sorts followed by pairwise merge rounds
+ *
+ * With a strict total order (ties broken by a unique key) the result is the
+ * same for every thread count.
+ */
+template <typename T, typename Less>
+void parallel_sort(std::vector<T>& data, int num_threads, Less less) {
+    const size_t n = data.size();
+    if (num_threads <= 1 || n < 2) {
+        std::sort(data.begin(), data.end(), less);
+        return;
+    }
+
+    std::vector<size_t> bounds(num_threads + 1);
+    for (int t = 0; t <= num_threads; ++t) bounds[t] = n * (size_t)t / (size_t)num_threads;
+
+    parallel_for_chunks(num_threads, (size_t)num_threads, [&](int, size_t b, size_t e) {
+        for (size_t t = b; t < e; ++t) {
+            std::sort(data.begin() + bounds[t], data.begin() + bounds[t + 1], less);
+        }
+    });
+
+    // Merge neighbouring runs until one remains; each round halves the run count
+    for (size_t width = 1; width < (size_t)num_threads; width *= 2) {
+        size_t pairs = ((size_t)num_threads + 2 * width - 1) / (2 * width);
+        parallel_for_chunks((int)std::min(pairs, (size_t)num_threads), pairs,
+                            [&](int, size_t b, size_t e) {
+            for (size_t p = b; p < e; ++p) {
+                size_t lo = p * 2 * width;
+                size_t mid = std::min(lo + width, (size_t)num_threads);
+                size_t hi = std::min(lo + 2 * width, (size_t)num_threads);
+                if (mid >= hi) continue;
+                std::inplace_merge(data.begin() + bounds[lo], data.begin() + bounds[mid],
+                                   data.begin() + bounds[hi], less);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Run fn(worker, task) for every task in `order` on a work-stealing pool
+ *
+ * Tasks are dealt round-robin in the given order, so each worker's queue
+ * starts with its share of the first (most expensive, if the caller sorts
+ * by cost) tasks. A worker pops from the front of its own queue; when that
+ * is empty it steals from the back of another's, so a few large tasks at
+ * the front cannot leave the rest of the pool idle at the end.
+ *
+ * fn must be safe to call concurrently for different tasks. Which worker
+ * runs a task is not deterministic; results must not depend on it.
+ */
+template <typename Fn>
+void parallel_for_work_stealing(int num_threads, const std::vector<int>& order, Fn fn) {
+    const size_t n = order.size();
+    if (num_threads > (int)n) num_threads = (int)n;
+    if (num_threads <= 1) {
+        for (int task : order) fn(0, task);
+        return;
+    }
+
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<int> tasks;
+    };
+    std::vector<WorkQueue> queues(num_threads);
+    for (size_t i = 0; i < n; ++i) queues[i % num_threads].tasks.push_back(order[i]);
+
+    auto worker = [&](int self) {
+        for (;;) {
+            int task = -1;
+            {
+                std::lock_guard<std::mutex> guard(queues[self].lock);
+                if (!queues[self].tasks.empty()) {
+                    task = queues[self].tasks.front();
+                    queues[self].tasks.pop_front();
+                }
+            }
+            // Own queue empty: steal from the back of the next non-empty one
+            for (int k = 1; task < 0 && k < num_threads; ++k) {
+                WorkQueue& victim = queues[(self + k) % num_threads];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.tasks.empty()) {
+                    task = victim.tasks.back();
+                    victim.tasks.pop_back();
+                }
+            }
+            // Tasks are never added after start, so an empty sweep means done
+            if (task < 0) return;
+            fn(self, task);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; ++t) workers.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& w : workers) w.join();
+}
+
+#endif /* __cplusplus */
+
+#endif /* PARALLEL_H */
@@ -9,17 +9,62 @@
 #define TOPOLOGY_H
 
 #include "mesh.h"
+#include "face_geometry.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Index-based half-edge mesh (structure of arrays)
+ *
+ * Half-edge h is side (h % 3) of face (h / 3), running from corner k to
+ * corner k+1, so there are exactly 3 * num_faces half-edges. Built once by
+ * build_topology and shared by the seam BFS and the LSCM / ABF++ boundary
+ * detection, so adjacency queries are O(1) per half-edge and O(valence)
+ * per vertex.
+ */
+typedef struct {
+    int num_halfedges;     /**< 3 * num_faces */
+    int num_faces;         /**< Number of faces */
+    int num_vertices;      /**< Number of vertices */
+
+    int* he_vertex;        /**< Origin vertex of each half-edge */
+    int* he_next;          /**< Next half-edge in the same face */
+    int* he_twin;          /**< Opposite half-edge in the neighbour face, -1 on boundary */
+    int* he_face;          /**< Face of each half-edge */
+    int* he_edge;          /**< Edge index in TopologyInfo, -1 for degenerate sides */
+
+    int* vert_halfedge;    /**< One outgoing half-edge per vertex (a boundary one when
+                                the vertex is on the boundary), -1 if unreferenced */
+} HalfEdgeMesh;
+
+/**
+ * @brief CSR vertex incidence tables
+ *
+ * The faces of vertex v are vf_faces[vf_offsets[v] .. vf_offsets[v+1]),
+ * the edges of v are ve_edges[ve_offsets[v] .. ve_offsets[v+1]),
+ * both in ascending index order.
+ */
+typedef struct {
+    int num_vertices;      /**< Number of vertices */
+
+    int* vf_offsets;       /**< Vertex→face offsets (num_vertices + 1) */
+    int* vf_faces;         /**< Incident faces, each face listed once per distinct corner */
+
+    int* ve_offsets;       /**< Vertex→edge offsets (num_vertices + 1) */
+    int* ve_edges;         /**< Incident edges */
+} VertexAdjacency;
+
 /**
  * @brief Topology information for a mesh
  *
  * Stores:
  * - All unique edges in the mesh
  * - For each edge, the 1 or 2 adjacent faces
+ * - For each triangle side, its edge index
+ * - The half-edge view of the same connectivity
+ * - Cached face normals/areas and per-edge sharpness
  */
 typedef struct {
     int* edges;            /**< Edge vertex pairs [v0,v1, v0,v1, ...] (2 * num_edges) */
@@ -27,6 +72,15 @@ typedef struct {
 
     int* edge_faces;       /**< Adjacent faces [f0,f1, f0,f1, ...] (2 * num_edges)
                                  f1 = -1 for boundary edges */
+
+    int* face_edges;       /**< Edge per triangle side [e01,e12,e20, ...] (3 * num_triangles)
+                                 -1 for degenerate sides and invalid triangles */
+
+    HalfEdgeMesh* halfedge; /**< Half-edge adjacency built from the arrays above */
+
+    FaceGeometry* face_geometry; /**< Unit normal and area per face */
+    float* edge_sharpness; /**< 1 - cos(dihedral) per edge, parallel to edge_faces
+                                 (num_edges); 1 for boundary edges */
 } TopologyInfo;
 
 /**
@@ -46,12 +100,84 @@ typedef struct {
  */
 TopologyInfo* build_topology(const Mesh* mesh);
 
+/**
+ * @brief Options for build_topology_ex
+ */
+typedef struct {
+    int ordered_edges;     /**< 1: edges sorted by (v0,v1), identical to the original
+                                std::map builder (radix sort of packed 64-bit keys).
+                                0: first-seen order (open-addressing hash table) */
+    int num_threads;       /**< Threads for the sorted builder (0 = all hardware threads,
+                                1 = serial). Output is identical for any count */
+} TopologyOptions;
+
+/**
+ * @brief Timing report filled by build_topology_ex
+ */
+typedef struct {
+    double build_seconds;      /**< Wall time spent building the edge table */
+    double edges_per_second;   /**< Unique edges produced per second */
+} TopologyStats;
+
+/**
+ * @brief Build topology with explicit options
+ *
+ * Both builders produce the same edges and edge_faces content; only the
+ * order of the edges differs. face0 is always the lower face index and
+ * face1 the second face seen, so seam results are reproducible.
+ *
+ * @param mesh Input mesh
+ * @param options Builder options (NULL = ordered edges)
+ * @param stats_out Optional timing report (may be NULL)
+ * @return Newly allocated topology info, or NULL on error
+ */
+TopologyInfo* build_topology_ex(const Mesh* mesh,
+                                const TopologyOptions* options,
+                                TopologyStats* stats_out);
+
 /**
  * @brief Free topology memory
  * @param topo Topology to free
  */
 void free_topology(TopologyInfo* topo);
 
+/**
+ * @brief Build the half-edge view of a topology
+ *
+ * Twins pair the two sides recorded in edge_faces; sides of a third face on
+ * a non-manifold edge are left as boundary (twin = -1).
+ *
+ * @param mesh Original mesh
+ * @param topo Topology with face_edges filled
+ * @return Newly allocated half-edge mesh, or NULL on error
+ * @note Caller must free with free_halfedge_mesh() (free_topology frees topo->halfedge)
+ */
+HalfEdgeMesh* build_halfedge_mesh(const Mesh* mesh, const TopologyInfo* topo);
+
+/**
+ * @brief Free half-edge mesh memory
+ * @param he Half-edge mesh to free (may be NULL)
+ */
+void free_halfedge_mesh(HalfEdgeMesh* he);
+
+/**
+ * @brief Build CSR vertex→face and vertex→edge tables
+ *
+ * One counting pass and one fill pass over faces and edges (linear time).
+ *
+ * @param mesh Original mesh
+ * @param topo Topology of the mesh
+ * @return Newly allocated tables, or NULL on error
+ * @note Caller must free with free_vertex_adjacency()
+ */
+VertexAdjacency* build_vertex_adjacency(const Mesh* mesh, const TopologyInfo* topo);
+
+/**
+ * @brief Free vertex adjacency memory
+ * @param adj Tables to free (may be NULL)
+ */
+void free_vertex_adjacency(VertexAdjacency* adj);
+
 /**
  * @brief Validate topology using Euler characteristic
  * @param mesh Original mesh
@@ -15,25 +15,103 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Spanning-tree strategy used by seam detection
+ */
+typedef enum {
+    SEAM_METHOD_SORTED_BFS = 0,  /**< BFS visiting flattest neighbours first (default) */
+    SEAM_METHOD_MST = 1          /**< Minimum spanning tree on edge sharpness (Kruskal) */
+} SeamMethod;
+
+/**
+ * @brief Island parameterization backend
+ */
+typedef enum {
+    PARAM_METHOD_LSCM = 0,       /**< Least squares conformal maps (default) */
+    PARAM_METHOD_ABF = 1         /**< ABF++, lower angle distortion; LSCM when it does not converge */
+} ParamMethod;
+
+/**
+ * @brief Island packing algorithm
+ */
+typedef enum {
+    PACK_METHOD_MAXRECTS = 0,    /**< MaxRects, best short side fit (default) */
+    PACK_METHOD_SKYLINE = 1,     /**< Skyline, bottom-left */
+    PACK_METHOD_SHELF = 2,       /**< Shelves of height-sorted islands in a sqrt(area) wide strip */
+    PACK_METHOD_RASTER = 3       /**< Bottom-left fill on rasterised island silhouettes; islands
+                                      may nest inside each other's concave parts and holes */
+} PackMethod;
+
 /**
  * @brief Unwrapping parameters
+ *
+ * Fields after island_margin were added later; zero-initialise the struct
+ * (memset or = {0}) to get the default behaviour for them.
  */
 typedef struct {
     float angle_threshold;       /**< Seam detection angle threshold (degrees) */
     int min_island_faces;        /**< Minimum island size (merge smaller islands) */
     int pack_islands;            /**< If true, pack islands into [0,1]² */
     float island_margin;         /**< Spacing between islands (e.g., 0.02) */
+    int seam_method;             /**< SeamMethod (0 = sorted BFS) */
+    int num_threads;             /**< Worker threads for parallel stages (0 = all hardware threads) */
+    int lscm_solver;             /**< LSCMSolver for island parameterization (0 = LDLT) */
+    float cg_tolerance;          /**< LSCM_SOLVER_CG relative residual target (0 = 1e-6) */
+    int cg_max_iterations;       /**< LSCM_SOLVER_CG iteration cap (0 = solver default) */
+    int cg_preconditioner;       /**< LSCMPreconditioner for LSCM_SOLVER_CG (0 = Jacobi) */
+    int warm_start;              /**< If true and the input mesh has UVs, start CG from them */
+    int lscm_precision;          /**< LSCMPrecision of direct LSCM solves (0 = double) */
+    int param_method;            /**< ParamMethod (0 = LSCM) */
+    float abf_time_budget;       /**< PARAM_METHOD_ABF: Newton time budget per island in seconds
+                                      (0 = none) */
+    int pack_method;             /**< PackMethod (0 = MaxRects) */
+    int pack_no_rotation;        /**< If true, islands keep their orientation when packed */
+    int pack_resolution;         /**< PACK_METHOD_RASTER: finest atlas side in pixels (0 = 1024) */
+    float pack_time_budget;      /**< PACK_METHOD_RASTER: seconds for the coarse-to-fine levels
+                                      (0 = run all levels) */
+    int pack_no_orient;          /**< If true, islands are packed as parameterized, without first
+                                      turning them to their minimum-area bounding rectangle */
+    float udim_texel_density;    /**< If > 0, pack into as many UDIM tiles as needed at this many
+                                      texels per mesh unit instead of into [0,1]² */
+    int udim_tile_resolution;    /**< UDIM mode: texels per tile side (0 = 1024) */
+    int pack_no_equalize;        /**< If true, islands are packed at the scale parameterization
+                                      left them (each normalized on its own) instead of at one
+                                      common texel density */
+    int lscm_multigrid_above;    /**< LSCM_SOLVER_LDLT: islands above this many vertices use
+                                      LSCM_SOLVER_MULTIGRID, bounding memory (0 = never) */
+    float refine_tolerance;      /**< LSCM_PRECISION_MIXED: relative residual the refinement must
+                                      reach before falling back to double (0 = 1e-10) */
 } UnwrapParams;
 
 /**
  * @brief Unwrapping result metadata
+ *
+ * Island i owns faces island_faces[island_face_offsets[i] ..
+ * island_face_offsets[i+1]), in ascending order. Results built by hand may
+ * leave both NULL; packing and metrics then fall back to face_island_ids.
  */
 typedef struct {
     int num_islands;             /**< Number of UV islands */
     int* face_island_ids;        /**< Island ID per face (num_triangles) */
     float avg_stretch;           /**< Average stretch across all triangles */
     float max_stretch;           /**< Maximum stretch */
-    float coverage;              /**< Percentage of [0,1]² used */
+    float coverage;              /**< Percentage of [0,1]² used (UDIM mode: of all tiles) */
+    int* island_face_offsets;    /**< Island→faces offsets (num_islands + 1), or NULL */
+    int* island_faces;           /**< Faces grouped by island (num_triangles), or NULL */
+    float bbox_area_saved;       /**< Fraction of the islands' summed bounding-box area removed
+                                      by orient_uv_islands before packing (0 if not run) */
+    int num_tiles;               /**< UDIM tiles used (0 outside UDIM mode) */
+    int* island_tiles;           /**< UDIM mode: tile t of each island (num_islands), -1 for an
+                                      island without faces; t covers [t % 10, t % 10 + 1] x
+                                      [t / 10, t / 10 + 1] and is UDIM 1001 + t. NULL otherwise */
+    float* island_density;       /**< Texel density per island (num_islands): UV length per unit
+                                      of 3D length, sqrt(UV area / 3D area); 0 for an island
+                                      without area. Filled by compute_quality_metrics if not NULL */
+    float density_spread;        /**< Largest over smallest island_density (1 = uniform, 0 if no
+                                      island has area) */
+    int* vertex_island_ids;      /**< Island whose UVs each vertex carries (num_vertices), -1 if
+                                      unused; a seam vertex belongs to one of its islands. May be
+                                      NULL; packing then takes the highest island among its faces */
 } UnwrapResult;
 
 /**
@@ -82,13 +160,96 @@ int* detect_seams(const Mesh* mesh,
                   float angle_threshold,
                   int* num_seams_out);
 
+/**
+ * @brief Options for detect_seams_ex
+ */
+typedef struct {
+    float angle_threshold;       /**< Angle threshold in degrees */
+    int method;                  /**< SeamMethod */
+    int num_threads;             /**< Threads for the MST edge sort (0 = all hardware threads) */
+    const unsigned char* sharp_edges; /**< Optional classify_sharp_edges() output; overrides angle_threshold */
+} SeamOptions;
+
+/**
+ * @brief Detect seams with an explicit spanning-tree strategy
+ *
+ * SEAM_METHOD_MST builds a minimum spanning forest of the dual graph with
+ * the cached edge sharpness as weights; its output does not depend on the
+ * thread count. Steps 3-4 (threshold filter, angular defect refinement) are
+ * shared with the BFS method.
+ *
+ * @param mesh Input mesh
+ * @param topo Topology information
+ * @param options Seam options (NULL = sorted BFS)
+ * @param num_seams_out Output: number of seams detected
+ * @return Array of seam edge indices
+ * @note Caller must free returned array
+ */
+int* detect_seams_ex(const Mesh* mesh,
+                     const TopologyInfo* topo,
+                     const SeamOptions* options,
+                     int* num_seams_out);
+
+/**
+ * @brief Compute angular defect at every vertex in one pass over the faces
+ *
+ * Angular defect = 2π - sum of angles at vertex
+ *
+ * - Flat surface: defect ≈ 0
+ * - Corner (like cube): defect > 0
+ * - Saddle: defect < 0
+ *
+ * Each face loads its corners once, normalises its three edge vectors once
+ * and adds its three corner angles to the running sums. Faces are visited
+ * in ascending order, so every vertex accumulates the same angles in the
+ * same order as a per-vertex scan (compute_vertex_angle_in_triangle).
+ *
+ * @param mesh Input mesh
+ * @param defects_out Output: angular defect in radians per vertex (num_vertices)
+ */
+void compute_angular_defects(const Mesh* mesh, float* defects_out);
+
+/**
+ * @brief Extract UV islands after seam cuts
+ *
+ * Connected components of the face graph without seam edges, computed with
+ * a concurrent union-find over the edge table:
+ * 1. Seam edges go into a bitset over edge indices
+ * 2. Every interior non-seam edge unites its two faces (parallel over edges)
+ * 3. Islands are numbered in order of their lowest face, the same numbering
+ *    a serial BFS from face 0 upwards produces
+ * 4. A counting sort builds the island→faces CSR index (faces ascending)
+ *
+ * The output does not depend on num_threads.
+ *
+ * @param mesh Input mesh
+ * @param topo Topology info
+ * @param seam_edges Array of seam edge indices
+ * @param num_seams Number of seams
+ * @param num_threads Worker threads (0 = all hardware threads)
+ * @param num_islands_out Output: number of islands
+ * @param island_offsets_out Output: island i owns island_faces[offsets[i], offsets[i+1])
+ * @param island_faces_out Output: face indices grouped by island
+ * @return Array of island IDs per face, or NULL on error
+ * @note Caller must free the three returned arrays
+ */
+int* extract_islands(const Mesh* mesh,
+                     const TopologyInfo* topo,
+                     const int* seam_edges,
+                     int num_seams,
+                     int num_threads,
+                     int* num_islands_out,
+                     int** island_offsets_out,
+                     int** island_faces_out);
+
 /**
  * @brief Pack UV islands into [0,1]² texture space
  *
  * Algorithm:
  * 1. Compute bounding box for each island
- * 2. Sort islands by height (descending)
- * 3. Pack using shelf algorithm
+ * 2. Sort islands by longest side (descending)
+ * 3. Pack with MaxRects (best short side fit, 90° rotation allowed) into the
+ *    smallest square that fits everything
  * 4. Scale to fit [0,1]²
  *
  * @param mesh Mesh with UVs (modified in-place)
@@ -101,6 +262,95 @@ void pack_uv_islands(Mesh* mesh,
                      const UnwrapResult* result,
                      float margin);
 
+/**
+ * @brief Options for pack_uv_islands_ex
+ */
+typedef struct {
+    float margin;                   /**< Spacing between islands */
+    int method;                     /**< PackMethod (0 = MaxRects) */
+    int no_rotation;                /**< If true, islands are never rotated by 90° */
+    int raster_resolution;          /**< PACK_METHOD_RASTER: finest atlas side in pixels (0 = 1024) */
+    double time_budget_seconds;     /**< PACK_METHOD_RASTER: no finer level is started when it
+                                         would end past this; the coarsest always runs (0 = none) */
+    int num_threads;                /**< Threads for orient_uv_islands, equalize_texel_density,
+                                         the raster packer's candidate rows and UDIM tiles
+                                         (0 = all hardware threads) */
+    float texel_density;            /**< If > 0, UDIM mode: texels per mesh unit (see below) */
+    int tile_resolution;            /**< UDIM mode: texels per tile side (0 = 1024) */
+    int* island_tiles;              /**< UDIM mode, optional output (capacity num_islands): tile
+                                         of each island, as in UnwrapResult */
+    int* num_tiles_out;             /**< UDIM mode, optional output: tiles used */
+} PackOptions;
+
+/**
+ * @brief Pack UV islands with explicit options
+ *
+ * UDIM mode (texel_density > 0) keeps a fixed texel density instead of
+ * scaling everything into [0,1]²:
+ * 1. Scale each island so its 3D area maps to texel_density² texels per
+ *    unit², a tile being tile_resolution² texels; an island too large for
+ *    one tile is shrunk to fit it (with a warning)
+ * 2. Deal the islands (longest side first) into new tiles first-fit by
+ *    area, up to one tile's area each
+ * 3. Pack the tiles in parallel with MaxRects, the margin kept to the tile
+ *    edges as well; islands that do not fit try the earlier tiles in
+ *    order, and the rest go to step 2 again with fresh tiles
+ *
+ * Tiles fill rows of 10 along u. method, raster_resolution and
+ * time_budget_seconds are ignored in this mode. The result does not
+ * depend on the thread count.
+ *
+ * @param mesh Mesh with UVs (modified in-place)
+ * @param result Unwrap result with island IDs
+ * @param options Packing options (NULL = margin 0, MaxRects with rotation,
+ *                all hardware threads)
+ */
+void pack_uv_islands_ex(Mesh* mesh,
+                        const UnwrapResult* result,
+                        const PackOptions* options);
+
+/**
+ * @brief Rotate each island to its minimum-area bounding rectangle
+ *
+ * Algorithm:
+ * 1. Convex hull of the island's UVs (Andrew's monotone chain)
+ * 2. Rotating calipers over the hull edges; the minimum-area enclosing
+ *    rectangle has a side on one of them
+ * 3. If that rectangle is smaller than the bounding box, rotate the island
+ *    by the smallest angle (at most 45°) that puts it on the axes
+ *
+ * Islands are processed in parallel; positions are left to the packer, so
+ * call this before pack_uv_islands_ex. Like packing, it leaves a single
+ * island alone.
+ *
+ * @param mesh Mesh with UVs (modified in-place)
+ * @param result Unwrap result with island IDs
+ * @param options Uses num_threads (may be NULL)
+ * @return Fraction of the islands' summed bounding-box area saved (0..1)
+ */
+float orient_uv_islands(Mesh* mesh,
+                        const UnwrapResult* result,
+                        const PackOptions* options);
+
+/**
+ * @brief Scale each island so its UV area equals its 3D area
+ *
+ * Parameterization normalizes every island to the unit square on its own,
+ * so a small part and a large one end up the same size. Scaling island i
+ * by sqrt(A3D_i / AUV_i) about the origin gives all islands one texel
+ * density; packing then places and scales them together. Areas come from
+ * one pass over each island's faces, split across threads. Like packing,
+ * it leaves a single island alone.
+ *
+ * @param mesh Mesh with UVs (modified in-place)
+ * @param result Unwrap result with island IDs
+ * @param options Uses num_threads (may be NULL)
+ * @return Largest over smallest island density before scaling (>= 1)
+ */
+float equalize_texel_density(Mesh* mesh,
+                             const UnwrapResult* result,
+                             const PackOptions* options);
+
 /**
  * @brief Compute quality metrics for UV mapping
  * @param mesh Mesh with UVs
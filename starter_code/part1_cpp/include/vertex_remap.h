@@ -0,0 +1,46 @@
+/**
+ * @file vertex_remap.h
+ * @brief Stamped global→local vertex remap shared by the solvers (C++ only)
+ *
+ * INTERNAL - not part of the C API. LSCM and ABF++ number each island's
+ * vertices locally; this remap does it without an O(V) clear per island.
+ */
+
+#ifndef VERTEX_REMAP_H
+#define VERTEX_REMAP_H
+
+#ifdef __cplusplus
+
+#include <vector>
+
+/**
+ * @brief Dense global→local vertex remap, one per thread
+ *
+ * Sized to the mesh vertex count and never cleared: an entry is valid only
+ * when its stamp equals the current generation, and begin() starts a new
+ * generation for each island. Lookups are a single array access.
+ */
+struct VertexRemap {
+    struct Slot { int local; unsigned stamp; };
+    std::vector<Slot> slots;
+    unsigned generation = 0;
+
+    void begin(int num_vertices) {
+        if ((int)slots.size() < num_vertices) slots.resize(num_vertices, Slot{-1, 0});
+        if (++generation == 0) {  // wrapped: old stamps could alias
+            for (Slot& s : slots) s.stamp = 0;
+            generation = 1;
+        }
+    }
+    int find(int g) const {
+        return slots[g].stamp == generation ? slots[g].local : -1;
+    }
+    void set(int g, int local) {
+        slots[g].local = local;
+        slots[g].stamp = generation;
+    }
+};
+
+#endif /* __cplusplus */
+
+#endif /* VERTEX_REMAP_H */
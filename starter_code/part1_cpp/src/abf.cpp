@@ -0,0 +1,385 @@
+/**
+ * @file abf.cpp
+ * @brief ABF++ parameterization (Sheffer, Lévy, Mogilnitsky, Bogomyakov 2005)
+ *
+ * Unknowns: one angle α per island corner, with Lagrange multipliers for
+ * - Tri:  α0 + α1 + α2 = π per triangle
+ * - Plan: Σ α = 2π around each interior vertex
+ * - Len:  Σ log sin α_next - Σ log sin α_prev = 0 around each interior
+ *         vertex (the sine rule closes the fan; the log form of the
+ *         paper's product constraint has the same roots and better scaling)
+ *
+ * Energy Σ w (α - β)², w = 1/β², with β the 3D angles (interior fans
+ * scaled to 2π). Each Newton step uses the diagonal Hessian Λ = 2w of the
+ * energy, as in the paper, so the KKT system
+ *
+ *   [Λ   J1ᵀ  J2ᵀ] [dα ]   [bα]
+ *   [J1  0    0  ] [dλ1] = [b1]
+ *   [J2  0    0  ] [dλ2]   [b2]
+ *
+ * reduces in two steps that only invert diagonals: Λ (per corner), then
+ * J1 Λ⁻¹ J1ᵀ (per triangle, since Tri rows touch disjoint corners). What is
+ * left is one sparse SPD system over the Plan/Len multipliers, assembled
+ * per triangle from 6x3 blocks of J2 and factored with LDLT.
+ */
+
+#include "abf.h"
+#include "lscm.h"
+#include "vertex_remap.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/OrderingMethods>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+#define ABF_DEFAULT_MAX_ITERATIONS 20
+#define ABF_DEFAULT_TOLERANCE 1e-6
+
+// Target angles are clamped away from 0 and π so the weights 1/β² and the
+// cotangents of the Len constraint stay finite
+static const double ABF_MIN_ANGLE = 3.0 * M_PI / 180.0;
+static const double ABF_MAX_ANGLE = 175.0 * M_PI / 180.0;
+// Newton iterates are kept strictly inside (0, π)
+static const double ABF_ANGLE_EPSILON = 1e-4;
+
+// Per-thread island numbering, kept apart from LSCM's so an LSCM solve
+// never starts a new generation under it
+static thread_local VertexRemap tls_abf_vertex_remap;
+
+static double seconds_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Angle between p1 - p0 and p2 - p0, in double
+ */
+static double corner_angle(const float* p0, const float* p1, const float* p2) {
+    double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    double c[3] = {e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0]};
+    double s = sqrt(c[0]*c[0] + c[1]*c[1] + c[2]*c[2]);
+    double d = e1[0]*e2[0] + e1[1]*e2[1] + e1[2]*e2[2];
+    if (s == 0.0 && d == 0.0) return M_PI / 3.0;   // zero-length side
+    return atan2(s, d);
+}
+
+/**
+ * @brief Angle system of one island
+ *
+ * Corner 3i + k is corner k of island face i. interior[v] is the Plan/Len
+ * row of local vertex v (Plan row p, Len row num_interior + p), or -1 on
+ * the boundary.
+ */
+struct ABFSystem {
+    int num_faces = 0;
+    int num_interior = 0;
+    std::vector<int> corner_vertex;   // local vertex per corner
+    std::vector<int> interior;        // per local vertex
+    std::vector<double> beta, weight, alpha;
+    std::vector<double> lambda_tri, lambda_plan_len;
+
+    // Rows of J2 touched by face i: Plan of each corner's vertex and Len of
+    // each corner's vertex (-1 if on the boundary); coefficients per corner
+    void face_rows(int i, const std::vector<double>& cot, int rows[6], double coeff[6][3]) const {
+        for (int k = 0; k < 3; k++) {
+            int p = interior[corner_vertex[3*i + k]];
+            rows[k] = p;
+            rows[3 + k] = p < 0 ? -1 : num_interior + p;
+            // Plan(v_k): 1 on corner k
+            coeff[k][0] = coeff[k][1] = coeff[k][2] = 0.0;
+            coeff[k][k] = 1.0;
+            // Len(v_k): corner k+1 is the next angle of the fan, k+2 the previous
+            coeff[3 + k][k] = 0.0;
+            coeff[3 + k][(k + 1) % 3] = cot[3*i + (k + 1) % 3];
+            coeff[3 + k][(k + 2) % 3] = -cot[3*i + (k + 2) % 3];
+        }
+    }
+};
+
+/**
+ * @brief Gradient of the Lagrangian: ∂L/∂α per corner, then the Tri and
+ *        Plan/Len constraint values
+ * @return Largest absolute entry
+ */
+static double abf_gradient(const ABFSystem& sys, const std::vector<double>& cot,
+                           std::vector<double>& g_alpha, std::vector<double>& g_tri,
+                           std::vector<double>& g_plan_len) {
+    const int F = sys.num_faces;
+    const int I = sys.num_interior;
+    g_tri.assign(F, -M_PI);
+    g_plan_len.assign(2 * (size_t)I, 0.0);
+    for (int p = 0; p < I; p++) g_plan_len[p] = -2.0 * M_PI;
+
+    for (int i = 0; i < F; i++) {
+        int rows[6];
+        double coeff[6][3];
+        sys.face_rows(i, cot, rows, coeff);
+        for (int k = 0; k < 3; k++) {
+            const int c = 3*i + k;
+            double a = sys.alpha[c];
+            double g = 2.0 * sys.weight[c] * (a - sys.beta[c]) + sys.lambda_tri[i];
+            for (int r = 0; r < 6; r++) {
+                if (rows[r] >= 0) g += coeff[r][k] * sys.lambda_plan_len[rows[r]];
+            }
+            g_alpha[c] = g;
+            g_tri[i] += a;
+
+            int p = sys.interior[sys.corner_vertex[c]];
+            if (p >= 0) g_plan_len[p] += a;
+            // Len of the vertex before corner k (k is its next angle) and after it
+            double log_sin = log(sin(a));
+            int prev = sys.interior[sys.corner_vertex[3*i + (k + 2) % 3]];
+            int next = sys.interior[sys.corner_vertex[3*i + (k + 1) % 3]];
+            if (prev >= 0) g_plan_len[I + prev] += log_sin;
+            if (next >= 0) g_plan_len[I + next] -= log_sin;
+        }
+    }
+
+    double norm = 0.0;
+    for (double g : g_alpha) norm = std::max(norm, fabs(g));
+    for (double g : g_tri) norm = std::max(norm, fabs(g));
+    for (double g : g_plan_len) norm = std::max(norm, fabs(g));
+    return norm;
+}
+
+/**
+ * @brief Newton iterations on the angles
+ * @return true when the gradient fell below the tolerance
+ */
+static bool abf_solve(ABFSystem& sys, int max_iterations, double tolerance,
+                      double time_budget, ABFStats& stats) {
+    const int F = sys.num_faces;
+    const int I = sys.num_interior;
+    const double start = seconds_now();
+
+    std::vector<double> cot(3 * (size_t)F), D(3 * (size_t)F);
+    std::vector<double> g_alpha(3 * (size_t)F), g_tri, g_plan_len;
+    std::vector<double> c1(F), delta(F);
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(21 * (size_t)F);
+
+    Eigen::SparseMatrix<double> M(2 * I, 2 * I);
+    Eigen::VectorXd rhs(2 * I);
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::AMDOrdering<int>> ldlt;
+    bool analyzed = false;
+    double last_step = 0.0;
+
+    for (int c = 0; c < 3 * F; c++) D[c] = 1.0 / (2.0 * sys.weight[c]);
+
+    for (;;) {
+        for (int c = 0; c < 3 * F; c++) cot[c] = 1.0 / tan(sys.alpha[c]);
+        stats.gradient_norm = abf_gradient(sys, cot, g_alpha, g_tri, g_plan_len);
+        if (stats.gradient_norm < tolerance) return true;
+        if (stats.iterations >= max_iterations) return false;
+        double elapsed = seconds_now() - start;
+        if (time_budget > 0.0 && elapsed + last_step > time_budget) {
+            printf("  ABF++ time budget %g s reached after %d iterations\n", time_budget, stats.iterations);
+            return false;
+        }
+        double t0 = seconds_now();
+
+        // Reduced system M dλ2 = rhs over the Plan/Len multipliers, where per
+        // face G = D - D 1 1ᵀ D / Δ (Δ = Σ D) and M = Σ J2 G J2ᵀ
+        triplets.clear();
+        for (int p = 0; p < 2 * I; p++) rhs[p] = g_plan_len[p];   // + C2
+        for (int i = 0; i < F; i++) {
+            int rows[6];
+            double coeff[6][3];
+            sys.face_rows(i, cot, rows, coeff);
+            const double* d = &D[3*i];
+            double b[3] = {-g_alpha[3*i], -g_alpha[3*i + 1], -g_alpha[3*i + 2]};
+
+            delta[i] = d[0] + d[1] + d[2];
+            c1[i] = d[0]*b[0] + d[1]*b[1] + d[2]*b[2] + g_tri[i];   // J1 D bα - b1, b1 = -C1
+
+            double G[3][3];
+            for (int j = 0; j < 3; j++) {
+                for (int k = 0; k < 3; k++) G[j][k] = (j == k ? d[j] : 0.0) - d[j] * d[k] / delta[i];
+            }
+            for (int r = 0; r < 6; r++) {
+                if (rows[r] < 0) continue;
+                const double* a = coeff[r];
+                // J2 D bα - J2 D 1 (c1 / Δ)
+                rhs[rows[r]] += a[0]*d[0]*(b[0] - c1[i] / delta[i]) +
+                                a[1]*d[1]*(b[1] - c1[i] / delta[i]) +
+                                a[2]*d[2]*(b[2] - c1[i] / delta[i]);
+                double aG[3];
+                for (int k = 0; k < 3; k++) aG[k] = a[0]*G[0][k] + a[1]*G[1][k] + a[2]*G[2][k];
+                for (int s = 0; s < 6; s++) {
+                    if (rows[s] < rows[r]) continue;   // lower triangle: row >= column
+                    const double* e = coeff[s];
+                    triplets.emplace_back(rows[s], rows[r], aG[0]*e[0] + aG[1]*e[1] + aG[2]*e[2]);
+                }
+            }
+        }
+        Eigen::VectorXd dlambda2 = Eigen::VectorXd::Zero(2 * I);
+        if (I > 0) {   // without interior vertices only the Tri constraints remain
+            M.setFromTriplets(triplets.begin(), triplets.end());
+
+            // The pattern only depends on connectivity: analyse it once
+            if (!analyzed) {
+                ldlt.analyzePattern(M);
+                analyzed = true;
+            }
+            ldlt.factorize(M);
+            if (ldlt.info() != Eigen::Success) {
+                fprintf(stderr, "ABF++: factorization failed\n");
+                return false;
+            }
+            dlambda2 = ldlt.solve(rhs);
+            if (ldlt.info() != Eigen::Success || !dlambda2.allFinite()) {
+                fprintf(stderr, "ABF++: solve failed\n");
+                return false;
+            }
+        }
+
+        // Back-substitute: dλ1 per face, then dα per corner
+        for (int i = 0; i < F; i++) {
+            int rows[6];
+            double coeff[6][3];
+            sys.face_rows(i, cot, rows, coeff);
+            double jt[3] = {0.0, 0.0, 0.0};   // (J2ᵀ dλ2) per corner
+            for (int r = 0; r < 6; r++) {
+                if (rows[r] < 0) continue;
+                for (int k = 0; k < 3; k++) jt[k] += coeff[r][k] * dlambda2[rows[r]];
+            }
+            const double* d = &D[3*i];
+            double dlambda1 = (c1[i] - (d[0]*jt[0] + d[1]*jt[1] + d[2]*jt[2])) / delta[i];
+            sys.lambda_tri[i] += dlambda1;
+            for (int k = 0; k < 3; k++) {
+                int c = 3*i + k;
+                double a = sys.alpha[c] + d[k] * (-g_alpha[c] - dlambda1 - jt[k]);
+                sys.alpha[c] = std::min(std::max(a, ABF_ANGLE_EPSILON), M_PI - ABF_ANGLE_EPSILON);
+            }
+        }
+        for (int p = 0; p < 2 * I; p++) sys.lambda_plan_len[p] += dlambda2[p];
+
+        stats.iterations++;
+        last_step = seconds_now() - t0;
+    }
+}
+
+float* abf_parameterize(const Mesh* mesh,
+                        const int* face_indices,
+                        int num_faces) {
+    return abf_parameterize_ex(mesh, face_indices, num_faces, NULL);
+}
+
+float* abf_parameterize_ex(const Mesh* mesh,
+                           const int* face_indices,
+                           int num_faces,
+                           const ABFOptions* options) {
+    if (!mesh || !face_indices || num_faces == 0) return NULL;
+
+    printf("ABF++ parameterizing %d faces...\n", num_faces);
+
+    ABFStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.result = ABF_RESULT_LSCM_FALLBACK;
+
+    LSCMOptions lscm_options;
+    memset(&lscm_options, 0, sizeof(lscm_options));
+    if (options && options->lscm) lscm_options = *options->lscm;
+    if (options) {
+        lscm_options.halfedge = options->halfedge;
+        lscm_options.face_island_ids = options->face_island_ids;
+        lscm_options.local_to_global = options->local_to_global;
+        lscm_options.num_local_out = options->num_local_out;
+        lscm_options.num_threads = options->num_threads;
+    }
+
+    // Interior vertices: not on any boundary loop of the island
+    int* loop_vertices = NULL;
+    int* loop_offsets = NULL;
+    int num_loops = find_boundary_loops(mesh, face_indices, num_faces, &loop_vertices, &loop_offsets);
+
+    std::vector<float> angles;
+    double t0 = seconds_now();
+    if (num_loops == 0) {
+        printf("  Closed island: no ABF++ boundary, using LSCM\n");
+    } else {
+        // Local vertices in first-appearance order, as in lscm_parameterize_ex
+        VertexRemap& local = tls_abf_vertex_remap;
+        local.begin(mesh->num_vertices);
+        ABFSystem sys;
+        sys.num_faces = num_faces;
+        sys.corner_vertex.resize(3 * (size_t)num_faces);
+        int n = 0;
+        for (int i = 0; i < num_faces; i++) {
+            for (int k = 0; k < 3; k++) {
+                int g = mesh->triangles[3 * face_indices[i] + k];
+                if (local.find(g) < 0) local.set(g, n++);
+                sys.corner_vertex[3*i + k] = local.find(g);
+            }
+        }
+        sys.interior.assign(n, 0);
+        for (int k = 0; k < loop_offsets[num_loops]; k++) sys.interior[local.find(loop_vertices[k])] = -1;
+        for (int v = 0; v < n; v++) {
+            if (sys.interior[v] == 0) sys.interior[v] = sys.num_interior++;
+        }
+        stats.interior_vertices = sys.num_interior;
+        printf("  %d vertices, %d interior\n", n, sys.num_interior);
+
+        // Target angles: 3D angles, clamped, interior fans scaled to 2π
+        sys.beta.resize(3 * (size_t)num_faces);
+        std::vector<double> fan_sum(n, 0.0);
+        for (int i = 0; i < num_faces; i++) {
+            const int* tri = &mesh->triangles[3 * face_indices[i]];
+            for (int k = 0; k < 3; k++) {
+                double b = corner_angle(&mesh->vertices[3 * tri[k]],
+                                        &mesh->vertices[3 * tri[(k + 1) % 3]],
+                                        &mesh->vertices[3 * tri[(k + 2) % 3]]);
+                b = std::min(std::max(b, ABF_MIN_ANGLE), ABF_MAX_ANGLE);
+                sys.beta[3*i + k] = b;
+                fan_sum[sys.corner_vertex[3*i + k]] += b;
+            }
+        }
+        sys.weight.resize(3 * (size_t)num_faces);
+        for (int c = 0; c < 3 * num_faces; c++) {
+            int v = sys.corner_vertex[c];
+            if (sys.interior[v] >= 0) sys.beta[c] *= 2.0 * M_PI / fan_sum[v];
+            sys.weight[c] = 1.0 / (sys.beta[c] * sys.beta[c]);
+        }
+        sys.alpha = sys.beta;
+        sys.lambda_tri.assign(num_faces, 0.0);
+        sys.lambda_plan_len.assign(2 * (size_t)sys.num_interior, 0.0);
+
+        int max_iterations = (options && options->max_iterations > 0)
+                                 ? options->max_iterations : ABF_DEFAULT_MAX_ITERATIONS;
+        double tolerance = (options && options->tolerance > 0.0)
+                               ? options->tolerance : ABF_DEFAULT_TOLERANCE;
+        double budget = options ? options->time_budget_seconds : 0.0;
+
+        if (abf_solve(sys, max_iterations, tolerance, budget, stats)) {
+            printf("  ABF++ converged in %d iterations (|grad| %.1e)\n",
+                   stats.iterations, stats.gradient_norm);
+            angles.assign(sys.alpha.begin(), sys.alpha.end());
+            stats.result = ABF_RESULT_ABF;
+        } else {
+            printf("  ABF++ not converged after %d iterations (|grad| %.1e), falling back to LSCM\n",
+                   stats.iterations, stats.gradient_norm);
+        }
+    }
+    free(loop_vertices);
+    free(loop_offsets);
+
+    double t1 = seconds_now();
+    stats.solve_seconds = t1 - t0;
+
+    lscm_options.corner_angles = angles.empty() ? NULL : angles.data();
+    float* uvs = lscm_parameterize_ex(mesh, face_indices, num_faces, &lscm_options);
+    stats.layout_seconds = seconds_now() - t1;
+
+    if (options && options->stats) *options->stats = stats;
+    return uvs;
+}
@@ -0,0 +1,372 @@
+/**
+ * @file face_geometry.cpp
+ * @brief Per-face normal/area buffer and per-edge sharpness
+ *
+ * The face pass writes normals and areas once into SoA arrays so that later
+ * stages (seam sharpness, classification) only do dot products.
+ *
+ * Kernels:
+ * - AVX2 (x86-64): 8 faces per iteration, corner indices and positions
+ *   gathered. Built with a per-function target instead of -mavx2, so the
+ *   rest of the library (and the Eigen code it instantiates) stays baseline
+ *   x86-64; chosen at run time when the CPU supports AVX2.
+ * - NEON (AArch64): 4 faces per iteration
+ * - Scalar: remainder faces and blocks touching invalid indices
+ *
+ * The sharp-edge classifier uses the same split: one compare per edge
+ * against the cached sharpness, masked by "has a second face".
+ *
+ * All kernels perform the same IEEE operations in the same order as the
+ * scalar code (cross product, sqrt, divide), so results match bit for bit
+ * as long as the compiler does not contract them into FMAs.
+ */
+
+#include "face_geometry.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(UVUNWRAP_DISABLE_AVX2)
+  #include <immintrin.h>
+  #define FACE_GEOMETRY_AVX2 1
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+    #define FACE_GEOMETRY_AVX2_TARGET
+  #else
+    #define FACE_GEOMETRY_AVX2_TARGET __attribute__((target("avx2")))
+  #endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define FACE_GEOMETRY_NEON 1
+#endif
+
+/**
+ * @brief Reference kernel for faces [begin, end)
+ */
+static void face_geometry_scalar(const Mesh* mesh, int begin, int end, FaceGeometry* g) {
+    const float* v = mesh->vertices;
+    const int* t = mesh->triangles;
+    const int V = mesh->num_vertices;
+
+    for (int f = begin; f < end; ++f) {
+        int i0 = t[3*f], i1 = t[3*f + 1], i2 = t[3*f + 2];
+        if (i0 < 0 || i0 >= V || i1 < 0 || i1 >= V || i2 < 0 || i2 >= V) {
+            g->nx[f] = g->ny[f] = g->nz[f] = 0.0f;
+            g->area[f] = 0.0f;
+            continue;
+        }
+
+        float e1[3] = {v[3*i1] - v[3*i0], v[3*i1 + 1] - v[3*i0 + 1], v[3*i1 + 2] - v[3*i0 + 2]};
+        float e2[3] = {v[3*i2] - v[3*i0], v[3*i2 + 1] - v[3*i0 + 1], v[3*i2 + 2] - v[3*i0 + 2]};
+        float n[3] = {e1[1]*e2[2] - e1[2]*e2[1],
+                      e1[2]*e2[0] - e1[0]*e2[2],
+                      e1[0]*e2[1] - e1[1]*e2[0]};
+
+        float l = sqrtf(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+        if (l > 0) { n[0] /= l; n[1] /= l; n[2] /= l; }
+
+        g->nx[f] = n[0];
+        g->ny[f] = n[1];
+        g->nz[f] = n[2];
+        g->area[f] = 0.5f * l;
+    }
+}
+
+#if defined(FACE_GEOMETRY_AVX2)
+/**
+ * @brief Whether the CPU and OS support AVX2 (checked once)
+ */
+static bool cpu_has_avx2(void) {
+    static const bool has_avx2 = [] {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        // AVX and OSXSAVE, and the OS saves the YMM state
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+        if ((_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }();
+    return has_avx2;
+}
+
+/**
+ * @brief AVX2 kernel: returns the first face it did not process
+ */
+FACE_GEOMETRY_AVX2_TARGET
+static int face_geometry_avx2(const Mesh* mesh, int begin, int end, FaceGeometry* g) {
+    const float* v = mesh->vertices;
+    const int* t = mesh->triangles;
+
+    const __m256i stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    const __m256i num_verts = _mm256_set1_epi32(mesh->num_vertices);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    int f = begin;
+    for (; f + 8 <= end; f += 8) {
+        const int* tb = t + 3*f;
+        __m256i i0 = _mm256_i32gather_epi32(tb, stride, 4);
+        __m256i i1 = _mm256_i32gather_epi32(tb + 1, stride, 4);
+        __m256i i2 = _mm256_i32gather_epi32(tb + 2, stride, 4);
+
+        // Any out-of-range corner: let the scalar kernel zero that face
+        __m256i ok = _mm256_and_si256(
+            _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(i0, minus_one),
+                                              _mm256_cmpgt_epi32(num_verts, i0)),
+                             _mm256_and_si256(_mm256_cmpgt_epi32(i1, minus_one),
+                                              _mm256_cmpgt_epi32(num_verts, i1))),
+            _mm256_and_si256(_mm256_cmpgt_epi32(i2, minus_one),
+                             _mm256_cmpgt_epi32(num_verts, i2)));
+        if (_mm256_movemask_ps(_mm256_castsi256_ps(ok)) != 0xff) {
+            face_geometry_scalar(mesh, f, f + 8, g);
+            continue;
+        }
+
+        __m256i o0 = _mm256_mullo_epi32(i0, three);
+        __m256i o1 = _mm256_mullo_epi32(i1, three);
+        __m256i o2 = _mm256_mullo_epi32(i2, three);
+
+        __m256 p0x = _mm256_i32gather_ps(v, o0, 4);
+        __m256 p0y = _mm256_i32gather_ps(v + 1, o0, 4);
+        __m256 p0z = _mm256_i32gather_ps(v + 2, o0, 4);
+
+        __m256 e1x = _mm256_sub_ps(_mm256_i32gather_ps(v, o1, 4), p0x);
+        __m256 e1y = _mm256_sub_ps(_mm256_i32gather_ps(v + 1, o1, 4), p0y);
+        __m256 e1z = _mm256_sub_ps(_mm256_i32gather_ps(v + 2, o1, 4), p0z);
+        __m256 e2x = _mm256_sub_ps(_mm256_i32gather_ps(v, o2, 4), p0x);
+        __m256 e2y = _mm256_sub_ps(_mm256_i32gather_ps(v + 1, o2, 4), p0y);
+        __m256 e2z = _mm256_sub_ps(_mm256_i32gather_ps(v + 2, o2, 4), p0z);
+
+        __m256 nx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+        __m256 ny = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+        __m256 nz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+
+        __m256 l = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx),
+                                                              _mm256_mul_ps(ny, ny)),
+                                                _mm256_mul_ps(nz, nz)));
+        __m256 positive = _mm256_cmp_ps(l, zero, _CMP_GT_OQ);
+        nx = _mm256_blendv_ps(nx, _mm256_div_ps(nx, l), positive);
+        ny = _mm256_blendv_ps(ny, _mm256_div_ps(ny, l), positive);
+        nz = _mm256_blendv_ps(nz, _mm256_div_ps(nz, l), positive);
+
+        _mm256_storeu_ps(g->nx + f, nx);
+        _mm256_storeu_ps(g->ny + f, ny);
+        _mm256_storeu_ps(g->nz + f, nz);
+        _mm256_storeu_ps(g->area + f, _mm256_mul_ps(half, l));
+    }
+    return f;
+}
+#endif
+
+#if defined(FACE_GEOMETRY_NEON)
+/**
+ * @brief NEON kernel: returns the first face it did not process
+ */
+static int face_geometry_neon(const Mesh* mesh, int begin, int end, FaceGeometry* g) {
+    const float* v = mesh->vertices;
+    const int* t = mesh->triangles;
+    const int V = mesh->num_vertices;
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+
+    int f = begin;
+    for (; f + 4 <= end; f += 4) {
+        float p[3][3][4];  // [corner][axis][lane]
+        bool valid = true;
+        for (int lane = 0; lane < 4 && valid; ++lane) {
+            for (int c = 0; c < 3; ++c) {
+                int idx = t[3*(f + lane) + c];
+                if (idx < 0 || idx >= V) { valid = false; break; }
+                p[c][0][lane] = v[3*idx];
+                p[c][1][lane] = v[3*idx + 1];
+                p[c][2][lane] = v[3*idx + 2];
+            }
+        }
+        if (!valid) {
+            face_geometry_scalar(mesh, f, f + 4, g);
+            continue;
+        }
+
+        float32x4_t p0x = vld1q_f32(p[0][0]), p0y = vld1q_f32(p[0][1]), p0z = vld1q_f32(p[0][2]);
+        float32x4_t e1x = vsubq_f32(vld1q_f32(p[1][0]), p0x);
+        float32x4_t e1y = vsubq_f32(vld1q_f32(p[1][1]), p0y);
+        float32x4_t e1z = vsubq_f32(vld1q_f32(p[1][2]), p0z);
+        float32x4_t e2x = vsubq_f32(vld1q_f32(p[2][0]), p0x);
+        float32x4_t e2y = vsubq_f32(vld1q_f32(p[2][1]), p0y);
+        float32x4_t e2z = vsubq_f32(vld1q_f32(p[2][2]), p0z);
+
+        float32x4_t nx = vsubq_f32(vmulq_f32(e1y, e2z), vmulq_f32(e1z, e2y));
+        float32x4_t ny = vsubq_f32(vmulq_f32(e1z, e2x), vmulq_f32(e1x, e2z));
+        float32x4_t nz = vsubq_f32(vmulq_f32(e1x, e2y), vmulq_f32(e1y, e2x));
+
+        float32x4_t l = vsqrtq_f32(vaddq_f32(vaddq_f32(vmulq_f32(nx, nx), vmulq_f32(ny, ny)),
+                                             vmulq_f32(nz, nz)));
+        uint32x4_t positive = vcgtq_f32(l, zero);
+        nx = vbslq_f32(positive, vdivq_f32(nx, l), nx);
+        ny = vbslq_f32(positive, vdivq_f32(ny, l), ny);
+        nz = vbslq_f32(positive, vdivq_f32(nz, l), nz);
+
+        vst1q_f32(g->nx + f, nx);
+        vst1q_f32(g->ny + f, ny);
+        vst1q_f32(g->nz + f, nz);
+        vst1q_f32(g->area + f, vmulq_f32(half, l));
+    }
+    return f;
+}
+#endif
+
+FaceGeometry* compute_face_geometry(const Mesh* mesh) {
+    if (!mesh) return NULL;
+
+    const int F = mesh->num_triangles;
+    FaceGeometry* g = (FaceGeometry*)calloc(1, sizeof(FaceGeometry));
+    if (!g) return NULL;
+
+    size_t n = (size_t)(F > 0 ? F : 1);
+    g->num_faces = F;
+    g->nx = (float*)malloc(sizeof(float) * n);
+    g->ny = (float*)malloc(sizeof(float) * n);
+    g->nz = (float*)malloc(sizeof(float) * n);
+    g->area = (float*)malloc(sizeof(float) * n);
+    if (!g->nx || !g->ny || !g->nz || !g->area) {
+        printf("Error: malloc failed in compute_face_geometry\n");
+        free_face_geometry(g);
+        return NULL;
+    }
+
+    int done = 0;
+#if defined(FACE_GEOMETRY_AVX2)
+    if (cpu_has_avx2()) done = face_geometry_avx2(mesh, 0, F, g);
+#elif defined(FACE_GEOMETRY_NEON)
+    done = face_geometry_neon(mesh, 0, F, g);
+#endif
+    face_geometry_scalar(mesh, done, F, g);
+
+    return g;
+}
+
+void free_face_geometry(FaceGeometry* geom) {
+    if (!geom) return;
+
+    if (geom->nx) free(geom->nx);
+    if (geom->ny) free(geom->ny);
+    if (geom->nz) free(geom->nz);
+    if (geom->area) free(geom->area);
+    free(geom);
+}
+
+void compute_edge_sharpness(const FaceGeometry* geom,
+                            const int* edge_faces,
+                            int num_edges,
+                            float* sharpness_out) {
+    if (!geom || !edge_faces || !sharpness_out) return;
+
+    const float* nx = geom->nx;
+    const float* ny = geom->ny;
+    const float* nz = geom->nz;
+
+    for (int e = 0; e < num_edges; ++e) {
+        int f0 = edge_faces[2*e];
+        int f1 = edge_faces[2*e + 1];
+        if (f0 < 0 || f1 < 0) {
+            sharpness_out[e] = 1.0f;
+            continue;
+        }
+        sharpness_out[e] = 1.0f - (nx[f0]*nx[f1] + ny[f0]*ny[f1] + nz[f0]*nz[f1]);
+    }
+}
+
+#if defined(FACE_GEOMETRY_AVX2)
+/**
+ * @brief AVX2 classifier: returns the first edge it did not process
+ */
+FACE_GEOMETRY_AVX2_TARGET
+static int classify_sharp_avx2(const float* edge_sharpness,
+                               const int* edge_faces,
+                               int num_edges,
+                               float cutoff,
+                               unsigned char* sharp_out,
+                               int* count) {
+    const __m256 vcut = _mm256_set1_ps(cutoff);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    int e = 0;
+    for (; e + 8 <= num_edges; e += 8) {
+        __m256 sharp = _mm256_cmp_ps(_mm256_loadu_ps(edge_sharpness + e), vcut, _CMP_GT_OQ);
+
+        // Pull f1 of the 8 edges out of the interleaved [f0,f1] pairs
+        __m256 lo = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)(edge_faces + 2*e)));
+        __m256 hi = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)(edge_faces + 2*e + 8)));
+        __m256i f1 = _mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+        f1 = _mm256_castpd_si256(_mm256_permute4x64_pd(_mm256_castsi256_pd(f1),
+                                                       _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 interior = _mm256_castsi256_ps(_mm256_cmpgt_epi32(f1, minus_one));
+
+        int bits = _mm256_movemask_ps(_mm256_and_ps(sharp, interior));
+        for (int k = 0; k < 8; ++k) {
+            int bit = (bits >> k) & 1;
+            sharp_out[e + k] = (unsigned char)bit;
+            *count += bit;
+        }
+    }
+    return e;
+}
+#endif
+
+int classify_sharp_edges(const float* edge_sharpness,
+                         const int* edge_faces,
+                         int num_edges,
+                         float angle_threshold,
+                         unsigned char* sharp_out) {
+    if (!edge_sharpness || !edge_faces || !sharp_out) return 0;
+
+    const float cutoff = 1.0f - cosf(angle_threshold * (float)M_PI / 180.0f);
+    int count = 0;
+    int e = 0;
+
+#if defined(FACE_GEOMETRY_AVX2)
+    if (cpu_has_avx2()) e = classify_sharp_avx2(edge_sharpness, edge_faces, num_edges, cutoff, sharp_out, &count);
+#elif defined(FACE_GEOMETRY_NEON)
+    const float32x4_t vcut = vdupq_n_f32(cutoff);
+    const int32x4_t minus_one = vdupq_n_s32(-1);
+    for (; e + 4 <= num_edges; e += 4) {
+        uint32x4_t sharp = vcgtq_f32(vld1q_f32(edge_sharpness + e), vcut);
+        int32x4x2_t faces = vld2q_s32(edge_faces + 2*e);  // de-interleaves f0 / f1
+        uint32x4_t mask = vandq_u32(sharp, vcgtq_s32(faces.val[1], minus_one));
+        uint32_t lanes[4];
+        vst1q_u32(lanes, mask);
+        for (int k = 0; k < 4; ++k) {
+            sharp_out[e + k] = lanes[k] ? 1 : 0;
+            count += lanes[k] ? 1 : 0;
+        }
+    }
+#endif
+
+    for (; e < num_edges; ++e) {
+        int is_sharp = edge_faces[2*e + 1] >= 0 && edge_sharpness[e] > cutoff;
+        sharp_out[e] = (unsigned char)is_sharp;
+        count += is_sharp;
+    }
+    return count;
+}
+
+const char* face_geometry_kernel_name(void) {
+#if defined(FACE_GEOMETRY_AVX2)
+    return cpu_has_avx2() ? "avx2" : "scalar";
+#elif defined(FACE_GEOMETRY_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,191 @@
+/**
+ * @file halfedge.cpp
+ * @brief Half-edge and CSR adjacency views of the mesh topology
+ *
+ * Half-edge mesh, built once from TopologyInfo::face_edges / edge_faces:
+ * 1. he_vertex / he_next / he_face follow directly from the triangle array
+ * 2. Twins pair the sides of face0 and face1 of every edge
+ * 3. Each vertex keeps one outgoing half-edge, preferring a boundary one
+ *
+ * Vertex adjacency: counting sort of (vertex, face) and (vertex, edge)
+ * incidences into offset + index arrays.
+ */
+
+#include "topology.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+
+HalfEdgeMesh* build_halfedge_mesh(const Mesh* mesh, const TopologyInfo* topo) {
+    if (!mesh || !topo) return NULL;
+    if (!topo->face_edges && mesh->num_triangles > 0 && topo->num_edges > 0) {
+        fprintf(stderr, "build_halfedge_mesh: topology has no face_edges\n");
+        return NULL;
+    }
+
+    const int F = mesh->num_triangles;
+    const int V = mesh->num_vertices;
+    const int H = 3 * F;
+    const int E = topo->num_edges;
+    const int* tris = mesh->triangles;
+
+    HalfEdgeMesh* he = (HalfEdgeMesh*)calloc(1, sizeof(HalfEdgeMesh));
+    if (!he) return NULL;
+
+    he->num_halfedges = H;
+    he->num_faces = F;
+    he->num_vertices = V;
+
+    he->he_vertex = (int*)malloc(sizeof(int) * (H > 0 ? H : 1));
+    he->he_next = (int*)malloc(sizeof(int) * (H > 0 ? H : 1));
+    he->he_twin = (int*)malloc(sizeof(int) * (H > 0 ? H : 1));
+    he->he_face = (int*)malloc(sizeof(int) * (H > 0 ? H : 1));
+    he->he_edge = (int*)malloc(sizeof(int) * (H > 0 ? H : 1));
+    he->vert_halfedge = (int*)malloc(sizeof(int) * (V > 0 ? V : 1));
+
+    if (!he->he_vertex || !he->he_next || !he->he_twin ||
+        !he->he_face || !he->he_edge || !he->vert_halfedge) {
+        printf("Error: malloc failed in build_halfedge_mesh\n");
+        free_halfedge_mesh(he);
+        return NULL;
+    }
+
+    // 1. Per-face connectivity
+    for (int h = 0; h < H; ++h) {
+        int f = h / 3;
+        int k = h % 3;
+        he->he_vertex[h] = tris[h];
+        he->he_next[h] = 3*f + (k + 1) % 3;
+        he->he_face[h] = f;
+        he->he_edge[h] = (topo->face_edges) ? topo->face_edges[h] : -1;
+        he->he_twin[h] = -1;
+    }
+
+    // 2. Twins: the side of face0 and the side of face1 of each edge
+    std::vector<int> edge_he(2 * (size_t)E, -1);
+    const int* edge_faces = topo->edge_faces;
+    for (int h = 0; h < H; ++h) {
+        int e = he->he_edge[h];
+        if (e < 0) continue;
+        int f = h / 3;
+        if (edge_he[2*e] < 0 && edge_faces[2*e] == f) {
+            edge_he[2*e] = h;
+        } else if (edge_he[2*e + 1] < 0 && edge_faces[2*e + 1] == f) {
+            edge_he[2*e + 1] = h;
+        }
+    }
+    for (int e = 0; e < E; ++e) {
+        int h0 = edge_he[2*e];
+        int h1 = edge_he[2*e + 1];
+        if (h0 >= 0 && h1 >= 0) {
+            he->he_twin[h0] = h1;
+            he->he_twin[h1] = h0;
+        }
+    }
+
+    // 3. Outgoing half-edge per vertex; a boundary one starts a full one-ring sweep
+    for (int v = 0; v < V; ++v) he->vert_halfedge[v] = -1;
+    for (int h = 0; h < H; ++h) {
+        if (he->he_edge[h] < 0) continue;
+        int v = he->he_vertex[h];
+        int cur = he->vert_halfedge[v];
+        if (cur < 0 || (he->he_twin[h] < 0 && he->he_twin[cur] >= 0)) {
+            he->vert_halfedge[v] = h;
+        }
+    }
+
+    return he;
+}
+
+void free_halfedge_mesh(HalfEdgeMesh* he) {
+    if (!he) return;
+
+    if (he->he_vertex) free(he->he_vertex);
+    if (he->he_next) free(he->he_next);
+    if (he->he_twin) free(he->he_twin);
+    if (he->he_face) free(he->he_face);
+    if (he->he_edge) free(he->he_edge);
+    if (he->vert_halfedge) free(he->vert_halfedge);
+    free(he);
+}
+
+VertexAdjacency* build_vertex_adjacency(const Mesh* mesh, const TopologyInfo* topo) {
+    if (!mesh || !topo) return NULL;
+
+    const int V = mesh->num_vertices;
+    const int F = mesh->num_triangles;
+    const int E = topo->num_edges;
+    const int* tris = mesh->triangles;
+
+    VertexAdjacency* adj = (VertexAdjacency*)calloc(1, sizeof(VertexAdjacency));
+    if (!adj) return NULL;
+    adj->num_vertices = V;
+
+    adj->vf_offsets = (int*)calloc((size_t)V + 1, sizeof(int));
+    adj->ve_offsets = (int*)calloc((size_t)V + 1, sizeof(int));
+    if (!adj->vf_offsets || !adj->ve_offsets) {
+        printf("Error: malloc failed in build_vertex_adjacency\n");
+        free_vertex_adjacency(adj);
+        return NULL;
+    }
+
+    // Distinct, in-range corners of face f (a degenerate face lists a vertex once)
+    auto face_corners = [&](int f, int* out) {
+        int count = 0;
+        for (int k = 0; k < 3; ++k) {
+            int v = tris[3*f + k];
+            if (v < 0 || v >= V) return 0;
+            bool seen = false;
+            for (int j = 0; j < count; ++j) seen = seen || out[j] == v;
+            if (!seen) out[count++] = v;
+        }
+        return count;
+    };
+
+    // 1. Count
+    int corners[3];
+    for (int f = 0; f < F; ++f) {
+        int n = face_corners(f, corners);
+        for (int k = 0; k < n; ++k) adj->vf_offsets[corners[k] + 1]++;
+    }
+    for (int e = 0; e < E; ++e) {
+        adj->ve_offsets[topo->edges[2*e] + 1]++;
+        adj->ve_offsets[topo->edges[2*e + 1] + 1]++;
+    }
+    for (int v = 0; v < V; ++v) {
+        adj->vf_offsets[v + 1] += adj->vf_offsets[v];
+        adj->ve_offsets[v + 1] += adj->ve_offsets[v];
+    }
+
+    adj->vf_faces = (int*)malloc(sizeof(int) * ((size_t)adj->vf_offsets[V] + 1));
+    adj->ve_edges = (int*)malloc(sizeof(int) * ((size_t)adj->ve_offsets[V] + 1));
+    if (!adj->vf_faces || !adj->ve_edges) {
+        printf("Error: malloc failed in build_vertex_adjacency\n");
+        free_vertex_adjacency(adj);
+        return NULL;
+    }
+
+    // 2. Fill in ascending face / edge order
+    std::vector<int> cursor(adj->vf_offsets, adj->vf_offsets + V);
+    for (int f = 0; f < F; ++f) {
+        int n = face_corners(f, corners);
+        for (int k = 0; k < n; ++k) adj->vf_faces[cursor[corners[k]]++] = f;
+    }
+    cursor.assign(adj->ve_offsets, adj->ve_offsets + V);
+    for (int e = 0; e < E; ++e) {
+        adj->ve_edges[cursor[topo->edges[2*e]]++] = e;
+        adj->ve_edges[cursor[topo->edges[2*e + 1]]++] = e;
+    }
+
+    return adj;
+}
+
+void free_vertex_adjacency(VertexAdjacency* adj) {
+    if (!adj) return;
+
+    if (adj->vf_offsets) free(adj->vf_offsets);
+    if (adj->vf_faces) free(adj->vf_faces);
+    if (adj->ve_offsets) free(adj->ve_offsets);
+    if (adj->ve_edges) free(adj->ve_edges);
+    free(adj);
+}
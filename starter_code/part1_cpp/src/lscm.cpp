@@ -12,10 +12,12 @@
  * - Use Eigen library for sparse linear algebra
  *
  * Algorithm:
- * 1. Build local vertex mapping (global → local indices)
- * 2. Assemble LSCM sparse matrix
- * 3. Set boundary conditions (pin 2 vertices)
- * 4. Solve sparse linear system
+ * 1. Build local vertex mapping (global → local indices, dense and stamped)
+ * 2. Assemble LSCM sparse matrix (directly in compressed-column form)
+ * 3. Set boundary conditions (pin 2 vertices, eliminated from the system)
+ * 4. Solve sparse linear system (SPD normal equations with LDLT + AMD by
+ *    default, or warm-started preconditioned CG; SparseLU on the reference
+ *    square system as the fallback)
  * 5. Normalize UVs to [0,1]²
  */
 
@@ -25,14 +27,36 @@
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
-#include <map>
+#include <limits.h>
+#include <string.h>
 #include <vector>
-#include <set>
+#include <algorithm>
+#include "parallel.h"
+#include "vertex_remap.h"
 
 // Eigen library for sparse matrices
+#include <Eigen/Dense>
 #include <Eigen/Sparse>
 #include <Eigen/SparseLU>
-// Alternative: #include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
+#include <Eigen/OrderingMethods>
+#include <Eigen/IterativeLinearSolvers>
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+#include <Eigen/CholmodSupport>
+#endif
+#include <chrono>
+#include <complex>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stdint.h>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define LSCM_HAVE_MXCSR 1
+#endif
+
+static thread_local VertexRemap tls_vertex_remap;
 
 struct Vec3d{
     double x, y, z;
@@ -41,6 +65,9 @@ struct Vec3d{
         return Vec3d(x - other.x, y - other.y, z - other.z);
 
     }
+    Vec3d operator+(const Vec3d& other) const {
+        return Vec3d(x + other.x, y + other.y, z + other.z);
+    }
 };
 
 static double dot(const Vec3d& a, Vec3d& b){
@@ -66,64 +93,547 @@ static Vec3d normalize(const Vec3d& v) {
 }
 
 
+/**
+ * @brief Chain directed boundary sides (a -> b) into ordered loops
+ *
+ * Sides are sorted by start vertex, then each loop follows side (a -> b) to
+ * the first unused side leaving b until it returns to its start. At a
+ * vertex shared by several loops (two islands touching at a corner) the
+ * walk takes the first free side, so every side is used exactly once and
+ * a loop may come back through that vertex.
+ *
+ * @param sides [a0,b0, a1,b1, ...] in any order (sorted in place)
+ * @param vertices_out Loop vertices, loop after loop
+ * @param loop_offsets_out Loop l is vertices[offsets[l], offsets[l+1])
+ */
+static void chain_boundary_loops(std::vector<std::pair<int, int>>& sides,
+                                 std::vector<int>& vertices_out,
+                                 std::vector<int>& loop_offsets_out) {
+    std::sort(sides.begin(), sides.end());
+    std::vector<char> used(sides.size(), 0);
+    vertices_out.clear();
+    vertices_out.reserve(sides.size());
+    loop_offsets_out.assign(1, 0);
+
+    auto first_free_from = [&](int v) -> long {
+        auto it = std::lower_bound(sides.begin(), sides.end(), std::make_pair(v, INT_MIN));
+        for (long i = it - sides.begin(); i < (long)sides.size() && sides[i].first == v; i++) {
+            if (!used[i]) return i;
+        }
+        return -1;
+    };
+
+    for (size_t start = 0; start < sides.size(); start++) {
+        if (used[start]) continue;
+        for (long i = (long)start; i >= 0; i = first_free_from(sides[i].second)) {
+            used[i] = 1;
+            vertices_out.push_back(sides[i].first);
+        }
+        loop_offsets_out.push_back((int)vertices_out.size());
+    }
+}
+
+/**
+ * @brief Directed boundary sides of an island from its faces alone
+ *
+ * Sides are keyed (min, max) and sorted; a key used by a single face is on
+ * the boundary and keeps that face's orientation.
+ */
+static void island_boundary_sides(const Mesh* mesh, const int* face_indices, int num_faces,
+                                  std::vector<std::pair<int, int>>& sides_out) {
+    struct Side { uint64_t key; int a, b; };
+    std::vector<Side> all(3 * (size_t)num_faces);
+    for (int i = 0; i < num_faces; ++i) {
+        const int* tri = mesh->triangles + 3 * (size_t)face_indices[i];
+        for (int k = 0; k < 3; ++k) {
+            int a = tri[k], b = tri[(k + 1) % 3];
+            uint32_t lo = (uint32_t)std::min(a, b), hi = (uint32_t)std::max(a, b);
+            all[3*(size_t)i + k] = Side{((uint64_t)lo << 32) | hi, a, b};
+        }
+    }
+    std::sort(all.begin(), all.end(), [](const Side& x, const Side& y) { return x.key < y.key; });
+
+    sides_out.clear();
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].key == all[i].key) j++;
+        if (j - i == 1 && all[i].a != all[i].b) sides_out.emplace_back(all[i].a, all[i].b);
+        i = j;
+    }
+}
+
+/**
+ * @brief Directed boundary sides of an island from the shared half-edge mesh
+ *
+ * A side is on the island boundary when it has no twin or its twin lies in
+ * another island.
+ */
+static void island_boundary_sides_halfedge(const HalfEdgeMesh* he,
+                                           const int* face_island_ids,
+                                           const int* face_indices,
+                                           int num_faces,
+                                           std::vector<std::pair<int, int>>& sides_out) {
+    sides_out.clear();
+    int island = face_island_ids[face_indices[0]];
+
+    for (int i = 0; i < num_faces; ++i) {
+        int f = face_indices[i];
+        for (int h = 3*f; h < 3*f + 3; ++h) {
+            if (he->he_edge[h] < 0) continue;
+            int twin = he->he_twin[h];
+            if (twin >= 0 && face_island_ids[he->he_face[twin]] == island) continue;
+            sides_out.emplace_back(he->he_vertex[h], he->he_vertex[he->he_next[h]]);
+        }
+    }
+}
+
+int find_boundary_loops(const Mesh* mesh,
+                        const int* face_indices,
+                        int num_faces,
+                        int** vertices_out,
+                        int** loop_offsets_out) {
+    *vertices_out = NULL;
+    *loop_offsets_out = NULL;
+    if (!mesh || !face_indices || num_faces <= 0) return 0;
+
+    std::vector<std::pair<int, int>> sides;
+    std::vector<int> vertices, offsets;
+    island_boundary_sides(mesh, face_indices, num_faces, sides);
+    chain_boundary_loops(sides, vertices, offsets);
+
+    int num_loops = (int)offsets.size() - 1;
+    if (num_loops == 0) return 0;
+    *vertices_out = (int*)malloc(sizeof(int) * vertices.size());
+    *loop_offsets_out = (int*)malloc(sizeof(int) * offsets.size());
+    if (!*vertices_out || !*loop_offsets_out) {
+        free(*vertices_out);
+        free(*loop_offsets_out);
+        *vertices_out = NULL;
+        *loop_offsets_out = NULL;
+        return 0;
+    }
+    std::copy(vertices.begin(), vertices.end(), *vertices_out);
+    std::copy(offsets.begin(), offsets.end(), *loop_offsets_out);
+    return num_loops;
+}
+
+/**
+ * @brief Drop repeat visits of a vertex that several loops pass through
+ *
+ * Only start vertices of two or more sides can repeat, so those alone are
+ * tracked; the loop order of everything else is kept.
+ */
+static void drop_repeated_boundary_vertices(const std::vector<std::pair<int, int>>& sorted_sides,
+                                            std::vector<int>& vertices) {
+    std::vector<int> shared;
+    for (size_t i = 1; i < sorted_sides.size(); i++) {
+        if (sorted_sides[i].first == sorted_sides[i - 1].first &&
+            (shared.empty() || shared.back() != sorted_sides[i].first)) {
+            shared.push_back(sorted_sides[i].first);
+        }
+    }
+    if (shared.empty()) return;
+
+    std::vector<char> seen(shared.size(), 0);
+    size_t out = 0;
+    for (int v : vertices) {
+        auto it = std::lower_bound(shared.begin(), shared.end(), v);
+        if (it != shared.end() && *it == v) {
+            if (seen[it - shared.begin()]) continue;
+            seen[it - shared.begin()] = 1;
+        }
+        vertices[out++] = v;
+    }
+    vertices.resize(out);
+}
+
 int find_boundary_vertices(const Mesh* mesh,
                           const int* face_indices,
                           int num_faces,
                           int** boundary_out) {
-    // TODO: Implement
-    //
-    // Steps:
-    // 1. Count how many times each edge appears in the island
-    // 2. Edges that appear only once are boundary edges
-    // 3. Collect vertices from boundary edges
-    //
-    // Hint: Use std::map<Edge, int> to count edge usage
+    *boundary_out = NULL;
+    if (!mesh || !face_indices || num_faces <= 0) return 0;
 
-    std::set<int> boundary_verts;
+    std::vector<std::pair<int, int>> sides;
+    std::vector<int> vertices, offsets;
+    island_boundary_sides(mesh, face_indices, num_faces, sides);
+    chain_boundary_loops(sides, vertices, offsets);
+    drop_repeated_boundary_vertices(sides, vertices);
 
-    // YOUR CODE HERE
+    int num_boundary = (int)vertices.size();
+    if (num_boundary > 0) {
+        *boundary_out = (int*)malloc(num_boundary * sizeof(int));
+        if (!*boundary_out) return 0;
+        std::copy(vertices.begin(), vertices.end(), *boundary_out);
+    }
+    return num_boundary;
+}
 
-    std::map<std::pair<int, int>, int> edge_counts;
-    const int* tris = mesh->triangles;
-    // 1. Count edges
-    for (int i = 0; i < num_faces; ++i){
-        int f = face_indices[i];
-        int v0 = tris[3*f + 0];
-        int v1 = tris[3*f + 1];
-        int v2 = tris[3*f + 2];
+/**
+ * @brief Approximate farthest pair among points, in O(n)
+ *
+ * 1. Extreme points along 14 directions: the points' principal axis, the
+ *    3 coordinate axes, 6 face diagonals and 4 body diagonals. The axes
+ *    and diagonals leave no direction more than 27.6° from one of them, and
+ *    the extent along a direction is at most the distance of its extreme
+ *    pair, so the best candidate is at least cos(27.6°) ≈ 0.886 of the
+ *    diameter
+ * 2. Farthest-point sweeps from the current pair's ends while they find a
+ *    longer pair (at most 4), which usually closes the remaining gap
+ * 3. Ties broken as the former all-pairs scan did: of the pairs at the
+ *    found distance that touch a candidate from steps 1-2, the one with
+ *    the smallest vertex indices, smaller index first. Symmetric meshes
+ *    therefore keep their pins, and their layouts are not mirrored
+ *
+ * @param vertices xyz per mesh vertex
+ * @param points Mesh vertex indices to consider (count >= 2)
+ * @return Pair of mesh vertex indices, smaller first
+ */
+static std::pair<int, int> approximate_farthest_pair(const float* vertices, const int* points, int count) {
+    auto position = [&](int i) {
+        const float* p = vertices + 3 * (size_t)points[i];
+        return Eigen::Vector3d(p[0], p[1], p[2]);
+    };
+
+    // Principal axis: dominant eigenvector of the point covariance
+    Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+    for (int i = 0; i < count; i++) mean += position(i);
+    mean /= count;
+    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+    for (int i = 0; i < count; i++) {
+        Eigen::Vector3d d = position(i) - mean;
+        covariance += d * d.transpose();
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigen(covariance);
+
+    std::vector<Eigen::Vector3d> directions = {
+        eigen.eigenvectors().col(2),
+        {1, 0, 0}, {0, 1, 0}, {0, 0, 1},
+        {1, 1, 0}, {1, -1, 0}, {1, 0, 1}, {1, 0, -1}, {0, 1, 1}, {0, 1, -1},
+        {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {-1, 1, 1},
+    };
+    std::vector<int> lo(directions.size(), 0), hi(directions.size(), 0);
+    std::vector<double> lo_value(directions.size(), DBL_MAX), hi_value(directions.size(), -DBL_MAX);
+    for (int i = 0; i < count; i++) {
+        Eigen::Vector3d p = position(i);
+        for (size_t d = 0; d < directions.size(); d++) {
+            double t = p.dot(directions[d]);
+            if (t < lo_value[d]) { lo_value[d] = t; lo[d] = i; }
+            if (t > hi_value[d]) { hi_value[d] = t; hi[d] = i; }
+        }
+    }
 
-        int edges[3][2] = {{v0, v1}, {v1, v2}, {v2, v0}};
+    int a = 0, b = 1;
+    double best = (position(a) - position(b)).squaredNorm();
+    for (size_t d = 0; d < directions.size(); d++) {
+        double d2 = (position(lo[d]) - position(hi[d])).squaredNorm();
+        if (d2 > best) { best = d2; a = lo[d]; b = hi[d]; }
+    }
 
-        for (int e = 0; e < 3; ++e){
-            int a = edges[e][0];
-            int b = edges[e][1];
-            if (a > b) std::swap(a, b);
-            edge_counts[{a, b}]++;
+    // Sweep from alternating ends; each accepted pair is strictly longer
+    for (int sweep = 0; sweep < 4; sweep++) {
+        int from = (sweep % 2 == 0) ? a : b;
+        Eigen::Vector3d origin = position(from);
+        int far = from;
+        double far_d2 = -1.0;
+        for (int i = 0; i < count; i++) {
+            double d2 = (position(i) - origin).squaredNorm();
+            if (d2 > far_d2) { far_d2 = d2; far = i; }
         }
+        if (far_d2 <= best) break;
+        best = far_d2;
+        if (sweep % 2 == 0) b = far; else a = far;
     }
 
-    // 2. Identify boundary edges
-    for (auto const& kv : edge_counts) {
-        if (kv.second == 1) {
-            boundary_verts.insert(kv.first.first);
-            boundary_verts.insert(kv.first.second);
+    auto ordered = [](int x, int y) { return std::make_pair(std::min(x, y), std::max(x, y)); };
+    std::pair<int, int> pair = ordered(points[a], points[b]);
+    std::vector<int> candidates(lo);
+    candidates.insert(candidates.end(), hi.begin(), hi.end());
+    candidates.push_back(a);
+    candidates.push_back(b);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    for (int c : candidates) {
+        Eigen::Vector3d origin = position(c);
+        for (int i = 0; i < count; i++) {
+            if (i == c || (position(i) - origin).squaredNorm() != best) continue;
+            pair = std::min(pair, ordered(points[c], points[i]));
         }
     }
+    return pair;
+}
 
+/** Island faces per thread below which matrix assembly stays serial */
+static const size_t LSCM_MIN_FACES_PER_THREAD = 16384;
 
-    // Convert to array
-    int num_boundary = (int)boundary_verts.size();
-    if (num_boundary > 0) {
-        *boundary_out = (int*)malloc(num_boundary * sizeof(int));
-        int idx = 0;
-        for (int v : boundary_verts) {
-            (*boundary_out)[idx++] = v;
+/**
+ * @brief Which LSCM system assemble_lscm_matrix builds
+ *
+ * - LSCM_SYSTEM_SQUARE: the reference per-side system
+ *   (reference/lscm_matrix_example.cpp); unsymmetric, needs SparseLU
+ * - LSCM_SYSTEM_NORMAL: normal equations MᵀM of the least-squares conformal
+ *   energy Σ_T A_T |∂U/∂z̄|²; symmetric positive definite once pinned
+ */
+enum LSCMSystem { LSCM_SYSTEM_SQUARE, LSCM_SYSTEM_NORMAL };
+
+/**
+ * @brief Assemble an LSCM system straight into compressed storage
+ *
+ * Each used triangle contributes 2x2 blocks (row vertex, column vertex)
+ * between its corners:
+ * - square: side va→vb adds a block at (va, vb) and one at (va, va), so
+ *   column corner k couples to rows k and k-1
+ * - normal: with W_j = (y_k - y_l) + i(x_l - x_k) / (2√A) per corner, the
+ *   block (j, k) is [[P, Q], [-Q, P]] with P = Re(W_j W̄_k), Q = Im(W_j W̄_k);
+ *   every corner pair couples
+ *
+ * Steps:
+ * 1. Per triangle (parallel): local corners and six coefficients from the
+ *    triangle's projected frame
+ * 2. Counting sort of (triangle, corner) slots by column block
+ * 3. Per column block (parallel): sorted row blocks, then a gather of the
+ *    slots in triangle order
+ *
+ * Each thread owns whole columns, so no atomics are needed, and every entry
+ * sums its contributions in triangle order, independent of thread count.
+ *
+ * For the normal system only the lower triangle is stored (the diagonal
+ * blocks keep their one upper entry, which the Cholesky solvers ignore).
+ *
+ * With corner_angles (3 per island face, e.g. from ABF++), each triangle
+ * keeps the length of its side 0->1 but takes its shape from the angles by
+ * the law of sines, instead of from its 3D positions.
+ *
+ * The two pinned vertices are eliminated while building: their rows are
+ * dropped, and their columns times the pinned UVs move to the right-hand
+ * side. What remains is the (2n-4) x (2n-4) system over free unknowns, with
+ * free vertex c at block c minus the number of pins before it.
+ */
+static void assemble_lscm_matrix(const Mesh* mesh,
+                                 const int* face_indices,
+                                 int num_faces,
+                                 const VertexRemap& global_to_local,
+                                 int n,
+                                 const int pins[2],
+                                 const double pin_uvs[4],
+                                 LSCMSystem system,
+                                 const float* corner_angles,
+                                 int num_threads,
+                                 Eigen::SparseMatrix<double>& A,
+                                 Eigen::VectorXd& rhs) {
+    const float* vertices = mesh->vertices;
+    const int* tris = mesh->triangles;
+
+    // 1. Local corners and per-triangle coefficients; degenerate faces are dropped
+    //    square: (area*dx, area*dy) of sides 0->1, 1->2, 2->0
+    //    normal: (Re W_j, Im W_j) of corners 0, 1, 2
+    std::vector<int> corners(3 * (size_t)num_faces);
+    std::vector<double> coeffs(6 * (size_t)num_faces);
+    std::vector<char> used(num_faces);
+
+    int threads = limit_thread_count(num_threads, (size_t)num_faces, LSCM_MIN_FACES_PER_THREAD);
+    parallel_for_chunks(threads, (size_t)num_faces, [&](int, size_t b, size_t e) {
+        for (size_t i = b; i < e; i++) {
+            int f = face_indices[i];
+            int g0 = tris[3*f + 0]; // global
+            int g1 = tris[3*f + 1];
+            int g2 = tris[3*f + 2];
+
+            corners[3*i + 0] = global_to_local.find(g0); // local
+            corners[3*i + 1] = global_to_local.find(g1);
+            corners[3*i + 2] = global_to_local.find(g2);
+
+            Vec3d p0(vertices[3*g0 + 0], vertices[3*g0 + 1], vertices[3*g0 + 2]); // 3d positions
+            Vec3d p1(vertices[3*g1 + 0], vertices[3*g1 + 1], vertices[3*g1 + 2]);
+            Vec3d p2(vertices[3*g2 + 0], vertices[3*g2 + 1], vertices[3*g2 + 2]);
+
+            Vec3d e1 = p1 - p0;  // project to Local 2d plane
+            Vec3d e2 = p2 - p0;
+            Vec3d normal = normalize(cross(e1, e2));
+            Vec3d u_axis = normalize(e1);
+            Vec3d v_axis = cross(normal, u_axis);
+
+            double q0_x = 0.0, q0_y = 0.0;
+            double q1_x = dot(e1, u_axis), q1_y = dot(e1, v_axis);
+            double q2_x = dot(e2, u_axis), q2_y = dot(e2, v_axis);
+
+            if (corner_angles) {
+                // Side 0->2 from the sine rule; corner 0 opens by its target angle
+                const float* alpha = &corner_angles[3*i];
+                double sin2 = std::sin((double)alpha[2]);
+                double len02 = sin2 > 1e-12 ? q1_x * std::sin((double)alpha[1]) / sin2 : 0.0;
+                q2_x = len02 * std::cos((double)alpha[0]);
+                q2_y = len02 * std::sin((double)alpha[0]);
+            }
+
+            double area = 0.5 * std::abs(q1_x * q2_y - q1_y * q2_x);
+            used[i] = area >= 1e-10;  // degenerate triangle otherwise
+
+            double* c = &coeffs[6*i];
+            if (system == LSCM_SYSTEM_SQUARE) {
+                c[0] = area * (q1_x - q0_x); c[1] = area * (q1_y - q0_y);
+                c[2] = area * (q2_x - q1_x); c[3] = area * (q2_y - q1_y);
+                c[4] = area * (q0_x - q2_x); c[5] = area * (q0_y - q2_y);
+            } else {
+                // Gradient of the hat function of corner j is (y_k - y_l, x_l - x_k) / 2A
+                double w = used[i] ? 1.0 / (2.0 * std::sqrt(area)) : 0.0;
+                c[0] = w * (q1_y - q2_y); c[1] = w * (q2_x - q1_x);
+                c[2] = w * (q2_y - q0_y); c[3] = w * (q0_x - q2_x);
+                c[4] = w * (q0_y - q1_y); c[5] = w * (q1_x - q0_x);
+            }
         }
-    } else {
-        *boundary_out = NULL;
+    });
+
+    // Does row corner r of a triangle couple to column corner k?
+    auto couples = [&](int r, int k) {
+        return system == LSCM_SYSTEM_NORMAL || r == k || r == (k + 2) % 3;
+    };
+
+    // Block (row corner r, column corner k) of triangle i:
+    // out = {(2a, 2c), (2a+1, 2c), (2a, 2c+1), (2a+1, 2c+1)}
+    auto triangle_block = [&](int i, int r, int k, double out[4]) {
+        const double* c = &coeffs[6*i];
+        if (system == LSCM_SYSTEM_SQUARE) {
+            if (r == k) {       // diagonal block of side k -> k+1
+                double dx = c[2*k], dy = c[2*k + 1];
+                out[0] = -dx; out[1] = -dy; out[2] = -dy; out[3] = dx;
+            } else {            // off-diagonal block of side r -> k
+                double dx = c[2*r], dy = c[2*r + 1];
+                out[0] = dx; out[1] = dy; out[2] = dy; out[3] = -dx;
+            }
+        } else {
+            double aj = c[2*r], bj = c[2*r + 1];
+            double ak = c[2*k], bk = c[2*k + 1];
+            double P = aj * ak + bj * bk;
+            double Q = bj * ak - aj * bk;
+            out[0] = P; out[1] = -Q; out[2] = Q; out[3] = P;
+        }
+    };
+
+    // 2. (triangle, corner) slots grouped by column block, ascending within each
+    std::vector<int> col_offsets((size_t)n + 1, 0);
+    for (int i = 0; i < num_faces; i++) {
+        if (!used[i]) continue;
+        for (int k = 0; k < 3; k++) col_offsets[corners[3*i + k] + 1]++;
     }
+    for (int c = 0; c < n; c++) col_offsets[c + 1] += col_offsets[c];
 
-    return num_boundary;
+    std::vector<int> col_slots(col_offsets[n]);
+    std::vector<int> cursor(col_offsets.begin(), col_offsets.end() - 1);
+    for (int i = 0; i < num_faces; i++) {
+        if (!used[i]) continue;
+        for (int k = 0; k < 3; k++) col_slots[cursor[corners[3*i + k]]++] = 3*i + k;
+    }
+
+    // Row blocks per column block, pinned rows already left out. The normal
+    // system is symmetric, so free columns keep only the lower triangle
+    // (row block >= column block); pinned columns keep every row for the rhs
+    auto is_pinned = [&](int v) { return v == pins[0] || v == pins[1]; };
+    auto reduced = [&](int v) { return v - (pins[0] < v) - (pins[1] < v); };
+    auto keeps_row = [&](int c, int row) {
+        if (is_pinned(row)) return false;
+        return system == LSCM_SYSTEM_SQUARE || is_pinned(c) || row >= c;
+    };
+
+    std::vector<int> block_offsets((size_t)n + 1, 0);
+    std::vector<int> blocks(3 * (size_t)col_offsets[n] + (size_t)n);
+    threads = limit_thread_count(num_threads, (size_t)n, LSCM_MIN_FACES_PER_THREAD);
+    parallel_for_chunks(threads, (size_t)n, [&](int, size_t b, size_t e) {
+        for (size_t c = b; c < e; c++) {
+            int* out = &blocks[3 * (size_t)col_offsets[c] + c];
+            int count = 0;
+            if (!is_pinned((int)c)) out[count++] = (int)c;
+            for (int s = col_offsets[c]; s < col_offsets[c + 1]; s++) {
+                int i = col_slots[s] / 3, k = col_slots[s] % 3;
+                for (int r = 0; r < 3; r++) {
+                    int row = corners[3*i + r];
+                    if (couples(r, k) && keeps_row((int)c, row)) out[count++] = row;
+                }
+            }
+            std::sort(out, out + count);
+            block_offsets[c + 1] = (int)(std::unique(out, out + count) - out);
+        }
+    });
+    auto column_rows = [&](int c) { return &blocks[3 * (size_t)col_offsets[c] + c]; };
+
+    // Sum the 2x2 blocks of column block c into val_u (column 2c) and val_v
+    // (column 2c+1), two rows per entry of rows[]
+    auto gather_column = [&](int c, const int* rows, int num_rows, double* val_u, double* val_v) {
+        for (int r = 0; r < 2 * num_rows; r++) val_u[r] = val_v[r] = 0.0;
+
+        for (int s = col_offsets[c]; s < col_offsets[c + 1]; s++) {
+            int i = col_slots[s] / 3, k = col_slots[s] % 3;
+            for (int r = 0; r < 3; r++) {
+                int row_block = corners[3*i + r];
+                if (!couples(r, k) || !keeps_row(c, row_block)) continue;
+                double block[4];
+                triangle_block(i, r, k, block);
+                int pos = (int)(std::lower_bound(rows, rows + num_rows, row_block) - rows);
+                val_u[2*pos] += block[0];
+                val_u[2*pos + 1] += block[1];
+                val_v[2*pos] += block[2];
+                val_v[2*pos + 1] += block[3];
+            }
+        }
+    };
+
+    // 3. Compressed layout over free columns: 2 columns per free block,
+    //    2 rows per row block
+    const int m = n - 2;
+    A.resize(2*m, 2*m);
+    int nnz = 0;
+    for (int c = 0; c < n; c++) {
+        if (!is_pinned(c)) nnz += 4 * block_offsets[c + 1];
+    }
+    A.resizeNonZeros(nnz);
+
+    int* outer = A.outerIndexPtr();
+    int* inner = A.innerIndexPtr();
+    double* values = A.valuePtr();
+    outer[0] = 0;
+    for (int c = 0; c < n; c++) {
+        if (is_pinned(c)) continue;
+        int col = 2 * reduced(c);
+        int len = 2 * block_offsets[c + 1];
+        outer[col + 1] = outer[col] + len;
+        outer[col + 2] = outer[col + 1] + len;
+    }
+
+    parallel_for_chunks(threads, (size_t)n, [&](int, size_t b, size_t e) {
+        for (size_t c = b; c < e; c++) {
+            if (is_pinned((int)c)) continue;
+            const int* rows = column_rows((int)c);
+            const int num_rows = block_offsets[c + 1];
+            const int col = 2 * reduced((int)c);
+            int* inner_u = inner + outer[col];
+            int* inner_v = inner + outer[col + 1];
+            for (int r = 0; r < num_rows; r++) {
+                int row = 2 * reduced(rows[r]);
+                inner_u[2*r] = inner_v[2*r] = row;
+                inner_u[2*r + 1] = inner_v[2*r + 1] = row + 1;
+            }
+            gather_column((int)c, rows, num_rows, values + outer[col], values + outer[col + 1]);
+        }
+    });
+
+    // Pinned columns: rhs = -A[free, pinned] * pinned UVs
+    rhs = Eigen::VectorXd::Zero(2*m);
+    std::vector<double> val_u, val_v;
+    for (int p = 0; p < 2; p++) {
+        const int c = pins[p];
+        const int* rows = column_rows(c);
+        const int num_rows = block_offsets[c + 1];
+        val_u.resize(2 * (size_t)num_rows);
+        val_v.resize(2 * (size_t)num_rows);
+        gather_column(c, rows, num_rows, val_u.data(), val_v.data());
+
+        const double pu = pin_uvs[2*p], pv = pin_uvs[2*p + 1];
+        for (int r = 0; r < num_rows; r++) {
+            int row = 2 * reduced(rows[r]);
+            rhs[row] -= val_u[2*r] * pu + val_v[2*r] * pv;
+            rhs[row + 1] -= val_u[2*r + 1] * pu + val_v[2*r + 1] * pv;
+        }
+    }
 }
 
 void normalize_uvs_to_unit_square(float* uvs, int num_verts) {
@@ -175,9 +685,1008 @@ void normalize_uvs_to_unit_square(float* uvs, int num_verts) {
     }
 }
 
+static double seconds_now() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::AMDOrdering<int>> LDLTSolver;
+typedef Eigen::SparseLU<Eigen::SparseMatrix<double>> LUSolver;
+
+/** Stored entries of the LDLT factor L (D is kept separately) */
+static long long factor_nonzeros(LDLTSolver& solver) {
+    return solver.matrixL().nestedExpression().nonZeros();
+}
+
+/** Stored entries of the supernodal L and U factors */
+static long long factor_nonzeros(LUSolver& solver) {
+    return solver.nnzL() + solver.nnzU();
+}
+
+/** Single-precision factors for LSCM_PRECISION_FLOAT / _MIXED */
+typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<float>, Eigen::Lower, Eigen::AMDOrdering<int>> LDLTSolverF;
+typedef Eigen::SparseLU<Eigen::SparseMatrix<float>> LUSolverF;
+
+static long long factor_nonzeros(LDLTSolverF& solver) {
+    return solver.matrixL().nestedExpression().nonZeros();
+}
+
+static long long factor_nonzeros(LUSolverF& solver) {
+    return solver.nnzL() + solver.nnzU();
+}
+
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+typedef Eigen::CholmodSupernodalLLT<Eigen::SparseMatrix<double>, Eigen::Lower> CholmodSolver;
+
+/** Entries of the supernodal factor, as counted by CHOLMOD's analysis */
+static long long factor_nonzeros(CholmodSolver& solver) {
+    return (long long)solver.cholmod().lnz;
+}
+#endif
+
+/** Word-wise FNV-style hash of a byte range, chained through h */
+static uint64_t hash_bytes(uint64_t h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        h = (h ^ word) * 0x100000001b3ULL;
+        h ^= h >> 29;
+    }
+    for (; size > 0; size--, p++) h = (h ^ *p) * 0x100000001b3ULL;
+    return h;
+}
+
+static const uint64_t HASH_SEED = 0xcbf29ce484222325ULL;
+
+/**
+ * @brief Cache of LSCM factorizations, keyed by island connectivity
+ *
+ * An entry holds one solver after analyzePattern (and, once factored, its
+ * numeric factor). A lookup compares the assembled matrix against the
+ * entry's pattern and value hashes:
+ * - new key or different pattern: miss, full analyzePattern + factorize
+ * - same pattern, new values (geometry moved): numeric factorize only
+ * - same pattern and values: the cached factor is reused as is
+ *
+ * Entries are evicted least-recently-used first once their estimated size
+ * exceeds the budget. Islands are solved concurrently, so the index has its
+ * own lock and each entry a lock held while it is factored or solved; an
+ * entry evicted mid-use lives on through its shared_ptr until released.
+ */
+struct LSCMCacheEntry {
+    std::mutex lock;
+    bool in_cache = true;          // guarded by the cache lock
+    size_t bytes = 0;              // guarded by the cache lock
+    uint64_t pattern_hash = 0;
+    uint64_t values_hash = 0;
+    bool factorized = false;
+    std::unique_ptr<LDLTSolver> ldlt;
+    std::unique_ptr<LUSolver> lu;
+};
+
+static std::unique_ptr<LDLTSolver>& cache_slot(LSCMCacheEntry& entry, LDLTSolver*) { return entry.ldlt; }
+static std::unique_ptr<LUSolver>& cache_slot(LSCMCacheEntry& entry, LUSolver*) { return entry.lu; }
+
+/** Default factorization cache budget (bytes): off until a caller sets one */
+static const long long LSCM_CACHE_DEFAULT_BUDGET = 0;
+
+class LSCMFactorCache {
+public:
+    /** Entry for key (created if absent), or NULL when the cache is disabled */
+    std::shared_ptr<LSCMCacheEntry> acquire(uint64_t key) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (budget_ <= 0) return nullptr;
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+        lru_.emplace_front(key, std::make_shared<LSCMCacheEntry>());
+        index_[key] = lru_.begin();
+        return lru_.front().second;
+    }
+
+    /** Record an entry's new size and evict from the cold end to fit the budget */
+    void resize(const std::shared_ptr<LSCMCacheEntry>& entry, size_t bytes) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (!entry->in_cache) return;
+        bytes_ += (long long)bytes - (long long)entry->bytes;
+        entry->bytes = bytes;
+        evict_to(budget_);
+    }
+
+    void count(int outcome) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (outcome == LSCM_CACHE_MISS) misses_++;
+        else if (outcome == LSCM_CACHE_SYMBOLIC_HIT) symbolic_hits_++;
+        else if (outcome == LSCM_CACHE_NUMERIC_HIT) numeric_hits_++;
+    }
+
+    void set_budget(long long budget) {
+        std::lock_guard<std::mutex> guard(lock_);
+        budget_ = budget > 0 ? budget : 0;
+        evict_to(budget_);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock_);
+        evict_to(-1);
+        misses_ = symbolic_hits_ = numeric_hits_ = evictions_ = 0;
+    }
+
+    void stats(LSCMCacheStats* out) {
+        std::lock_guard<std::mutex> guard(lock_);
+        out->misses = misses_;
+        out->symbolic_hits = symbolic_hits_;
+        out->numeric_hits = numeric_hits_;
+        out->evictions = evictions_;
+        out->bytes = bytes_;
+        out->budget_bytes = budget_;
+        out->entries = (int)lru_.size();
+    }
+
+private:
+    typedef std::list<std::pair<uint64_t, std::shared_ptr<LSCMCacheEntry>>> LruList;
+
+    // Caller holds lock_. A limit below zero empties the cache
+    void evict_to(long long limit) {
+        while (!lru_.empty() && (bytes_ > limit || limit < 0)) {
+            std::shared_ptr<LSCMCacheEntry>& victim = lru_.back().second;
+            victim->in_cache = false;
+            bytes_ -= (long long)victim->bytes;
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+            if (limit >= 0) evictions_++;
+        }
+    }
+
+    std::mutex lock_;
+    LruList lru_;                                   // most recently used first
+    std::unordered_map<uint64_t, LruList::iterator> index_;
+    long long budget_ = LSCM_CACHE_DEFAULT_BUDGET;
+    long long bytes_ = 0;
+    long long misses_ = 0, symbolic_hits_ = 0, numeric_hits_ = 0, evictions_ = 0;
+};
+
+static LSCMFactorCache g_factor_cache;
+
+void lscm_cache_set_budget(long long budget_bytes) { g_factor_cache.set_budget(budget_bytes); }
+void lscm_cache_clear(void) { g_factor_cache.clear(); }
+void lscm_cache_get_stats(LSCMCacheStats* stats_out) {
+    if (stats_out) g_factor_cache.stats(stats_out);
+}
+
+/**
+ * @brief Cache key of an island: its faces, their corners, the pins and the system
+ *
+ * unwrap_mesh passes each island's faces in ascending order, so the same
+ * connectivity always maps to the same key.
+ */
+static uint64_t island_cache_key(const Mesh* mesh, const int* face_indices, int num_faces,
+                                 const int pins[2], int system) {
+    uint64_t h = hash_bytes(HASH_SEED, &system, sizeof(system));
+    h = hash_bytes(h, pins, 2 * sizeof(int));
+    h = hash_bytes(h, face_indices, sizeof(int) * (size_t)num_faces);
+    for (int i = 0; i < num_faces; i++) {
+        h = hash_bytes(h, &mesh->triangles[3 * face_indices[i]], 3 * sizeof(int));
+    }
+    return h;
+}
+
+/**
+ * @brief Factor A with a direct solver and solve, without the cache
+ * @return false if the factorization or the solve failed (caller falls back)
+ */
+template <typename Solver>
+static bool solve_direct(const Eigen::SparseMatrix<double>& A,
+                         const Eigen::VectorXd& b,
+                         Eigen::VectorXd& x,
+                         LSCMStats& stats) {
+    double t0 = seconds_now();
+    Solver solver;
+    solver.compute(A);
+    double t1 = seconds_now();
+    stats.factor_seconds += t1 - t0;
+    if (solver.info() != Eigen::Success) return false;
+    stats.factor_nonzeros = factor_nonzeros(solver);
+
+    x = solver.solve(b);
+    stats.solve_seconds += seconds_now() - t1;
+    return solver.info() == Eigen::Success && x.allFinite();
+}
+
+/** Default relative residual target of mixed-precision refinement */
+static const double LSCM_REFINE_DEFAULT_TOLERANCE = 1e-10;
+/** Refinement solves before a mixed-precision solve falls back to double */
+static const int LSCM_REFINE_MAX_STEPS = 50;
+
+/**
+ * @brief Flush denormals to zero while in scope (x86 only)
+ *
+ * Fill entries of a float factorization underflow into the denormal range,
+ * where every operation on them is many times slower; without this the
+ * float factorization is about 2x slower than the double one.
+ */
+struct FlushDenormals {
+#ifdef LSCM_HAVE_MXCSR
+    unsigned saved = _mm_getcsr();
+    FlushDenormals() { _mm_setcsr(saved | 0x8040); }   // FTZ | DAZ
+    ~FlushDenormals() { _mm_setcsr(saved); }
+#else
+    FlushDenormals() {}                                 // no MXCSR: nothing to flush
+#endif
+};
+
+/**
+ * @brief Factor A in float and solve, with optional mixed-precision refinement
+ *
+ * The float solution is checked against the double system: r = b - A x,
+ * with A the stored lower triangle of the normal system (symmetric) or the
+ * full square system. With refine set and the residual above tolerance:
+ * - symmetric: CG on the double system, preconditioned by the float
+ *   factor. Two pins leave LSCM badly conditioned, and plain refinement
+ *   x += A_f⁻¹ r converges slowly or stalls at that condition number
+ * - square: plain refinement while the residual still shrinks
+ *
+ * @return false if the float factorization failed, or if refine is set and
+ *         the residual did not reach tolerance (caller refactors in double)
+ */
+template <typename SolverF>
+static bool solve_direct_float(const Eigen::SparseMatrix<double>& A,
+                               const Eigen::VectorXd& b,
+                               bool symmetric,
+                               bool refine,
+                               double tolerance,
+                               Eigen::VectorXd& x,
+                               LSCMStats& stats) {
+    double t0 = seconds_now();
+    SolverF solver;
+    {
+        FlushDenormals flush;
+        Eigen::SparseMatrix<float> A_f = A.cast<float>();
+        solver.compute(A_f);
+    }
+    double t1 = seconds_now();
+    stats.factor_seconds += t1 - t0;
+    if (solver.info() != Eigen::Success) return false;
+    stats.factor_nonzeros = factor_nonzeros(solver);
+
+    auto residual = [&](const Eigen::VectorXd& v) -> Eigen::VectorXd {
+        if (symmetric) return b - A.selfadjointView<Eigen::Lower>() * v;
+        return b - A * v;
+    };
+    const double b_norm = b.norm() > 0.0 ? b.norm() : 1.0;
+
+    auto precondition = [&](const Eigen::VectorXd& v) -> Eigen::VectorXd {
+        return solver.solve(v.cast<float>()).template cast<double>();
+    };
+
+    x = precondition(b);
+    Eigen::VectorXd r = residual(x);
+    stats.residual = r.norm() / b_norm;
+    stats.refinement_steps = 0;
+    if (refine && symmetric && stats.residual > tolerance) {
+        // CG on the double system, preconditioned by the float factor
+        Eigen::VectorXd z = precondition(r), d = z;
+        double rz = r.dot(z);
+        while (stats.residual > tolerance && stats.refinement_steps < LSCM_REFINE_MAX_STEPS) {
+            Eigen::VectorXd Ad = A.selfadjointView<Eigen::Lower>() * d;
+            double alpha = rz / d.dot(Ad);
+            x += alpha * d;
+            r -= alpha * Ad;
+            stats.refinement_steps++;
+            stats.residual = r.norm() / b_norm;
+            z = precondition(r);
+            double rz_next = r.dot(z);
+            d = z + (rz_next / rz) * d;
+            rz = rz_next;
+        }
+    }
+    while (refine && !symmetric && stats.residual > tolerance && stats.refinement_steps < LSCM_REFINE_MAX_STEPS) {
+        Eigen::VectorXd next = x + precondition(r);
+        Eigen::VectorXd r_next = residual(next);
+        double next_residual = r_next.norm() / b_norm;
+        stats.refinement_steps++;
+        if (!(next_residual < stats.residual)) break;   // stalled: float factor too inaccurate
+        x = next;
+        r = r_next;
+        stats.residual = next_residual;
+    }
+    stats.solve_seconds += seconds_now() - t1;
+    stats.precision_used = LSCM_PRECISION_FLOAT;
+    if (!x.allFinite()) return false;
+    return !refine || stats.residual <= tolerance;
+}
+
+/**
+ * @brief Factor A and solve, reusing cached symbolic / numeric work for key
+ *
+ * With the cache disabled this is solve_direct().
+ * @return false if the factorization or the solve failed (caller falls back)
+ */
+template <typename Solver>
+static bool factor_and_solve(uint64_t key,
+                             const Eigen::SparseMatrix<double>& A,
+                             const Eigen::VectorXd& b,
+                             Eigen::VectorXd& x,
+                             LSCMStats& stats) {
+    std::shared_ptr<LSCMCacheEntry> entry = g_factor_cache.acquire(key);
+    if (!entry) return solve_direct<Solver>(A, b, x, stats);
+    double t0 = seconds_now();
+
+    std::lock_guard<std::mutex> guard(entry->lock);
+    std::unique_ptr<Solver>& solver = cache_slot(*entry, (Solver*)NULL);
+
+    uint64_t pattern = hash_bytes(HASH_SEED, A.outerIndexPtr(), sizeof(int) * ((size_t)A.cols() + 1));
+    pattern = hash_bytes(pattern, A.innerIndexPtr(), sizeof(int) * (size_t)A.nonZeros());
+    uint64_t values = hash_bytes(HASH_SEED, A.valuePtr(), sizeof(double) * (size_t)A.nonZeros());
+
+    int outcome;
+    if (!solver || entry->pattern_hash != pattern) {
+        outcome = LSCM_CACHE_MISS;
+        solver.reset(new Solver());
+        solver->analyzePattern(A);
+        entry->pattern_hash = pattern;
+        entry->factorized = false;
+    } else if (!entry->factorized || entry->values_hash != values) {
+        outcome = LSCM_CACHE_SYMBOLIC_HIT;
+    } else {
+        outcome = LSCM_CACHE_NUMERIC_HIT;
+    }
+    if (outcome != LSCM_CACHE_NUMERIC_HIT) {
+        solver->factorize(A);
+        entry->values_hash = values;
+        entry->factorized = solver->info() == Eigen::Success;
+    }
+    g_factor_cache.count(outcome);
+    stats.cache_result = outcome;
+
+    double t1 = seconds_now();
+    stats.factor_seconds += t1 - t0;
+    if (!entry->factorized) {
+        solver.reset();
+        g_factor_cache.resize(entry, 0);
+        return false;
+    }
+    stats.factor_nonzeros = factor_nonzeros(*solver);
+    // Factor entries (value + row index) plus per-column bookkeeping
+    g_factor_cache.resize(entry, (size_t)stats.factor_nonzeros * (sizeof(double) + sizeof(int)) +
+                                 (size_t)A.cols() * 4 * sizeof(int));
+
+    x = solver->solve(b);
+    stats.solve_seconds += seconds_now() - t1;
+    return solver->info() == Eigen::Success && x.allFinite();
+}
+
+/**
+ * @brief Direct solve at the requested precision
+ *
+ * Double goes through the factorization cache. Float and mixed factor from
+ * scratch; a mixed solve that misses its tolerance is redone in double.
+ */
+template <typename Solver, typename SolverF>
+static bool solve_direct_at_precision(uint64_t key,
+                                      const Eigen::SparseMatrix<double>& A,
+                                      const Eigen::VectorXd& b,
+                                      bool symmetric,
+                                      const LSCMOptions* options,
+                                      Eigen::VectorXd& x,
+                                      LSCMStats& stats) {
+    int precision = options ? options->precision : LSCM_PRECISION_DOUBLE;
+    if (precision == LSCM_PRECISION_FLOAT || precision == LSCM_PRECISION_MIXED) {
+        bool refine = precision == LSCM_PRECISION_MIXED;
+        double tolerance = options->refine_tolerance > 0.0 ? options->refine_tolerance
+                                                            : LSCM_REFINE_DEFAULT_TOLERANCE;
+        if (solve_direct_float<SolverF>(A, b, symmetric, refine, tolerance, x, stats)) {
+            stats.precision_used = precision;
+            return true;
+        }
+        if (refine) {
+            printf("  Mixed precision stopped at residual %.2e after %d refinement steps, "
+                   "refactoring in double\n", stats.residual, stats.refinement_steps);
+        }
+    }
+    stats.precision_used = LSCM_PRECISION_DOUBLE;
+    stats.residual = 0.0;
+    return factor_and_solve<Solver>(key, A, b, x, stats);
+}
+
+/** Relative residual CG stops at when the caller gives no tolerance */
+static const double LSCM_CG_DEFAULT_TOLERANCE = 1e-6;
+
+/**
+ * @brief Solve the SPD reduced system with preconditioned CG
+ *
+ * x holds the initial guess on entry. Hitting the iteration cap is not an
+ * error: the caller asked for a bounded, possibly inexact solve.
+ * @return false if the preconditioner failed or the iterate is not finite
+ */
+template <typename Preconditioner>
+static bool solve_cg(const Eigen::SparseMatrix<double>& A,
+                     const Eigen::VectorXd& b,
+                     double tolerance,
+                     int max_iterations,
+                     Eigen::VectorXd& x,
+                     LSCMStats& stats) {
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower, Preconditioner> cg;
+    cg.setTolerance(tolerance > 0.0 ? tolerance : LSCM_CG_DEFAULT_TOLERANCE);
+    if (max_iterations > 0) cg.setMaxIterations(max_iterations);
+
+    double t0 = seconds_now();
+    cg.compute(A);
+    double t1 = seconds_now();
+    stats.factor_seconds += t1 - t0;
+    if (cg.info() != Eigen::Success) return false;
+
+    x = cg.solveWithGuess(b, x);
+    stats.solve_seconds += seconds_now() - t1;
+    stats.iterations = (int)cg.iterations();
+    stats.residual = cg.error();
+    if (cg.info() == Eigen::NoConvergence) {
+        printf("  CG stopped after %d iterations (residual %.2e)\n", stats.iterations, stats.residual);
+    }
+    return x.allFinite();
+}
+
+/**
+ * @brief Rescale the u and v parts of a starting guess to minimise the energy
+ *
+ * Earlier layouts are usually normalized with different u and v scales, so
+ * a pin-to-pin similarity alone leaves one axis off by a constant factor.
+ * The best x = a*g_u + c*g_v over that two-dimensional subspace is a 2x2
+ * solve costing two matrix-vector products.
+ */
+static void rescale_guess(const Eigen::SparseMatrix<double>& A,
+                          const Eigen::VectorXd& b,
+                          Eigen::VectorXd& x) {
+    Eigen::VectorXd gu = Eigen::VectorXd::Zero(x.size());
+    Eigen::VectorXd gv = Eigen::VectorXd::Zero(x.size());
+    for (Eigen::Index i = 0; i + 1 < x.size(); i += 2) {
+        gu[i] = x[i];
+        gv[i + 1] = x[i + 1];
+    }
+    Eigen::VectorXd Agu = A.selfadjointView<Eigen::Lower>() * gu;
+    Eigen::VectorXd Agv = A.selfadjointView<Eigen::Lower>() * gv;
+
+    double m00 = gu.dot(Agu), m01 = gu.dot(Agv), m11 = gv.dot(Agv);
+    double r0 = gu.dot(b), r1 = gv.dot(b);
+    double det = m00 * m11 - m01 * m01;
+    if (!(std::abs(det) > 1e-12 * std::abs(m00 * m11))) return;
+
+    double a = (r0 * m11 - r1 * m01) / det;
+    double c = (r1 * m00 - r0 * m01) / det;
+    x = a * gu + c * gv;
+}
+
+/**
+ * @brief Starting point for CG over the free unknowns
+ *
+ * UVs come from initial_uvs (indexed by mesh vertex, e.g. the previous
+ * unwrap) when given, otherwise from projecting the island onto the plane
+ * of its area-weighted normal. The similarity that sends the two pins'
+ * starting UVs to their targets then brings them into the solve's frame,
+ * so a packed or rescaled previous layout is still a close guess.
+ */
+static Eigen::VectorXd initial_guess(const Mesh* mesh,
+                                     const std::vector<int>& local_to_global,
+                                     const int pins[2],
+                                     const double pin_uvs[4],
+                                     const float* initial_uvs,
+                                     const int* face_indices,
+                                     int num_faces) {
+    const int n = (int)local_to_global.size();
+    const float* vertices = mesh->vertices;
+    std::vector<std::complex<double>> z(n);
+
+    if (initial_uvs) {
+        for (int v = 0; v < n; v++) {
+            int g = local_to_global[v];
+            z[v] = std::complex<double>(initial_uvs[2*g], initial_uvs[2*g + 1]);
+        }
+    } else {
+        Vec3d normal(0.0, 0.0, 0.0);
+        for (int i = 0; i < num_faces; i++) {
+            const int* t = &mesh->triangles[3 * face_indices[i]];
+            Vec3d p0(vertices[3*t[0]], vertices[3*t[0] + 1], vertices[3*t[0] + 2]);
+            Vec3d p1(vertices[3*t[1]], vertices[3*t[1] + 1], vertices[3*t[1] + 2]);
+            Vec3d p2(vertices[3*t[2]], vertices[3*t[2] + 1], vertices[3*t[2] + 2]);
+            normal = normal + cross(p1 - p0, p2 - p0);
+        }
+        if (dot(normal, normal) < 1e-20) normal = Vec3d(0.0, 0.0, 1.0);
+        normal = normalize(normal);
+        Vec3d helper = std::abs(normal.x) < 0.9 ? Vec3d(1.0, 0.0, 0.0) : Vec3d(0.0, 1.0, 0.0);
+        Vec3d u_axis = normalize(cross(helper, normal));
+        Vec3d v_axis = cross(normal, u_axis);
+        for (int v = 0; v < n; v++) {
+            int g = local_to_global[v];
+            Vec3d p(vertices[3*g], vertices[3*g + 1], vertices[3*g + 2]);
+            z[v] = std::complex<double>(dot(p, u_axis), dot(p, v_axis));
+        }
+    }
+
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(2 * (n - 2));
+    std::complex<double> z1 = z[pins[0]], z2 = z[pins[1]];
+    if (std::abs(z2 - z1) < 1e-12) return x;  // degenerate guess: start from zero
+
+    std::complex<double> t1(pin_uvs[0], pin_uvs[1]), t2(pin_uvs[2], pin_uvs[3]);
+    std::complex<double> scale = (t2 - t1) / (z2 - z1);
+    for (int v = 0, k = 0; v < n; v++) {
+        if (v == pins[0] || v == pins[1]) continue;
+        std::complex<double> w = t1 + (z[v] - z1) * scale;
+        x[2*k] = w.real();
+        x[2*k + 1] = w.imag();
+        k++;
+    }
+    return x;
+}
+
+/** Island size at which the multigrid hierarchy stops coarsening */
+static const int LSCM_MG_DEFAULT_COARSE_VERTICES = 4096;
+/** CG sweeps on the finest level when the caller sets none */
+static const int LSCM_MG_DEFAULT_SMOOTHING = 30;
+
+/**
+ * @brief One level of the multigrid hierarchy: an island mesh in local indices
+ */
+struct LSCMLevel {
+    std::vector<float> positions;   // xyz per vertex
+    std::vector<int> triangles;     // 3 vertices per face
+    std::vector<int> to_coarse;     // vertex -> vertex of the next coarser level
+    std::vector<char> collapsed;    // 1 if the vertex was merged into a neighbour
+    int pins[2];
+
+    int num_vertices() const { return (int)(positions.size() / 3); }
+    int num_faces() const { return (int)(triangles.size() / 3); }
+};
+
+/**
+ * @brief One round of greedy shortest-edge half-edge collapses
+ *
+ * Edges are visited shortest first. A collapse moves the removed vertex
+ * onto its neighbour and locks its one-ring, so no two collapses touch
+ * the same face and each can be checked on its own:
+ * - pins never collapse, so they exist on every level
+ * - a boundary vertex survives over an interior one
+ * - an interior edge joining two boundary vertices is skipped (it would
+ *   pinch the island)
+ * - a collapse that would flip or flatten a face is skipped (LSCM on a
+ *   folded coarse mesh solves a different map)
+ * Faces that lose a corner are dropped.
+ *
+ * @return false if the round removed too few vertices to be worth a level
+ */
+static bool coarsen_level(LSCMLevel& fine, LSCMLevel& coarse) {
+    const int nv = fine.num_vertices();
+    const int nf = fine.num_faces();
+    const float* P = fine.positions.data();
+    const int* T = fine.triangles.data();
+
+    // Unique edges; those used by a single face are boundary
+    std::vector<uint64_t> sides(3 * (size_t)nf);
+    for (int f = 0; f < nf; f++) {
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = (uint32_t)T[3*f + k], b = (uint32_t)T[3*f + (k + 1) % 3];
+            if (a > b) std::swap(a, b);
+            sides[3*f + k] = ((uint64_t)a << 32) | b;
+        }
+    }
+    std::sort(sides.begin(), sides.end());
+
+    struct Edge { int a, b; float length_sq; bool boundary; };
+    std::vector<Edge> edges;
+    edges.reserve(sides.size() / 2 + 1);
+    std::vector<char> on_boundary(nv, 0);
+    for (size_t i = 0; i < sides.size();) {
+        size_t j = i;
+        while (j < sides.size() && sides[j] == sides[i]) j++;
+        int a = (int)(sides[i] >> 32), b = (int)(sides[i] & 0xffffffffu);
+        if (a != b) {
+            float dx = P[3*a] - P[3*b], dy = P[3*a + 1] - P[3*b + 1], dz = P[3*a + 2] - P[3*b + 2];
+            bool boundary = (j - i) == 1;
+            if (boundary) on_boundary[a] = on_boundary[b] = 1;
+            edges.push_back(Edge{a, b, dx*dx + dy*dy + dz*dz, boundary});
+        }
+        i = j;
+    }
+    // Stable: equal lengths keep vertex-pair order, so the result is deterministic
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const Edge& x, const Edge& y) { return x.length_sq < y.length_sq; });
+
+    // Faces around each vertex (CSR), for the fold-over test
+    std::vector<int> face_offsets(nv + 1, 0), vertex_faces(3 * (size_t)nf);
+    for (int c = 0; c < 3 * nf; c++) face_offsets[T[c] + 1]++;
+    for (int v = 0; v < nv; v++) face_offsets[v + 1] += face_offsets[v];
+    {
+        std::vector<int> cursor(face_offsets.begin(), face_offsets.end() - 1);
+        for (int c = 0; c < 3 * nf; c++) vertex_faces[cursor[T[c]]++] = c / 3;
+    }
+    auto face_normal = [&](int a, int b, int c) {
+        Eigen::Vector3d pa(P[3*a], P[3*a + 1], P[3*a + 2]);
+        Eigen::Vector3d pb(P[3*b], P[3*b + 1], P[3*b + 2]);
+        Eigen::Vector3d pc(P[3*c], P[3*c + 1], P[3*c + 2]);
+        return Eigen::Vector3d((pb - pa).cross(pc - pa));
+    };
+    // Moving r onto k must not flip or flatten any face of r that survives
+    auto folds = [&](int r, int k) {
+        for (int i = face_offsets[r]; i < face_offsets[r + 1]; i++) {
+            const int* tri = T + 3 * (size_t)vertex_faces[i];
+            if (tri[0] == k || tri[1] == k || tri[2] == k) continue;
+            int moved[3];
+            for (int j = 0; j < 3; j++) moved[j] = tri[j] == r ? k : tri[j];
+            Eigen::Vector3d before = face_normal(tri[0], tri[1], tri[2]);
+            Eigen::Vector3d after = face_normal(moved[0], moved[1], moved[2]);
+            if (before.dot(after) <= 0.25 * before.norm() * after.norm()) return true;
+        }
+        return false;
+    };
+
+    auto pinned = [&](int v) { return v == fine.pins[0] || v == fine.pins[1]; };
+    std::vector<int> keep(nv);
+    for (int v = 0; v < nv; v++) keep[v] = v;
+    std::vector<char> locked(nv, 0);
+    for (const Edge& e : edges) {
+        if (on_boundary[e.a] && on_boundary[e.b] && !e.boundary) continue;
+
+        // Removable end: never a pin, and an interior vertex before a boundary one
+        int k = e.a, r = e.b;
+        if (!pinned(e.a) && (pinned(e.b) || (on_boundary[e.b] && !on_boundary[e.a]))) std::swap(k, r);
+        if (pinned(r) || locked[r] || keep[k] != k) continue;
+        if (on_boundary[r] && !on_boundary[k]) continue;
+        if (folds(r, k)) continue;
+
+        // Lock r's one-ring, so the faces around r change only by this collapse
+        keep[r] = k;
+        for (int i = face_offsets[r]; i < face_offsets[r + 1]; i++) {
+            const int* tri = T + 3 * (size_t)vertex_faces[i];
+            locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+        }
+    }
+
+    std::vector<int> index(nv, -1);
+    int nc = 0;
+    for (int v = 0; v < nv; v++) {
+        if (keep[v] == v) index[v] = nc++;
+    }
+    if (nc > nv - nv / 10) return false;
+
+    fine.to_coarse.resize(nv);
+    fine.collapsed.resize(nv);
+    coarse.positions.resize(3 * (size_t)nc);
+    for (int v = 0; v < nv; v++) {
+        fine.to_coarse[v] = index[keep[v]];
+        fine.collapsed[v] = keep[v] != v;
+        if (keep[v] == v) std::copy(P + 3*v, P + 3*v + 3, &coarse.positions[3 * (size_t)index[v]]);
+    }
+
+    coarse.triangles.clear();
+    coarse.triangles.reserve(3 * (size_t)nf);
+    for (int f = 0; f < nf; f++) {
+        int c0 = fine.to_coarse[T[3*f]], c1 = fine.to_coarse[T[3*f + 1]], c2 = fine.to_coarse[T[3*f + 2]];
+        if (c0 == c1 || c1 == c2 || c2 == c0) continue;
+        coarse.triangles.push_back(c0);
+        coarse.triangles.push_back(c1);
+        coarse.triangles.push_back(c2);
+    }
+    coarse.pins[0] = fine.to_coarse[fine.pins[0]];
+    coarse.pins[1] = fine.to_coarse[fine.pins[1]];
+    return true;
+}
+
+/**
+ * @brief Prolongation of (u, v) per vertex from a coarse level to the one above
+ *
+ * A surviving vertex takes its coarse vertex's value. A collapsed vertex
+ * interpolates the surviving corners of its faces with the minimum-norm
+ * weights that reproduce affine functions in its tangent plane, so a
+ * smooth map is interpolated to second order (a plain neighbour mean is
+ * off by a fraction of an edge, which the conformal energy sees as O(1)
+ * distortion). u and v are interpolated alike.
+ */
+static Eigen::SparseMatrix<double> build_prolongation(const LSCMLevel& fine, const LSCMLevel& coarse) {
+    const int nv = fine.num_vertices();
+    const float* X = fine.positions.data();
+    auto position = [&](int v) { return Eigen::Vector3d(X[3*v], X[3*v + 1], X[3*v + 2]); };
+
+    // Surviving face corners of each collapsed vertex, and its area-weighted normal
+    std::vector<std::pair<int, int>> links;
+    std::vector<Eigen::Vector3d> normals(nv, Eigen::Vector3d::Zero());
+    for (int f = 0; f < fine.num_faces(); f++) {
+        const int* tri = &fine.triangles[3 * (size_t)f];
+        Eigen::Vector3d n = (position(tri[1]) - position(tri[0])).cross(position(tri[2]) - position(tri[0]));
+        for (int k = 0; k < 3; k++) {
+            int r = tri[k];
+            if (!fine.collapsed[r]) continue;
+            normals[r] += n;
+            for (int j = 0; j < 3; j++) {
+                if (!fine.collapsed[tri[j]]) links.emplace_back(r, tri[j]);
+            }
+        }
+    }
+    std::sort(links.begin(), links.end());
+    links.erase(std::unique(links.begin(), links.end()), links.end());
+
+    std::vector<Eigen::Triplet<double>> entries;
+    entries.reserve(2 * (size_t)nv + 2 * links.size());
+    auto add = [&](int v, int c, double w) {
+        entries.emplace_back(2 * v, 2 * c, w);
+        entries.emplace_back(2 * v + 1, 2 * c + 1, w);
+    };
+    std::vector<double> weights;
+    size_t l = 0;
+    for (int v = 0; v < nv; v++) {
+        size_t end = l;
+        while (end < links.size() && links[end].first == v) end++;
+        const size_t k = end - l;
+        if (!fine.collapsed[v] || k == 0) {
+            add(v, fine.to_coarse[v], 1.0);
+        } else {
+            // Rows of C: 1, and the tangent-plane offsets of each corner; w = Cᵀ (C Cᵀ)⁻¹ e1
+            Eigen::Vector3d n = normals[v];
+            if (n.squaredNorm() == 0.0) n = Eigen::Vector3d::UnitZ();
+            Eigen::Vector3d t1 = n.unitOrthogonal(), t2 = n.normalized().cross(t1);
+            Eigen::Matrix<double, 3, Eigen::Dynamic> C(3, k);
+            double scale = 0.0;
+            for (size_t i = 0; i < k; i++) {
+                Eigen::Vector3d d = position(links[l + i].second) - position(v);
+                C.col(i) << 1.0, d.dot(t1), d.dot(t2);
+                scale = std::max(scale, d.squaredNorm());
+            }
+            C.bottomRows(2) /= std::sqrt(scale > 0.0 ? scale : 1.0);
+            Eigen::Matrix3d G = C * C.transpose();
+            Eigen::FullPivLU<Eigen::Matrix3d> lu(G);
+            weights.assign(k, 1.0 / (double)k);
+            if (k >= 3 && lu.rank() == 3) {
+                Eigen::VectorXd w = C.transpose() * lu.solve(Eigen::Vector3d::UnitX());
+                for (size_t i = 0; i < k; i++) weights[i] = w[i];
+            }
+            for (size_t i = 0; i < k; i++) add(v, fine.to_coarse[links[l + i].second], weights[i]);
+        }
+        l = end;
+    }
+
+    Eigen::SparseMatrix<double> P(2 * nv, 2 * coarse.num_vertices());
+    P.setFromTriplets(entries.begin(), entries.end());
+    return P;
+}
+
+/**
+ * @brief Assemble the LSCM normal system of one hierarchy level
+ */
+static void assemble_level(const LSCMLevel& level, const double pin_uvs[4],
+                           Eigen::SparseMatrix<double>& A, Eigen::VectorXd& rhs) {
+    Mesh view;
+    view.num_vertices = level.num_vertices();
+    view.num_triangles = level.num_faces();
+    view.vertices = const_cast<float*>(level.positions.data());
+    view.triangles = const_cast<int*>(level.triangles.data());
+    view.uvs = NULL;
+
+    std::vector<int> faces(view.num_triangles);
+    for (int f = 0; f < view.num_triangles; f++) faces[f] = f;
+    VertexRemap identity;
+    identity.begin(view.num_vertices);
+    for (int v = 0; v < view.num_vertices; v++) identity.set(v, v);
+
+    assemble_lscm_matrix(&view, faces.data(), view.num_triangles, identity, view.num_vertices,
+                         level.pins, pin_uvs, LSCM_SYSTEM_NORMAL, NULL, 1, A, rhs);
+}
+
+/**
+ * @brief Cascadic multigrid LSCM solve
+ *
+ * 1. Coarsen a local copy of the island by rounds of edge collapses until
+ *    it has at most coarse_vertices vertices
+ * 2. Solve LSCM on the coarsest mesh directly (LDLT; a few thousand
+ *    vertices)
+ * 3. Going back up, prolongate the map onto each finer level and smooth it
+ *    with Jacobi-preconditioned CG on that level's own LSCM system. The
+ *    finest level gets `smoothing` sweeps; a level with n_l vertices gets
+ *    smoothing * sqrt(n_0 / n_l), so every level costs about the same
+ *    fraction of the total and the sum stays linear in the island
+ *
+ * Only one level's matrix exists at a time, next to the meshes and
+ * prolongations of the hierarchy (a geometric series over the island), so
+ * memory is linear; the direct solvers' fill grows faster than that.
+ * Smoothing removes the error that is local to each level, so the result
+ * is close to, but not exactly, the direct solution (see ALGORITHM.md).
+ *
+ * @return false if the coarse factorization failed (caller falls back)
+ */
+static bool solve_multigrid(const Mesh* mesh,
+                            const int* face_indices,
+                            int num_faces,
+                            const VertexRemap& global_to_local,
+                            const std::vector<int>& local_to_global,
+                            const int pins[2],
+                            const double pin_uvs[4],
+                            const LSCMOptions* options,
+                            Eigen::VectorXd& x_free,
+                            LSCMStats& stats) {
+    int coarse_vertices = options && options->mg_coarse_vertices > 0 ? options->mg_coarse_vertices
+                                                                     : LSCM_MG_DEFAULT_COARSE_VERTICES;
+    int smoothing = options && options->mg_smoothing_iterations > 0 ? options->mg_smoothing_iterations
+                                                                    : LSCM_MG_DEFAULT_SMOOTHING;
+    double tolerance = options && options->cg_tolerance > 0.0 ? options->cg_tolerance
+                                                             : LSCM_CG_DEFAULT_TOLERANCE;
+    double t0 = seconds_now();
+
+    // 1. Hierarchy; level 0 is the island in local indices
+    std::vector<LSCMLevel> levels(1);
+    const int n = (int)local_to_global.size();
+    levels[0].positions.resize(3 * (size_t)n);
+    for (int v = 0; v < n; v++) {
+        const float* p = mesh->vertices + 3 * (size_t)local_to_global[v];
+        std::copy(p, p + 3, &levels[0].positions[3 * (size_t)v]);
+    }
+    levels[0].triangles.resize(3 * (size_t)num_faces);
+    for (int i = 0; i < num_faces; i++) {
+        for (int k = 0; k < 3; k++) {
+            levels[0].triangles[3*i + k] = global_to_local.find(mesh->triangles[3 * face_indices[i] + k]);
+        }
+    }
+    levels[0].pins[0] = pins[0];
+    levels[0].pins[1] = pins[1];
+
+    std::vector<Eigen::SparseMatrix<double>> prolongations;
+    while (levels.back().num_vertices() > coarse_vertices) {
+        LSCMLevel coarse;
+        if (!coarsen_level(levels.back(), coarse)) break;
+        prolongations.push_back(build_prolongation(levels.back(), coarse));
+        levels.push_back(std::move(coarse));
+    }
+    stats.mg_levels = (int)levels.size();
+
+    // 2. Coarsest level; x holds (u, v) of every vertex of the current level
+    const int coarsest = (int)levels.size() - 1;
+    Eigen::SparseMatrix<double> A;
+    Eigen::VectorXd b, x_level;
+    assemble_level(levels[coarsest], pin_uvs, A, b);
+    double t1 = seconds_now();
+    stats.assemble_seconds += t1 - t0;
+
+    double t2;
+    {
+        LDLTSolver ldlt;
+        ldlt.compute(A);
+        t2 = seconds_now();
+        stats.factor_seconds += t2 - t1;
+        if (ldlt.info() != Eigen::Success) return false;
+        stats.factor_nonzeros = factor_nonzeros(ldlt);
+        x_level = ldlt.solve(b);
+    }
+
+    // Scatter free unknowns + pins into per-vertex (u, v) and back
+    auto expand = [&](const LSCMLevel& level, const Eigen::VectorXd& free) {
+        Eigen::VectorXd full(2 * (size_t)level.num_vertices());
+        int f = 0;
+        for (int v = 0; v < level.num_vertices(); v++) {
+            int pin = v == level.pins[0] ? 0 : v == level.pins[1] ? 1 : -1;
+            full[2*v] = pin >= 0 ? pin_uvs[2*pin] : free[2*f];
+            full[2*v + 1] = pin >= 0 ? pin_uvs[2*pin + 1] : free[2*f + 1];
+            if (pin < 0) f++;
+        }
+        return full;
+    };
+    auto restrict_free = [&](const LSCMLevel& level, const Eigen::VectorXd& full) {
+        Eigen::VectorXd free(2 * (size_t)(level.num_vertices() - 2));
+        int f = 0;
+        for (int v = 0; v < level.num_vertices(); v++) {
+            if (v == level.pins[0] || v == level.pins[1]) continue;
+            free[2*f] = full[2*v];
+            free[2*f + 1] = full[2*v + 1];
+            f++;
+        }
+        return free;
+    };
+    Eigen::VectorXd x = expand(levels[coarsest], x_level);
+    double t3 = seconds_now();
+    stats.solve_seconds += t3 - t2;
+
+    // 3. Prolongate and smooth, coarse to fine
+    int iterations = 0;
+    for (int l = coarsest - 1; l >= 0; l--) {
+        double ta = seconds_now();
+        x = prolongations[l] * x;
+        prolongations[l] = Eigen::SparseMatrix<double>();
+        assemble_level(levels[l], pin_uvs, A, b);
+        if (l == 0) stats.matrix_nonzeros = A.nonZeros();
+        double tb = seconds_now();
+        stats.assemble_seconds += tb - ta;
+
+        Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower> cg;
+        cg.setTolerance(tolerance);
+        cg.setMaxIterations((int)(smoothing * std::sqrt((double)n / levels[l].num_vertices())));
+        cg.compute(A);
+        x_level = cg.solveWithGuess(b, restrict_free(levels[l], x));
+        iterations += (int)cg.iterations();
+        if (l == 0) stats.residual = cg.error();
+        x = expand(levels[l], x_level);
+        stats.solve_seconds += seconds_now() - tb;
+    }
+    stats.iterations = iterations;
+
+    x_free = restrict_free(levels[0], x);
+    return x_free.allFinite();
+}
+
+/**
+ * @brief Local numbering of an island's vertices and its two pins
+ *
+ * Vertices are numbered in order of first use by the island's faces. The
+ * pins are the approximate farthest pair on the boundary, or local vertices
+ * 0 and 1 for a closed island.
+ *
+ * @return Number of boundary vertices; pins are left unset below 3 vertices.
+ *         -1 when every boundary vertex sits at one position: no two
+ *         distinct points to pin, so the island cannot be flattened
+ */
+static int island_vertices_and_pins(const Mesh* mesh,
+                                    const int* face_indices,
+                                    int num_faces,
+                                    const LSCMOptions* options,
+                                    VertexRemap& global_to_local,
+                                    std::vector<int>& local_to_global,
+                                    int pins[2]) {
+    global_to_local.begin(mesh->num_vertices);
+    local_to_global.clear();
+
+    const float* vertices = mesh->vertices;
+    const int* tris = mesh->triangles;
+
+    for(int i = 0; i < num_faces; i++){
+        int f = face_indices[i];
+        for(int j = 0; j < 3; j++){
+            int global_idx = tris[3*f + j];
+
+            if (global_to_local.find(global_idx) < 0){
+                global_to_local.set(global_idx, (int)local_to_global.size());
+                local_to_global.push_back(global_idx);
+            }
+        }
+    }
+
+    const int n = (int)local_to_global.size();
+    pins[0] = pins[1] = 0;
+    if (n < 3) return 0;
+
+    // Boundary as ordered loops: from the shared half-edge mesh when the
+    // pipeline provides one, otherwise from the island's own faces
+    std::vector<std::pair<int, int>> boundary_sides;
+    std::vector<int> boundary, boundary_loops;
+    if (options && options->halfedge && options->face_island_ids) {
+        island_boundary_sides_halfedge(options->halfedge, options->face_island_ids,
+                                       face_indices, num_faces, boundary_sides);
+    } else {
+        island_boundary_sides(mesh, face_indices, num_faces, boundary_sides);
+    }
+    chain_boundary_loops(boundary_sides, boundary, boundary_loops);
+    drop_repeated_boundary_vertices(boundary_sides, boundary);
+    const int num_boundary = (int)boundary.size();
+
+    if (num_boundary >= 2) {
+        std::pair<int, int> farthest = approximate_farthest_pair(vertices, boundary.data(), num_boundary);
+        pins[0] = global_to_local.find(farthest.first);
+        pins[1] = global_to_local.find(farthest.second);
+        const float* p = vertices + 3 * (size_t)farthest.first;
+        const float* q = vertices + 3 * (size_t)farthest.second;
+        if (pins[0] == pins[1] || (p[0] == q[0] && p[1] == q[1] && p[2] == q[2])) return -1;
+    } else {
+        pins[1] = (pins[0] + 1) % n;
+    }
+    return num_boundary;
+}
+
 float* lscm_parameterize(const Mesh* mesh,
                          const int* face_indices,
                          int num_faces) {
+    return lscm_parameterize_ex(mesh, face_indices, num_faces, NULL);
+}
+
+float* lscm_parameterize_ex(const Mesh* mesh,
+                            const int* face_indices,
+                            int num_faces,
+                            const LSCMOptions* options) {
     if (!mesh || !face_indices || num_faces == 0) return NULL;
 
     // TODO: Implement LSCM parameterization
@@ -226,28 +1735,14 @@ float* lscm_parameterize(const Mesh* mesh,
 
     printf("LSCM parameterizing %d faces...\n", num_faces);
 
-    // STEP 1: Local vertex mapping
-    std::map<int, int> global_to_local;
+    // STEP 1 + 2: Local vertex mapping and boundary conditions (chosen first
+    // so assembly can eliminate them)
+    VertexRemap& global_to_local = tls_vertex_remap;
     std::vector<int> local_to_global;
-
-    // YOUR CODE HERE
-    // ...
-
-    const float* vertices = mesh->vertices;
-    const int* tris = mesh->triangles;
-
-    for(int i = 0; i < num_faces; i++){
-        int f = face_indices[i];
-        for(int j = 0; j < 3; j++){
-            int global_idx = tris[3*f + j];
-
-            if (global_to_local.find(global_idx) == global_to_local.end()){
-                global_to_local[global_idx] = (int)local_to_global.size();
-                local_to_global.push_back(global_idx);
-            }
-        }
-    }
-
+    int pin_pair[2];
+    const int num_boundary = island_vertices_and_pins(mesh, face_indices, num_faces, options,
+                                                      global_to_local, local_to_global, pin_pair);
+    const int pin1 = pin_pair[0], pin2 = pin_pair[1];
 
     int n = (int)local_to_global.size();
     printf("  Island has %d vertices\n", n);
@@ -256,183 +1751,133 @@ float* lscm_parameterize(const Mesh* mesh,
         fprintf(stderr, "LSCM: Island too small (%d vertices)\n", n);
         return NULL;
     }
-
-    // STEP 2: Build sparse matrix
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> triplets;
-
-    // YOUR CODE HERE
-    // For each triangle:
-    //   - Get vertices and 3D positions
-    //   - Project to triangle plane
-    //   - Add LSCM energy terms
-    // See reference/lscm_matrix_example.cpp
-
-
-    for (int i = 0; i < num_faces; i++){
-        int f = face_indices[i];
-        int g0 = tris[3*f + 0]; // global
-        int g1 = tris[3*f + 1];
-        int g2 = tris[3*f + 2];
-
-        int v0 = global_to_local[g0]; // local
-        int v1 = global_to_local[g1];
-        int v2 = global_to_local[g2];
-
-        Vec3d p0(vertices[3*g0 + 0], vertices[3*g0 + 1], vertices[3*g0 + 2]); // 3d positions
-        Vec3d p1(vertices[3*g1 + 0], vertices[3*g1 + 1], vertices[3*g1 + 2]);
-        Vec3d p2(vertices[3*g2 + 0], vertices[3*g2 + 1], vertices[3*g2 + 2]);
-
-        Vec3d e1 = p1 - p0;  // project to Local 2d plane 
-        Vec3d e2 = p2 - p0;
-        Vec3d normal = normalize(cross(e1, e2)); 
-        Vec3d u_axis = normalize(e1);
-        Vec3d v_axis = cross(normal, u_axis);
-
-        double q0_x = 0.0, q0_y = 0.0;
-        double q1_x = dot(e1, u_axis), q1_y = dot(e1, v_axis);
-        double q2_x = dot(e2, u_axis), q2_y = dot(e2, v_axis);
-
-        double area = 0.5 * std::abs(q1_x * q2_y - q1_y * q2_x);
-        if (area < 1e-10) continue; // degenerate triangle
-
-        // v0 -> v1
-        double dx = q1_x - q0_x;
-        double dy = q1_y - q0_y;
-
-        triplets.push_back(T(2*v0, 2*v1, area*dx));
-        triplets.push_back(T(2*v0, 2*v1+1, area*dy));
-        triplets.push_back(T(2*v0 + 1, 2*v1, area*dy));
-        triplets.push_back(T(2*v0 + 1, 2*v1+1, area*(-dx)));
-
-        triplets.push_back(T(2*v0, 2*v0, -area*dx));
-        triplets.push_back(T(2*v0, 2*v0+1, -area*dy));
-        triplets.push_back(T(2*v0 + 1, 2*v0, -area*dy));
-        triplets.push_back(T(2*v0 + 1, 2*v0 + 1, -area*(-dx)));
-
-        // v1 -> v2
-        dx = q2_x - q1_x;
-        dy = q2_y - q1_y; 
-
-        triplets.push_back(T(2*v1, 2*v2, area*dx));
-        triplets.push_back(T(2*v1, 2*v2+1, area*dy));
-        triplets.push_back(T(2*v1 + 1, 2*v2, area*dy));
-        triplets.push_back(T(2*v1 + 1, 2*v2+1, area*(-dx)));
-
-        triplets.push_back(T(2*v1, 2*v1, -area*dx));
-        triplets.push_back(T(2*v1, 2*v1+1, -area*dy));
-        triplets.push_back(T(2*v1 + 1, 2*v1, -area*dy));
-        triplets.push_back(T(2*v1 + 1, 2*v1 + 1, -area*(-dx)));
-
-        // v2 -> v0
-        dx = q0_x - q2_x;
-        dy = q0_y - q2_y;
-
-        triplets.push_back(T(2*v2, 2*v0, area*dx));
-        triplets.push_back(T(2*v2, 2*v0 + 1, area*dy));
-        triplets.push_back(T(2*v2 + 1, 2*v0, area*dy));
-        triplets.push_back(T(2*v2 + 1, 2*v0 + 1, area*(-dx)));
-
-        triplets.push_back(T(2*v2, 2*v2, -area*dx));
-        triplets.push_back(T(2*v2, 2*v2 + 1, -area*dy));
-        triplets.push_back(T(2*v2 + 1, 2*v2, -area*dy));    
-        triplets.push_back(T(2*v2 + 1, 2*v2 + 1, -area*(-dx)));
-        
+    if (num_boundary < 0) {
+        fprintf(stderr, "LSCM: Island boundary collapses to a single point\n");
+        return NULL;
     }
 
+    // STEP 3 + 4: Build the sparse matrix and solve for the free unknowns
+    //   Pattern from the island's vertex adjacency, values scattered straight
+    //   into compressed storage (no triplet list, no sort/merge pass). Pinned
+    //   unknowns are eliminated on the way: no row zeroing, no prune
+    const int pins[2] = {pin1, pin2};
+    const double pin_uvs[4] = {0.0, 0.0, 1.0, 0.0};
+    int num_threads = resolve_thread_count(options ? options->num_threads : 0);
+    int solver = options ? options->solver : LSCM_SOLVER_LDLT;
+    const float* corner_angles = options ? options->corner_angles : NULL;
+
+    // Without a boundary the conformal energy loses its area term and its
+    // minimum collapses onto the line through the pins; closed islands keep
+    // the reference square system
+    if (num_boundary < 2) solver = LSCM_SOLVER_SPARSE_LU;
+
+    LSCMStats stats;
+    memset(&stats, 0, sizeof(stats));
+    Eigen::VectorXd x_free;
+    bool solved = false;
+
+    // Multigrid coarsens the 3D positions, so target angles need a single-level solve
+    if (solver == LSCM_SOLVER_MULTIGRID && corner_angles) solver = LSCM_SOLVER_LDLT;
+
+    // Direct factors of very large islands outgrow memory; multigrid stays
+    // linear but is approximate, so only callers that set a size switch
+    const int mg_auto_vertices = options ? options->mg_auto_vertices : 0;
+    if (solver == LSCM_SOLVER_LDLT && mg_auto_vertices > 0 && n > mg_auto_vertices && !corner_angles) {
+        printf("  %d vertices: using the multigrid solver\n", n);
+        solver = LSCM_SOLVER_MULTIGRID;
+    }
 
-
-
-    // STEP 3: Boundary conditions
-    // YOUR CODE HERE
-    // Find 2 vertices to pin
-
-    int pin1 = 0;
-    int pin2 = 0;
-
-    int* boundaries = NULL;
-    int num_boundary = find_boundary_vertices(mesh, face_indices, num_faces, &boundaries);
-    if (num_boundary >= 2 ){
-        int best_v1 = -1, best_v2 = -1;
-        double max_dist_sq = -1.0;
-
-        
-        for(int i = 0 ; i < num_boundary; i++){
-            int g_i = boundaries[i];
-            Vec3d p_i(vertices[3*g_i + 0], vertices[3*g_i + 1], vertices[3*g_i + 2]);
-
-            for(int j = i + 1; j < num_boundary; j++){
-                int g_j = boundaries[j];
-                Vec3d p_j(vertices[3*g_j + 0], vertices[3*g_j + 1], vertices[3*g_j + 2]);
-                
-                Vec3d diff = p_i - p_j;
-                double d2 = dot(diff, diff);
-                if(d2 > max_dist_sq){
-                    max_dist_sq = d2;
-                    best_v1 = g_i;
-                    best_v2 = g_j;
-                }
-            }
+    if (solver == LSCM_SOLVER_MULTIGRID) {
+        solved = solve_multigrid(mesh, face_indices, num_faces, global_to_local, local_to_global,
+                                 pins, pin_uvs, options, x_free, stats);
+        stats.solver_used = LSCM_SOLVER_MULTIGRID;
+        if (!solved) {
+            fprintf(stderr, "LSCM: multigrid failed, falling back to LDLT\n");
+            solver = LSCM_SOLVER_LDLT;
         }
-        pin1 = global_to_local[best_v1];
-        pin2 = global_to_local[best_v2];
-
-    }else{
-        pin1 = 0;
-        if (pin2 == pin1) pin2 = (pin1 + 1) % n;
     }
-    if(boundaries) free(boundaries);
 
-    // STEP 4: Solve
-    Eigen::SparseMatrix<double> A(2*n, 2*n);
-    A.setFromTriplets(triplets.begin(), triplets.end());
-
-    Eigen::VectorXd b = Eigen::VectorXd::Zero(2*n);
-
-    // YOUR CODE HERE
-    // Set up solver and solve
-
-    int pinned_indices[4] = {2*pin1, 2*pin1 + 1, 2*pin2, 2*pin2 + 1};
-    double targets[4] = {0.0, 0.0, 1.0, 0.0};
-
-    //zero out rows
-    for(int i = 0 ; i < (int)A.outerSize(); ++i){
-        for(Eigen::SparseMatrix<double>::InnerIterator it(A,i); it ; ++it){
-            int row = (int)it.row();
-            for(int p = 0; p<4; p++){
-                if( row == pinned_indices[p]){
-                    it.valueRef() = 0.0;
-                }
+    if (!solved && solver != LSCM_SOLVER_SPARSE_LU) {
+        double t0 = seconds_now();
+        Eigen::SparseMatrix<double> A;
+        Eigen::VectorXd b;
+        assemble_lscm_matrix(mesh, face_indices, num_faces, global_to_local, n,
+                             pins, pin_uvs, LSCM_SYSTEM_NORMAL, corner_angles, num_threads, A, b);
+        double t1 = seconds_now();
+        stats.assemble_seconds = t1 - t0;
+        stats.matrix_nonzeros = A.nonZeros();
+
+        if (solver == LSCM_SOLVER_CG) {
+            x_free = initial_guess(mesh, local_to_global, pins, pin_uvs,
+                                   options ? options->initial_uvs : NULL,
+                                   face_indices, num_faces);
+            rescale_guess(A, b, x_free);
+            double tol = options ? options->cg_tolerance : 0.0;
+            int max_iter = options ? options->cg_max_iterations : 0;
+            if (options && options->cg_preconditioner == LSCM_PRECOND_ICHOL) {
+                solved = solve_cg<Eigen::IncompleteCholesky<double, Eigen::Lower, Eigen::AMDOrdering<int>>>(
+                    A, b, tol, max_iter, x_free, stats);
+            } else {
+                solved = solve_cg<Eigen::DiagonalPreconditioner<double>>(
+                    A, b, tol, max_iter, x_free, stats);
+            }
+            stats.solver_used = LSCM_SOLVER_CG;
+            if (!solved) {
+                fprintf(stderr, "LSCM: CG diverged, falling back to LDLT\n");
+                solver = LSCM_SOLVER_LDLT;
             }
         }
-    }
-
-    //diagonal to 1 and RHS = target
-
-    for (int p = 0; p < 4; ++p){
-        int idx = pinned_indices[p]; 
-        A.coeffRef(idx, idx) = 1.0;
-        b[idx] = targets[p];
 
+#ifdef UVUNWRAP_HAVE_CHOLMOD
+        if (solver == LSCM_SOLVER_CHOLMOD) {
+            solved = solve_direct<CholmodSolver>(A, b, x_free, stats);
+            stats.solver_used = LSCM_SOLVER_CHOLMOD;
+        }
+#endif
+        if (!solved && (solver == LSCM_SOLVER_LDLT || stats.solver_used != LSCM_SOLVER_CHOLMOD)) {
+            uint64_t key = island_cache_key(mesh, face_indices, num_faces, pins, LSCM_SYSTEM_NORMAL);
+            solved = solve_direct_at_precision<LDLTSolver, LDLTSolverF>(key, A, b, true, options,
+                                                                       x_free, stats);
+            stats.solver_used = LSCM_SOLVER_LDLT;
+        }
+        if (!solved) {
+            fprintf(stderr, "LSCM: Cholesky factorization failed, falling back to SparseLU\n");
+        }
     }
 
-    A.prune(0.0, 1e-12);
-    // solving
-    Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
-    solver.compute(A);
-    if(solver.info() != Eigen::Success){
-        fprintf(stderr, "LSCM: SparseLU decomposition failed\n");
-        return NULL;
+    if (!solved) {
+        double t0 = seconds_now();
+        Eigen::SparseMatrix<double> A;
+        Eigen::VectorXd b;
+        assemble_lscm_matrix(mesh, face_indices, num_faces, global_to_local, n,
+                             pins, pin_uvs, LSCM_SYSTEM_SQUARE, corner_angles, num_threads, A, b);
+        double t1 = seconds_now();
+        stats.assemble_seconds += t1 - t0;
+        stats.matrix_nonzeros = A.nonZeros();
+        stats.solver_used = LSCM_SOLVER_SPARSE_LU;
+
+        uint64_t key = island_cache_key(mesh, face_indices, num_faces, pins, LSCM_SYSTEM_SQUARE);
+        if (!solve_direct_at_precision<LUSolver, LUSolverF>(key, A, b, false, options, x_free, stats)) {
+            fprintf(stderr, "LSCM: SparseLU decomposition failed\n");
+            return NULL;
+        }
     }
-
-    Eigen::VectorXd x = solver.solve(b);
-    if(solver.info() != Eigen::Success){
-        fprintf(stderr, "LSCM: SparseLU solving failed\n");
-        return NULL;
+    if (options && options->stats) *options->stats = stats;
+
+    // Scatter back: pinned vertices take their targets
+    Eigen::VectorXd x(2*n);
+    for (int v = 0, k = 0; v < n; v++) {
+        if (v == pin1 || v == pin2) {
+            int p = (v == pin1) ? 0 : 1;
+            x[2*v] = pin_uvs[2*p];
+            x[2*v + 1] = pin_uvs[2*p + 1];
+        } else {
+            x[2*v] = x_free[2*k];
+            x[2*v + 1] = x_free[2*k + 1];
+            k++;
+        }
     }
 
-
-
     // STEP 5: Extract UVs
     float* uvs = (float*)malloc(n * 2 * sizeof(float));
 
@@ -445,6 +1890,66 @@ float* lscm_parameterize(const Mesh* mesh,
 
     normalize_uvs_to_unit_square(uvs, n);
 
+    // Hand the remap to the caller's write-back
+    if (options && options->local_to_global) {
+        std::copy(local_to_global.begin(), local_to_global.end(), options->local_to_global);
+    }
+    if (options && options->num_local_out) *options->num_local_out = n;
+
     printf("  LSCM completed\n");
     return uvs;
 }
+
+LSCMLinearSystem* lscm_assemble_system(const Mesh* mesh,
+                                       const int* face_indices,
+                                       int num_faces,
+                                       int normal_equations,
+                                       const LSCMOptions* options) {
+    if (!mesh || !face_indices || num_faces == 0) return NULL;
+
+    VertexRemap& global_to_local = tls_vertex_remap;
+    std::vector<int> local_to_global;
+    int pins[2];
+    const int num_boundary = island_vertices_and_pins(mesh, face_indices, num_faces, options,
+                                                      global_to_local, local_to_global, pins);
+    const int n = (int)local_to_global.size();
+    if (n < 3 || num_boundary < 0) return NULL;
+
+    const double pin_uvs[4] = {0.0, 0.0, 1.0, 0.0};
+    Eigen::SparseMatrix<double> A;
+    Eigen::VectorXd b;
+    assemble_lscm_matrix(mesh, face_indices, num_faces, global_to_local, n, pins, pin_uvs,
+                         normal_equations ? LSCM_SYSTEM_NORMAL : LSCM_SYSTEM_SQUARE,
+                         options ? options->corner_angles : NULL,
+                         resolve_thread_count(options ? options->num_threads : 0), A, b);
+
+    const int size = (int)A.cols();
+    const int nnz = (int)A.nonZeros();
+    LSCMLinearSystem* system = (LSCMLinearSystem*)malloc(sizeof(LSCMLinearSystem));
+    system->num_local = n;
+    system->local_to_global = (int*)malloc(sizeof(int) * n);
+    std::copy(local_to_global.begin(), local_to_global.end(), system->local_to_global);
+    system->pins[0] = pins[0];
+    system->pins[1] = pins[1];
+    memcpy(system->pin_uvs, pin_uvs, sizeof(pin_uvs));
+    system->size = size;
+    system->col_offsets = (int*)malloc(sizeof(int) * (size + 1));
+    system->row_indices = (int*)malloc(sizeof(int) * (nnz > 0 ? nnz : 1));
+    system->values = (double*)malloc(sizeof(double) * (nnz > 0 ? nnz : 1));
+    system->rhs = (double*)malloc(sizeof(double) * (size > 0 ? size : 1));
+    std::copy(A.outerIndexPtr(), A.outerIndexPtr() + size + 1, system->col_offsets);
+    std::copy(A.innerIndexPtr(), A.innerIndexPtr() + nnz, system->row_indices);
+    std::copy(A.valuePtr(), A.valuePtr() + nnz, system->values);
+    std::copy(b.data(), b.data() + size, system->rhs);
+    return system;
+}
+
+void free_lscm_system(LSCMLinearSystem* system) {
+    if (!system) return;
+    free(system->local_to_global);
+    free(system->col_offsets);
+    free(system->row_indices);
+    free(system->values);
+    free(system->rhs);
+    free(system);
+}
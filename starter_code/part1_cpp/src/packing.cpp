@@ -4,21 +4,53 @@
  *
  * SKELETON - YOU IMPLEMENT THIS
  *
- * Algorithm: Shelf packing
+ * Algorithm:
  * 1. Compute bounding box for each island
- * 2. Sort islands by height (descending)
- * 3. Pack using shelf algorithm
+ * 2. Sort islands (longest side first; by height for shelves)
+ * 3. Pack with the selected packer (MaxRects-BSSF, skyline, shelf, or the
+ *    raster packer on island silhouettes), optionally rotating islands by 90°
  * 4. Scale to fit [0,1]²
+ *
+ * UDIM mode skips step 4: islands keep a texel density and are bin-packed
+ * across as many unit tiles as they need. equalize_texel_density gives all
+ * islands the same density before ordinary packing.
  */
 
 #include "unwrap.h"
 #include "math_utils.h"
+#include "face_geometry.h"
+#include "parallel.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
+#include <string.h>
+#include <limits.h>
 #include <vector>
+#include <set>
+#include <queue>
+#include <functional>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static double seconds_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Whether all three corners of face f index a vertex; build_topology
+ *        skips the others, which end up as singleton islands
+ */
+static inline bool face_corners_valid(const Mesh* mesh, int f) {
+    const int* t = mesh->triangles + 3 * (size_t)f;
+    const unsigned V = (unsigned)mesh->num_vertices;
+    return (unsigned)t[0] < V && (unsigned)t[1] < V && (unsigned)t[2] < V;
+}
 
 /**
  * @brief Island bounding box info
@@ -28,62 +60,1390 @@ struct Island {
     float min_u, max_u, min_v, max_v;
     float width, height;
     float target_x, target_y;  // Packed position
-    std::vector<int> vertex_indices;
+    bool rotated;              // Placed turned 90° counter-clockwise
+};
+
+/**
+ * @brief One island's footprint (size + margin) as the packers see it
+ *
+ * w, h are the unrotated footprint; a packer sets x, y (lower-left corner)
+ * and rotated, in which case the footprint occupies h x w.
+ */
+struct PackRect {
+    float w, h;
+    float x, y;
+    bool rotated;
+};
+
+/**
+ * @brief Common packer signature
+ *
+ * Place rects[order[0..]] in that order, starting from a side x side bin.
+ * When a rect fits nowhere, MaxRects and skyline grow the bin in place by
+ * PACK_BIN_GROWTH on both sides and carry on, so one pass places every
+ * rect. Returns the final bin side.
+ */
+typedef float (*PackerFn)(std::vector<PackRect>& rects, const std::vector<int>& order,
+                          float side, bool allow_rotation);
+
+/** Bin growth whenever a rect fits nowhere */
+static const float PACK_BIN_GROWTH = 1.01f;
+/** Free rects a skyline waste-map lookup may visit before giving up; a
+ *  miss only sends the rect to the skyline */
+static const int PACK_WASTE_MAX_VISITS = 16;
+
+/**
+ * @brief Shelf packer: rows left to right, a new shelf when the row is full
+ *
+ * Rotation turns every island landscape (width >= height), which lowers
+ * the shelves. bin_h is not enforced: shelves grow upwards.
+ */
+static float pack_shelf(std::vector<PackRect>& rects, const std::vector<int>& order,
+                        float bin_w, bool allow_rotation) {
+    float x = 0.0f, y = 0.0f, shelf_h = 0.0f;
+    for (int idx : order) {
+        PackRect& r = rects[idx];
+        r.rotated = allow_rotation && r.h > r.w;
+        float w = r.rotated ? r.h : r.w;
+        float h = r.rotated ? r.w : r.h;
+        if (x > 0.0f && x + w > bin_w) {
+            x = 0.0f;
+            y += shelf_h;
+            shelf_h = 0.0f;
+        }
+        r.x = x;
+        r.y = y;
+        x += w;
+        shelf_h = max_float(shelf_h, h);
+    }
+    return bin_w;
+}
+
+/**
+ * @brief MaxRects free-rectangle set with indexed queries
+ *
+ * Free rectangles are maximal and may overlap. Three indexes keep every
+ * operation near O(log n):
+ * - by_width / by_height: ordered (size, id) sets. Best short side fit walks
+ *   both upwards from the requested size and stops once neither front can
+ *   beat the best short-side leftover found, since every unvisited rect
+ *   leaves at least that much on both sides, or once either front runs
+ *   out, since a rect that fits is in both.
+ * - grid: a uniform grid over the bin listing the free rects that overlap
+ *   each cell, so splitting only looks at rects near the placed one, and
+ *   the containment prune only at those over a piece's corner. Removal is
+ *   lazy; dead ids are dropped when a cell is visited.
+ *
+ * grow() enlarges the bin without repacking: free rects on the right and
+ * top edges stretch to the new edges, and the two new strips are added.
+ * The grid keeps its cells, so the new area lands in the outer cells.
+ */
+struct MaxRectsBin {
+    struct Rect { float x, y, w, h; bool alive; };
+
+    float bin_w, bin_h;
+    int grid_n;
+    float cell_w, cell_h;
+    std::vector<Rect> rects;
+    std::set<std::pair<float, int>> by_width, by_height;
+    std::vector<std::vector<int>> grid;
+    std::vector<unsigned> seen;   // query stamp per rect
+    unsigned stamp = 0;
+    std::vector<int> scratch_hit;      // place() buffers, kept to avoid reallocating
+    std::vector<Rect> scratch_pieces;
+
+    /** An empty bin starts without free space, for callers that add() it */
+    MaxRectsBin(float w, float h, int num_items, bool empty = false) : bin_w(w), bin_h(h) {
+        grid_n = std::max(1, std::min(16, (int)sqrtf((float)num_items) / 2));
+        cell_w = bin_w / grid_n;
+        cell_h = bin_h / grid_n;
+        grid.resize((size_t)grid_n * grid_n);
+        if (!empty) add(0.0f, 0.0f, bin_w, bin_h);
+    }
+
+    void cell_range(float x, float y, float w, float h, int* c0, int* c1, int* r0, int* r1) const {
+        *c0 = std::min(grid_n - 1, std::max(0, (int)(x / cell_w)));
+        *c1 = std::min(grid_n - 1, std::max(0, (int)((x + w) / cell_w)));
+        *r0 = std::min(grid_n - 1, std::max(0, (int)(y / cell_h)));
+        *r1 = std::min(grid_n - 1, std::max(0, (int)((y + h) / cell_h)));
+    }
+
+    void add(float x, float y, float w, float h) {
+        int id = (int)rects.size();
+        rects.push_back({x, y, w, h, true});
+        seen.push_back(0);
+        by_width.insert({w, id});
+        by_height.insert({h, id});
+        int c0, c1, r0, r1;
+        cell_range(x, y, w, h, &c0, &c1, &r0, &r1);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) grid[(size_t)r * grid_n + c].push_back(id);
+        }
+    }
+
+    void remove(int id) {
+        Rect& r = rects[id];
+        r.alive = false;
+        by_width.erase({r.w, id});
+        by_height.erase({r.h, id});
+    }
+
+    // Live rects overlapping the closed box [x, x+w] x [y, y+h], each once
+    template <typename Fn>
+    void for_each_near(float x, float y, float w, float h, Fn fn) {
+        if (++stamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0u);
+            stamp = 1;
+        }
+        int c0, c1, r0, r1;
+        cell_range(x, y, w, h, &c0, &c1, &r0, &r1);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                std::vector<int>& cell = grid[(size_t)r * grid_n + c];
+                size_t kept = 0;
+                for (size_t k = 0; k < cell.size(); k++) {
+                    int id = cell[k];
+                    if (!rects[id].alive) continue;
+                    cell[kept++] = id;
+                    if (seen[id] == stamp) continue;
+                    seen[id] = stamp;
+                    fn(id);
+                }
+                cell.resize(kept);
+            }
+        }
+    }
+
+    /**
+     * @brief Enlarge the bin to new_w x new_h, keeping every placement
+     */
+    void grow(float new_w, float new_h) {
+        const float old_w = bin_w, old_h = bin_h;
+        const float eps_w = old_w * 1e-6f, eps_h = old_h * 1e-6f;
+        const size_t count = rects.size();
+        for (size_t id = 0; id < count; id++) {
+            Rect r = rects[id];
+            if (!r.alive) continue;
+            const bool right = r.x + r.w >= old_w - eps_w;
+            const bool top = r.y + r.h >= old_h - eps_h;
+            if (!right && !top) continue;
+            // Already in the outer grid cells, so only the size indexes change
+            remove((int)id);
+            if (right) r.w = new_w - r.x;
+            if (top) r.h = new_h - r.y;
+            rects[id] = r;
+            by_width.insert({r.w, (int)id});
+            by_height.insert({r.h, (int)id});
+        }
+        bin_w = new_w;
+        bin_h = new_h;
+
+        // The strips, unless a stretched rect already covers one
+        const Rect strips[2] = {{old_w, 0.0f, new_w - old_w, new_h, true},
+                                {0.0f, old_h, new_w, new_h - old_h, true}};
+        for (const Rect& p : strips) {
+            bool covered = false;
+            for_each_near(p.x, p.y, 0.0f, 0.0f, [&](int id) {
+                const Rect& r = rects[id];
+                if (p.x >= r.x && p.y >= r.y && p.x + p.w <= r.x + r.w && p.y + p.h <= r.y + r.h) covered = true;
+            });
+            if (!covered) add(p.x, p.y, p.w, p.h);
+        }
+    }
+
+    /**
+     * @brief Best short side fit for a w x h rect
+     * @param max_visits Candidates to look at before settling for the best
+     *        so far (which may be none)
+     * @return Free rect id, or -1; *score = (short leftover, long leftover)
+     */
+    int best_short_side_fit(float w, float h, std::pair<float, float>* score, int max_visits = INT_MAX) const {
+        int best = -1, visits = 0;
+        std::pair<float, float> best_score(FLT_MAX, FLT_MAX);
+        auto it_w = by_width.lower_bound({w, -1});
+        auto it_h = by_height.lower_bound({h, -1});
+        for (;;) {
+            float gap_w = it_w != by_width.end() ? it_w->first - w : FLT_MAX;
+            float gap_h = it_h != by_height.end() ? it_h->first - h : FLT_MAX;
+            if (std::min(gap_w, gap_h) >= best_score.first || gap_w == FLT_MAX || gap_h == FLT_MAX) break;
+            if (visits++ >= max_visits) break;
+            int id;
+            if (gap_w <= gap_h) id = (it_w++)->second;
+            else id = (it_h++)->second;
+
+            const Rect& r = rects[id];
+            if (r.w < w || r.h < h) continue;
+            float lw = r.w - w, lh = r.h - h;
+            std::pair<float, float> s(std::min(lw, lh), std::max(lw, lh));
+            if (s < best_score || (s == best_score && (r.y < rects[best].y ||
+                                   (r.y == rects[best].y && r.x < rects[best].x)))) {
+                best_score = s;
+                best = id;
+            }
+        }
+        *score = best_score;
+        return best;
+    }
+
+    /**
+     * @brief Occupy [x, x+w) x [y, y+h): split the free rects it overlaps
+     *        into maximal pieces, then drop pieces contained in another or
+     *        too small for any remaining rect (narrower than min_w or lower
+     *        than min_h)
+     */
+    void place(float x, float y, float w, float h, float min_w, float min_h) {
+        std::vector<int>& hit = scratch_hit;
+        std::vector<Rect>& pieces = scratch_pieces;
+        hit.clear();
+        pieces.clear();
+        for_each_near(x, y, w, h, [&](int id) {
+            const Rect& r = rects[id];
+            if (x < r.x + r.w && x + w > r.x && y < r.y + r.h && y + h > r.y) hit.push_back(id);
+        });
+
+        for (int id : hit) {
+            Rect r = rects[id];
+            remove(id);
+            if (x > r.x) pieces.push_back({r.x, r.y, x - r.x, r.h, true});
+            if (x + w < r.x + r.w) pieces.push_back({x + w, r.y, r.x + r.w - (x + w), r.h, true});
+            if (y > r.y) pieces.push_back({r.x, r.y, r.w, y - r.y, true});
+            if (y + h < r.y + r.h) pieces.push_back({r.x, y + h, r.w, r.y + r.h - (y + h), true});
+        }
+
+        auto contains = [](const Rect& a, const Rect& b) {
+            return b.x >= a.x && b.y >= a.y && b.x + b.w <= a.x + a.w && b.y + b.h <= a.y + a.h;
+        };
+        // Old free rects never lie inside a piece (each piece is inside a
+        // removed rect, and the set was already pruned), so only pieces can go
+        for (size_t i = 0; i < pieces.size(); i++) {
+            Rect& p = pieces[i];
+            for (size_t j = 0; j < pieces.size() && p.alive; j++) {
+                if (i == j || !pieces[j].alive || !contains(pieces[j], p)) continue;
+                // Of two identical pieces keep the first
+                if (!contains(p, pieces[j]) || j < i) p.alive = false;
+            }
+            if (!p.alive) continue;
+            // A rect containing p contains its corner, so one cell suffices
+            for_each_near(p.x, p.y, 0.0f, 0.0f, [&](int id) {
+                if (contains(rects[id], p)) p.alive = false;
+            });
+        }
+        for (const Rect& p : pieces) {
+            if (p.alive && p.w >= min_w && p.h >= min_h && p.w > 0.0f && p.h > 0.0f) {
+                add(p.x, p.y, p.w, p.h);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Place r in the free rectangle that leaves the smallest leftover on
+ *        its shorter side (ties: longer side, then lowest, then leftmost),
+ *        in whichever orientation scores better
+ * @return false, leaving r unplaced, if it fits nowhere
+ */
+static bool maxrects_insert(MaxRectsBin& bin, PackRect& r, bool allow_rotation, float min_w, float min_h,
+                            int max_visits = INT_MAX) {
+    std::pair<float, float> s0, s1(FLT_MAX, FLT_MAX);
+    int f0 = bin.best_short_side_fit(r.w, r.h, &s0, max_visits);
+    int f1 = allow_rotation ? bin.best_short_side_fit(r.h, r.w, &s1, max_visits) : -1;
+    if (f0 < 0 && f1 < 0) return false;
+
+    r.rotated = f0 < 0 || (f1 >= 0 && s1 < s0);
+    const MaxRectsBin::Rect& free_rect = bin.rects[r.rotated ? f1 : f0];
+    r.x = free_rect.x;
+    r.y = free_rect.y;
+    bin.place(r.x, r.y, r.rotated ? r.h : r.w, r.rotated ? r.w : r.h, min_w, min_h);
+    return true;
+}
+
+/**
+ * @brief Smallest width / height still to come after each position in order
+ *
+ * min_w[k], min_h[k] cover order[k..]; index n holds FLT_MAX. Free rects
+ * smaller than this can be dropped once position k is reached.
+ */
+static void remaining_min_sizes(const std::vector<PackRect>& rects, const std::vector<int>& order,
+                                bool allow_rotation, std::vector<float>& min_w, std::vector<float>& min_h) {
+    const size_t n = order.size();
+    min_w.assign(n + 1, FLT_MAX);
+    min_h.assign(n + 1, FLT_MAX);
+    for (size_t k = n; k-- > 0;) {
+        const PackRect& r = rects[order[k]];
+        float w = allow_rotation ? min_float(r.w, r.h) : r.w;
+        float h = allow_rotation ? w : r.h;
+        min_w[k] = min_float(min_w[k + 1], w);
+        min_h[k] = min_float(min_h[k + 1], h);
+    }
+}
+
+/**
+ * @brief MaxRects packer with best short side fit (Jylänki's MAXRECTS-BSSF)
+ */
+static float pack_maxrects(std::vector<PackRect>& rects, const std::vector<int>& order,
+                           float side, bool allow_rotation) {
+    MaxRectsBin bin(side, side, (int)order.size());
+    std::vector<float> min_w, min_h;
+    remaining_min_sizes(rects, order, allow_rotation, min_w, min_h);
+
+    for (size_t k = 0; k < order.size(); k++) {
+        while (!maxrects_insert(bin, rects[order[k]], allow_rotation, min_w[k + 1], min_h[k + 1])) {
+            bin.grow(bin.bin_w * PACK_BIN_GROWTH, bin.bin_h * PACK_BIN_GROWTH);
+        }
+    }
+    return bin.bin_w;
+}
+
+/**
+ * @brief Skyline packer, bottom-left with a waste map (Jylänki's SKYLINE-BL-WM)
+ *
+ * The skyline is a linked list of segments (x, y, width) covering the bin
+ * width, with a min-heap on (y, x) to find the lowest one. A rect that fits
+ * the lowest segment's width in either orientation rests on it, at the
+ * segment's left edge, which is the lowest top any position can give. If
+ * it is too wide, no position of this rect can rest lower than the lower
+ * neighbour, so the segment is raised to that level and merged. Every
+ * raise removes a segment and every placement adds at most two, so a pass
+ * is O(n log n).
+ *
+ * The gap under a raised segment goes into a waste map, a MaxRects bin
+ * that starts empty; each rect tries it (best short side fit) before the
+ * skyline, so later, smaller rects fill the gaps.
+ */
+static float pack_skyline(std::vector<PackRect>& rects, const std::vector<int>& order,
+                          float side, bool allow_rotation) {
+    struct Segment { float x, y, w; int prev, next; bool alive; };
+    std::vector<Segment> sky;
+    sky.reserve(2 * order.size() + 8);
+    sky.push_back({0.0f, 0.0f, side, -1, -1, true});
+    int last = 0;   // rightmost segment
+
+    typedef std::pair<std::pair<float, float>, int> HeapEntry;   // ((y, x), segment)
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> lowest;
+    auto push = [&](int i) { lowest.push({{sky[i].y, sky[i].x}, i}); };
+    push(0);
+
+    // Fold next into i when both are at the same height
+    auto merge_next = [&](int i) {
+        const int n = sky[i].next;
+        if (n < 0 || sky[n].y != sky[i].y) return;
+        sky[i].w += sky[n].w;
+        sky[i].next = sky[n].next;
+        if (sky[n].next >= 0) sky[sky[n].next].prev = i;
+        else last = i;
+        sky[n].alive = false;
+    };
+    // Merge i with equal neighbours; returns the surviving segment
+    auto merge = [&](int i) {
+        merge_next(i);
+        const int p = sky[i].prev;
+        if (p >= 0 && sky[p].y == sky[i].y) {
+            merge_next(p);
+            return p;
+        }
+        return i;
+    };
+
+    MaxRectsBin waste(side, side, (int)order.size(), true);
+    std::vector<float> min_w, min_h;
+    remaining_min_sizes(rects, order, allow_rotation, min_w, min_h);
+
+    float bin_w = side, bin_h = side;
+    for (size_t k = 0; k < order.size(); k++) {
+        PackRect& r = rects[order[k]];
+        if (!waste.rects.empty() && maxrects_insert(waste, r, allow_rotation, min_w[k + 1], min_h[k + 1],
+                                                    PACK_WASTE_MAX_VISITS)) {
+            continue;
+        }
+        for (;;) {
+            // Lowest live segment; entries of raised or merged ones are stale
+            const HeapEntry top = lowest.top();
+            const int i = top.second;
+            if (!sky[i].alive || sky[i].y != top.first.first) {
+                lowest.pop();
+                continue;
+            }
+            const Segment g = sky[i];
+            const bool fit0 = r.w <= g.w && g.y + r.h <= bin_h;
+            const bool fit1 = allow_rotation && r.h <= g.w && g.y + r.w <= bin_h;
+            if (fit0 || fit1) {
+                // Of two fitting orientations the lower top wins
+                r.rotated = !fit0 || (fit1 && r.w < r.h);
+                const float w = r.rotated ? r.h : r.w;
+                r.x = g.x;
+                r.y = g.y;
+                if (w < g.w) {
+                    const int rest = (int)sky.size();
+                    sky.push_back({g.x + w, g.y, g.w - w, i, g.next, true});
+                    if (g.next >= 0) sky[g.next].prev = rest;
+                    else last = rest;
+                    sky[i].next = rest;
+                    sky[i].w = w;
+                    push(rest);
+                }
+                sky[i].y = g.y + (r.rotated ? r.w : r.h);
+                const int kept = merge(i);
+                if (kept == i) push(i);
+                break;
+            }
+
+            // Too wide here but low enough: raise to the lower neighbour.
+            // Otherwise (too tall, or one segment spans the bin) grow the bin
+            const bool raise_helps = (r.w > g.w && g.y + r.h <= bin_h) ||
+                                     (allow_rotation && r.h > g.w && g.y + r.w <= bin_h);
+            if (raise_helps && (g.prev >= 0 || g.next >= 0)) {
+                float level = FLT_MAX;
+                if (g.prev >= 0) level = min_float(level, sky[g.prev].y);
+                if (g.next >= 0) level = min_float(level, sky[g.next].y);
+                if (g.w >= min_w[k] && level - g.y >= min_h[k]) waste.add(g.x, g.y, g.w, level - g.y);
+                sky[i].y = level;
+                const int kept = merge(i);
+                if (kept == i) push(i);
+            } else {
+                const float grown_w = bin_w * PACK_BIN_GROWTH;
+                const int strip = (int)sky.size();
+                sky.push_back({bin_w, 0.0f, grown_w - bin_w, last, -1, true});
+                sky[last].next = strip;
+                last = strip;
+                bin_w = grown_w;
+                bin_h *= PACK_BIN_GROWTH;
+                const int kept = merge(strip);
+                if (kept == strip) push(strip);
+            }
+        }
+    }
+    return bin_w;
+}
+
+/** Coarsest raster level; finer levels double the resolution up to the cap */
+static const int RASTER_MIN_RESOLUTION = 64;
+/** Default finest raster level (atlas side in pixels); 512 stays up to a
+ *  point short of 75% coverage on L shapes and frames */
+static const int RASTER_DEFAULT_RESOLUTION = 1024;
+/** Fill density assumed when sizing the coarsest raster atlas; finer levels
+ *  use the density the previous level reached */
+static const float RASTER_INITIAL_DENSITY = 0.85f;
+/** Finest-level extents differing by more than this fraction of the side
+ *  are repacked at a squaring strip width, up to RASTER_SQUARE_ATTEMPTS times */
+static const float RASTER_SQUARE_TOLERANCE = 0.01f;
+static const int RASTER_SQUARE_ATTEMPTS = 2;
+/** Candidate positions below which a row search stays on the calling thread */
+static const long long RASTER_PARALLEL_MIN_POSITIONS = 1 << 18;
+
+static inline int count_trailing_zeros64(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+static inline int popcount64(uint64_t x) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+/**
+ * @brief dst |= src << s over a row of 64-bit words (pixel 64k + b is bit b
+ *        of word k); dst may alias src
+ */
+static void or_shifted_row(uint64_t* dst, const uint64_t* src, int words, int s) {
+    const int ws = s >> 6, bs = s & 63;
+    for (int k = words - 1; k >= ws; k--) {
+        uint64_t v = src[k - ws] << bs;
+        if (bs && k - ws - 1 >= 0) v |= src[k - ws - 1] >> (64 - bs);
+        dst[k] |= v;
+    }
+}
+
+/**
+ * @brief dst &= src >> s over a row of 64-bit words, bits past the end
+ *        reading as 0; dst may alias src
+ */
+static void and_shifted_row(uint64_t* dst, const uint64_t* src, int words, int s) {
+    const int ws = s >> 6, bs = s & 63;
+    for (int k = 0; k < words; k++) {
+        const uint64_t lo = k + ws < words ? src[k + ws] : 0;
+        const uint64_t hi = k + ws + 1 < words ? src[k + ws + 1] : 0;
+        dst[k] &= bs ? (lo >> bs) | (hi << (64 - bs)) : lo;
+    }
+}
+
+/**
+ * @brief One island silhouette: w x h pixels, row-major, `words` words per row
+ */
+struct RasterMask {
+    int w = 0, h = 0, words = 0;
+    // Longest run of set pixels in the bottom, middle and top rows: a
+    // position is only tested in full if those runs all land on free runs
+    struct Probe { int row, start, length; };
+    std::vector<Probe> probes;
+    std::vector<uint64_t> bits;
+
+    const uint64_t* row(int r) const { return &bits[(size_t)r * words]; }
+};
+
+/**
+ * @brief Rasterise one island, conservatively: every pixel a triangle
+ *        touches is set, then the mask is dilated by `dilate` pixels
+ *        towards +x and +y
+ *
+ * The frame matches the placement transform of pack_uv_islands_ex: pixel
+ * (0, 0) starts at the island's bounding-box corner, and a rotated island
+ * is rasterised turned 90° counter-clockwise. Two masks dilated this way
+ * and placed without overlap keep their silhouettes `dilate` pixels apart.
+ */
+static void rasterize_island(const Mesh* mesh, const int* faces, int num_faces,
+                             const Island& isl, bool rotated, float px, int dilate,
+                             RasterMask* mask) {
+    const float bw = rotated ? isl.height : isl.width;
+    const float bh = rotated ? isl.width : isl.height;
+    const int w0 = (int)floorf(bw / px) + 1;
+    const int h0 = (int)floorf(bh / px) + 1;
+    mask->w = w0 + dilate;
+    mask->h = h0 + dilate;
+    mask->words = (mask->w + 63) / 64;
+    mask->bits.assign((size_t)mask->h * mask->words, 0);
+    uint64_t* bits = mask->bits.data();
+    const int words = mask->words;
+    auto set = [&](int x, int y) { bits[(size_t)y * words + (x >> 6)] |= 1ull << (x & 63); };
+    auto is_set = [&](int x, int y) { return (bits[(size_t)y * words + (x >> 6)] >> (x & 63) & 1) != 0; };
+
+    for (int k = 0; k < num_faces; k++) {
+        const int f = faces[k];
+        if (!face_corners_valid(mesh, f)) continue;
+        float p[3][2];
+        for (int j = 0; j < 3; j++) {
+            const float u = mesh->uvs[2 * mesh->triangles[3*f + j]];
+            const float v = mesh->uvs[2 * mesh->triangles[3*f + j] + 1];
+            p[j][0] = (rotated ? isl.max_v - v : u - isl.min_u) / px;
+            p[j][1] = (rotated ? u - isl.min_u : v - isl.min_v) / px;
+            // Corners always count, so slivers are never lost
+            set(std::min(w0 - 1, std::max(0, (int)p[j][0])), std::min(h0 - 1, std::max(0, (int)p[j][1])));
+        }
+        float area = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[2][0] - p[0][0]) * (p[1][1] - p[0][1]);
+        if (area == 0.0f) continue;
+        if (area < 0.0f) std::swap(p[1], p[2]);
+
+        const int x0 = std::max(0, (int)floorf(std::min(p[0][0], std::min(p[1][0], p[2][0]))));
+        const int x1 = std::min(w0 - 1, (int)floorf(std::max(p[0][0], std::max(p[1][0], p[2][0]))));
+        const int y0 = std::max(0, (int)floorf(std::min(p[0][1], std::min(p[1][1], p[2][1]))));
+        const int y1 = std::min(h0 - 1, (int)floorf(std::max(p[0][1], std::max(p[1][1], p[2][1]))));
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                // The pixel square overlaps the triangle unless it lies wholly
+                // outside one edge; test the corner furthest inside each edge
+                bool overlaps = true;
+                for (int e = 0; e < 3 && overlaps; e++) {
+                    const float* a = p[e];
+                    const float* b = p[(e + 1) % 3];
+                    const float dx = b[0] - a[0], dy = b[1] - a[1];
+                    const float cx = dy <= 0.0f ? (float)(x + 1) : (float)x;
+                    const float cy = dx >= 0.0f ? (float)(y + 1) : (float)y;
+                    overlaps = dx * (cy - a[1]) - dy * (cx - a[0]) >= -1e-4f;
+                }
+                if (overlaps) set(x, y);
+            }
+        }
+    }
+
+    // Dilate by shift-and-or, doubling the covered offsets each pass
+    for (int covered = 0; covered < dilate;) {
+        const int s = std::min(covered + 1, dilate - covered);
+        for (int y = 0; y < mask->h; y++) or_shifted_row(bits + (size_t)y * words, bits + (size_t)y * words, words, s);
+        covered += s;
+    }
+    for (int covered = 0; covered < dilate;) {
+        const int s = std::min(covered + 1, dilate - covered);
+        for (int y = mask->h - 1; y >= s; y--) {
+            for (int k = 0; k < words; k++) bits[(size_t)y * words + k] |= bits[(size_t)(y - s) * words + k];
+        }
+        covered += s;
+    }
+
+    mask->probes.clear();
+    const int probe_rows[3] = {0, mask->h / 2, mask->h - 1};
+    for (int p = 0; p < 3; p++) {
+        const int y = probe_rows[p];
+        if (p > 0 && y == probe_rows[p - 1]) continue;
+        RasterMask::Probe best = {y, 0, 0};
+        for (int x = 0; x < mask->w;) {
+            if (!is_set(x, y)) { x++; continue; }
+            int end = x;
+            while (end < mask->w && is_set(end, y)) end++;
+            if (end - x > best.length) best = {y, x, end - x};
+            x = end;
+        }
+        if (best.length > 0) mask->probes.push_back(best);
+    }
+}
+
+/**
+ * @brief Longest run of clear bits in a row of words
+ */
+static int longest_clear_run(const uint64_t* a, int words) {
+    int best = 0, cur = 0;
+    for (int k = 0; k < words; k++) {
+        const uint64_t f = ~a[k];
+        if (f == ~0ull) { cur += 64; continue; }
+        for (int pos = 0; pos < 64;) {
+            const uint64_t rest = f >> pos;
+            if (rest & 1) {
+                const int len = std::min(64 - pos, count_trailing_zeros64(~rest));
+                cur += len;
+                pos += len;
+            } else {
+                best = std::max(best, cur);
+                cur = 0;
+                if (!rest) break;
+                pos += count_trailing_zeros64(rest);
+            }
+        }
+    }
+    return std::max(best, cur);
+}
+
+/**
+ * @brief Fixed-width, growing-height occupancy bitmap
+ *
+ * Bits past the width are set, so full rows are all ones and the free-pixel
+ * scan never reports a column outside the atlas. Each row keeps its longest
+ * free run, so rows too fragmented for a mask are skipped without a scan.
+ */
+struct RasterAtlas {
+    int w, words;
+    int first_open = 0;             // lowest row with a free pixel
+    std::vector<uint64_t> bits;
+    std::vector<int> max_run;       // longest free run per row
+
+    explicit RasterAtlas(int width) : w(width), words((width + 63) / 64) {}
+
+    int rows() const { return (int)(bits.size() / words); }
+    const uint64_t* row(int r) const { return &bits[(size_t)r * words]; }
+
+    void ensure_rows(int h) {
+        while (rows() < h) {
+            bits.resize(bits.size() + words, 0);
+            if (w & 63) bits.back() = ~0ull << (w & 63);
+            max_run.push_back(w);
+        }
+    }
+
+    /** True if mask placed with its corner at (x, y) overlaps nothing */
+    bool fits(const RasterMask& m, int x, int y) const {
+        const int w0 = x >> 6, s = x & 63;
+        const int r_end = std::min(m.h, rows() - y);   // rows above the atlas are empty
+        for (int r = 0; r < r_end; r++) {
+            const uint64_t* a = row(y + r) + w0;
+            const uint64_t* b = m.row(r);
+            for (int k = 0; k < m.words; k++) {
+                if (!b[k]) continue;
+                if (a[k] & (b[k] << s)) return false;
+                const uint64_t spill = s ? b[k] >> (64 - s) : 0;
+                if (spill && (a[k + 1] & spill)) return false;
+            }
+        }
+        return true;
+    }
+
+    void stamp(const RasterMask& m, int x, int y) {
+        ensure_rows(y + m.h);
+        const int w0 = x >> 6, s = x & 63;
+        for (int r = 0; r < m.h; r++) {
+            uint64_t* a = &bits[(size_t)(y + r) * words] + w0;
+            const uint64_t* b = m.row(r);
+            for (int k = 0; k < m.words; k++) {
+                a[k] |= b[k] << s;
+                const uint64_t spill = s ? b[k] >> (64 - s) : 0;
+                if (spill) a[k + 1] |= spill;
+            }
+            max_run[y + r] = longest_clear_run(row(y + r), words);
+        }
+        while (first_open < rows()) {
+            const uint64_t* a = row(first_open);
+            bool full = true;
+            for (int k = 0; k < words && full; k++) full = a[k] == ~0ull;
+            if (!full) break;
+            first_open++;
+        }
+    }
+
+    /**
+     * @brief First free x in row y for m (lowest x), or -1
+     *
+     * Candidate columns come a word at a time from the probes: the free
+     * pixels of each probed atlas row are eroded by the probe's run length
+     * (halving the remaining length per shift-and), so a set bit marks the
+     * start of a free run long enough, then shifted to the mask origin.
+     * Only the surviving columns get the full test. `scratch` holds two
+     * rows of words.
+     */
+    int first_fit_in_row(const RasterMask& m, int y, std::vector<uint64_t>& scratch) const {
+        if (y >= rows()) return 0;
+        for (const RasterMask::Probe& p : m.probes) {
+            if (y + p.row < rows() && max_run[y + p.row] < p.length) return -1;
+        }
+        scratch.resize(2 * (size_t)words);
+        uint64_t* cand = scratch.data();
+        uint64_t* run = cand + words;
+
+        // Columns 0 .. w - m.w
+        const int last = w - m.w;
+        for (int k = 0; k < words; k++) {
+            const int lo = 64 * k;
+            cand[k] = lo > last ? 0 : last - lo >= 63 ? ~0ull : (~0ull >> (63 - (last - lo)));
+        }
+        for (const RasterMask::Probe& p : m.probes) {
+            if (y + p.row >= rows()) continue;   // empty row: no constraint
+            const uint64_t* a = row(y + p.row);
+            for (int k = 0; k < words; k++) run[k] = ~a[k];
+            for (int covered = 1; covered < p.length;) {
+                const int s = std::min(covered, p.length - covered);
+                and_shifted_row(run, run, words, s);
+                covered += s;
+            }
+            and_shifted_row(cand, run, words, p.start);
+        }
+
+        for (int k = 0; k < words; k++) {
+            for (uint64_t bits = cand[k]; bits; bits &= bits - 1) {
+                const int x = 64 * k + count_trailing_zeros64(bits);
+                if (fits(m, x, y)) return x;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Bottom-left first fit: lowest row, then lowest x
+     *
+     * A row at or above the current top always fits, so this never fails
+     * for a mask no wider than the atlas. Rows are dealt to threads
+     * round-robin; each thread stops past the lowest hit so far, and the
+     * lowest row wins, so the result does not depend on the thread count.
+     */
+    void find(const RasterMask& m, int num_threads, int* x_out, int* y_out) const {
+        const int y_end = rows();
+        const long long positions = (long long)(y_end - first_open) * (w - m.w + 1);
+        std::vector<std::vector<uint64_t>> scratch(num_threads);
+        if (num_threads <= 1 || positions < RASTER_PARALLEL_MIN_POSITIONS) {
+            for (int y = first_open; y <= y_end; y++) {
+                int x = first_fit_in_row(m, y, scratch[0]);
+                if (x >= 0) { *x_out = x; *y_out = y; return; }
+            }
+        }
+
+        std::atomic<int> best_y(y_end);
+        std::vector<int> hit_x(num_threads, -1), hit_y(num_threads, INT_MAX);
+        parallel_for_chunks(num_threads, (size_t)num_threads, [&](int, size_t b, size_t e) {
+            for (size_t t = b; t < e; t++) {
+                for (int y = first_open + (int)t; y <= best_y.load(std::memory_order_relaxed); y += num_threads) {
+                    int x = first_fit_in_row(m, y, scratch[t]);
+                    if (x < 0) continue;
+                    hit_x[t] = x;
+                    hit_y[t] = y;
+                    int seen = best_y.load();
+                    while (y < seen && !best_y.compare_exchange_weak(seen, y)) {}
+                    break;
+                }
+            }
+        });
+        *x_out = 0;
+        *y_out = y_end;
+        for (int t = 0; t < num_threads; t++) {
+            if (hit_y[t] < *y_out) { *x_out = hit_x[t]; *y_out = hit_y[t]; }
+        }
+    }
+};
+
+/**
+ * @brief Raster packer: bottom-left fill on rasterised island silhouettes
+ *
+ * Each level rasterises the islands (both orientations with rotation) at a
+ * pixel size giving an atlas about `resolution` pixels wide and packs them
+ * in order into a strip of that width. Levels run coarse to fine, from
+ * RASTER_MIN_RESOLUTION up to max_resolution, doubling each time; a finer
+ * level starts only if its predicted time (the last level's times the
+ * growth of the previous step) fits the budget. The level with the smallest
+ * square extent wins, setting target_x, target_y and rotated of the
+ * islands in order and its extent without the trailing margin.
+ */
+static void pack_raster(const Mesh* mesh, const std::vector<int>& face_offsets,
+                        const std::vector<int>& faces, std::vector<Island>& islands,
+                        const std::vector<int>& order, float margin, bool allow_rotation,
+                        int max_resolution, double time_budget, int num_threads,
+                        float* extent_w, float* extent_h) {
+    const double t_start = seconds_now();
+
+    // Silhouette area sets the pixel size of each level
+    double area = 0.0;
+    for (int i : order) {
+        for (int k = face_offsets[i]; k < face_offsets[i + 1]; k++) {
+            if (!face_corners_valid(mesh, faces[k])) continue;
+            const int* t = mesh->triangles + 3 * faces[k];
+            const float* a = mesh->uvs + 2 * t[0];
+            const float* b = mesh->uvs + 2 * t[1];
+            const float* c = mesh->uvs + 2 * t[2];
+            area += 0.5 * fabs((double)(b[0] - a[0]) * (c[1] - a[1]) - (double)(c[0] - a[0]) * (b[1] - a[1]));
+        }
+    }
+    if (area <= 0.0) area = 1.0;
+
+    std::vector<RasterMask> masks(2 * islands.size());
+    float best_extent = FLT_MAX;
+    double density = RASTER_INITIAL_DENSITY;
+    double last_seconds = 0.0, growth = 0.0;
+    int levels = 0;
+
+    for (int resolution = std::min(RASTER_MIN_RESOLUTION, max_resolution);; resolution *= 2) {
+        const double t_level = seconds_now();
+        const float px = (float)sqrt(area / RASTER_INITIAL_DENSITY) / (float)resolution;
+        const int dilate = margin > 0.0f ? (int)ceilf(margin / px) : 0;
+
+        // Rasterise; the atlas is as wide as a square at the expected density,
+        // and at least as wide as every island in its narrower allowed orientation
+        long long pixels = 0;
+        int min_width = 1;
+        for (int i : order) {
+            const int* f = faces.data() + face_offsets[i];
+            const int n = face_offsets[i + 1] - face_offsets[i];
+            rasterize_island(mesh, f, n, islands[i], false, px, dilate, &masks[2*i]);
+            if (allow_rotation) rasterize_island(mesh, f, n, islands[i], true, px, dilate, &masks[2*i + 1]);
+            for (uint64_t word : masks[2*i].bits) pixels += popcount64(word);
+            min_width = std::max(min_width, allow_rotation ? std::min(masks[2*i].w, masks[2*i + 1].w)
+                                                           : masks[2*i].w);
+        }
+        const int width = std::max(min_width, (int)ceil(sqrt((double)pixels / density)));
+
+        // Pack into a strip `strip` pixels wide; keep the layout if its
+        // square extent is the smallest so far. Returns the fill density
+        auto pack_strip = [&](int strip, float* level_w, float* level_h) {
+            RasterAtlas atlas(strip);
+            std::vector<int> x(islands.size()), y(islands.size());
+            std::vector<char> r(islands.size(), 0);
+            for (int i : order) {
+                int best_top = INT_MAX;
+                for (int o = 0; o < (allow_rotation ? 2 : 1); o++) {
+                    const RasterMask& m = masks[2*i + o];
+                    if (m.w > strip) continue;
+                    int mx, my;
+                    atlas.find(m, num_threads, &mx, &my);
+                    if (my + m.h < best_top) {
+                        best_top = my + m.h;
+                        x[i] = mx; y[i] = my; r[i] = (char)o;
+                    }
+                }
+                atlas.stamp(masks[2*i + r[i]], x[i], y[i]);
+            }
+
+            // Extent without the trailing margin, in island units
+            *level_w = 0.0f;
+            *level_h = 0.0f;
+            for (int i : order) {
+                *level_w = max_float(*level_w, x[i] * px + (r[i] ? islands[i].height : islands[i].width));
+                *level_h = max_float(*level_h, y[i] * px + (r[i] ? islands[i].width : islands[i].height));
+            }
+            if (max_float(*level_w, *level_h) < best_extent) {
+                best_extent = max_float(*level_w, *level_h);
+                *extent_w = *level_w;
+                *extent_h = *level_h;
+                for (int i : order) {
+                    islands[i].target_x = x[i] * px;
+                    islands[i].target_y = y[i] * px;
+                    islands[i].rotated = r[i] != 0;
+                }
+            }
+            return (double)pixels / ((double)strip * atlas.rows());
+        };
+
+        const double t_pack = seconds_now();
+        float level_w, level_h;
+        density = pack_strip(width, &level_w, &level_h);
+        const double pack_seconds = seconds_now() - t_pack;
+        levels++;
+
+        const double seconds = seconds_now() - t_level;
+        if (last_seconds > 0.0) growth = seconds / last_seconds;
+        last_seconds = seconds;
+        printf("  raster %d: %d px wide, pixel %.4g, extent %.4f x %.4f, %.1f ms\n",
+               resolution, width, px, level_w, level_h, seconds * 1000.0);
+
+        if (resolution * 2 > max_resolution) {
+            // An oblong finest layout wastes part of the square it is scaled
+            // into. Repack at the width that would have squared it, then at
+            // the secant estimate from the two layouts, while it helps and
+            // the budget allows
+            int strip = width, prev_strip = 0;
+            float diff = level_h - level_w, prev_diff = 0.0f;
+            for (int attempt = 0; attempt < RASTER_SQUARE_ATTEMPTS; attempt++) {
+                if (fabsf(diff) <= RASTER_SQUARE_TOLERANCE * best_extent) break;
+                if (time_budget > 0.0 && seconds_now() - t_start + pack_seconds > time_budget) break;
+                int next = attempt == 0 || diff == prev_diff
+                         ? (int)ceil(strip * sqrt((double)(level_w + diff) / level_w))
+                         : (int)lround(strip - diff * (strip - prev_strip) / (diff - prev_diff));
+                next = std::max(min_width, next);
+                if (next == strip || next == prev_strip) break;
+                prev_strip = strip;
+                prev_diff = diff;
+                strip = next;
+                pack_strip(strip, &level_w, &level_h);
+                diff = level_h - level_w;
+                printf("  raster %d: %d px wide, extent %.4f x %.4f\n", resolution, strip, level_w, level_h);
+            }
+            break;
+        }
+        // Without a previous step, assume each doubling costs 8x
+        const double predicted = seconds * (growth > 0.0 ? growth : 8.0);
+        if (time_budget > 0.0 && seconds_now() - t_start + predicted > time_budget) break;
+    }
+    printf("  %d raster level%s\n", levels, levels == 1 ? "" : "s");
+}
+
+/**
+ * @brief Island of every vertex (-1 if unused)
+ *
+ * A vertex on a seam is listed by faces of several islands but carries one
+ * UV, so it must move with the island that UV came from. unwrap_mesh
+ * records that island in vertex_island_ids; results built without it use
+ * the same rule unwrap_mesh applies when every island is solved: the
+ * highest-numbered island among the vertex's faces.
+ */
+static void assign_vertex_islands(const Mesh* mesh, const UnwrapResult* result,
+                                  std::vector<int>& vert_island) {
+    if (result->vertex_island_ids) {
+        vert_island.assign(result->vertex_island_ids, result->vertex_island_ids + mesh->num_vertices);
+        return;
+    }
+
+    const int* face_ids = result->face_island_ids;
+    vert_island.assign(mesh->num_vertices, -1);
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        int isl_id = face_ids[f];
+        if (isl_id < 0) continue;
+        for(int j=0; j<3; j++) {
+            int v = mesh->triangles[3*f+j];
+            if (v < 0 || v >= mesh->num_vertices) continue;
+            vert_island[v] = std::max(vert_island[v], isl_id);
+        }
+    }
+}
+
+/**
+ * @brief Convex hull, counter-clockwise without collinear points (Andrew's
+ *        monotone chain); sorts pts
+ */
+static void convex_hull(std::vector<std::pair<float, float>>& pts,
+                        std::vector<std::pair<float, float>>& hull) {
+    std::sort(pts.begin(), pts.end());
+    pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+    hull.clear();
+    if (pts.size() < 3) {
+        hull = pts;
+        return;
+    }
+
+    auto cross = [](const std::pair<float, float>& o, const std::pair<float, float>& a,
+                    const std::pair<float, float>& b) {
+        return ((double)a.first - o.first) * ((double)b.second - o.second) -
+               ((double)a.second - o.second) * ((double)b.first - o.first);
+    };
+    hull.resize(2 * pts.size());
+    size_t k = 0;
+    for (size_t i = 0; i < pts.size(); i++) {                 // lower chain
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0.0) k--;
+        hull[k++] = pts[i];
+    }
+    for (size_t i = pts.size() - 1, lower = k + 1; i-- > 0;) {   // upper chain
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0.0) k--;
+        hull[k++] = pts[i];
+    }
+    hull.resize(k - 1);   // last point repeats the first
+}
+
+/**
+ * @brief Minimum-area enclosing rectangle of a convex polygon (rotating
+ *        calipers)
+ *
+ * One side of the optimum lies on a hull edge. For each edge in turn, the
+ * points furthest along it, furthest from it and furthest back only move
+ * forward around the hull, so the sweep is O(hull).
+ *
+ * @param angle_out Direction of that side, in radians
+ * @return Rectangle area
+ */
+static double min_area_rect(const std::vector<std::pair<float, float>>& hull, double* angle_out) {
+    const int n = (int)hull.size();
+    *angle_out = 0.0;
+    if (n < 3) {
+        if (n == 2) *angle_out = atan2((double)hull[1].second - hull[0].second, (double)hull[1].first - hull[0].first);
+        return 0.0;
+    }
+
+    auto dot = [&](int i, double dx, double dy) { return hull[i].first * dx + hull[i].second * dy; };
+    double best = DBL_MAX;
+    int right = 0, top = 0, left = 0;
+    for (int i = 0; i < n; i++) {
+        const int j = (i + 1) % n;
+        double ex = (double)hull[j].first - hull[i].first;
+        double ey = (double)hull[j].second - hull[i].second;
+        const double len = sqrt(ex * ex + ey * ey);
+        if (len == 0.0) continue;
+        ex /= len;
+        ey /= len;
+        // Inward normal of a counter-clockwise edge: (-ey, ex)
+
+        if (i == 0) right = j;
+        while (dot((right + 1) % n, ex, ey) > dot(right, ex, ey)) right = (right + 1) % n;
+        if (i == 0) top = right;
+        while (dot((top + 1) % n, -ey, ex) > dot(top, -ey, ex)) top = (top + 1) % n;
+        if (i == 0) left = top;
+        while (dot((left + 1) % n, ex, ey) < dot(left, ex, ey)) left = (left + 1) % n;
+
+        const double width = dot(right, ex, ey) - dot(left, ex, ey);
+        const double height = dot(top, -ey, ex) - dot(i, -ey, ex);
+        if (width * height < best) {
+            best = width * height;
+            *angle_out = atan2(ey, ex);
+        }
+    }
+    return best;
+}
+
+float orient_uv_islands(Mesh* mesh, const UnwrapResult* result, const PackOptions* options) {
+    if (!mesh || !result || !mesh->uvs || result->num_islands <= 1) return 0.0f;
+
+    const int num_islands = result->num_islands;
+
+    // Vertices grouped by island (counting sort)
+    std::vector<int> vert_island;
+    assign_vertex_islands(mesh, result, vert_island);
+    std::vector<int> offsets(num_islands + 1, 0), verts;
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        if (vert_island[v] >= 0) offsets[vert_island[v] + 1]++;
+    }
+    for (int i = 0; i < num_islands; i++) offsets[i + 1] += offsets[i];
+    verts.resize(offsets[num_islands]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        if (vert_island[v] >= 0) verts[fill[vert_island[v]]++] = v;
+    }
+
+    std::vector<double> area_before(num_islands, 0.0), area_after(num_islands, 0.0);
+    const int num_threads = limit_thread_count(resolve_thread_count(options ? options->num_threads : 0),
+                                               (size_t)num_islands, 64);
+    parallel_for_chunks(num_threads, (size_t)num_islands, [&](int, size_t begin, size_t end) {
+        std::vector<std::pair<float, float>> pts, hull;
+        for (size_t i = begin; i < end; i++) {
+            const int* iv = verts.data() + offsets[i];
+            const int n = offsets[i + 1] - offsets[i];
+            if (n == 0) continue;
+
+            pts.resize(n);
+            float min_u = FLT_MAX, max_u = -FLT_MAX, min_v = FLT_MAX, max_v = -FLT_MAX;
+            for (int k = 0; k < n; k++) {
+                pts[k] = {mesh->uvs[2 * iv[k]], mesh->uvs[2 * iv[k] + 1]};
+                min_u = min_float(min_u, pts[k].first);
+                max_u = max_float(max_u, pts[k].first);
+                min_v = min_float(min_v, pts[k].second);
+                max_v = max_float(max_v, pts[k].second);
+            }
+            area_before[i] = area_after[i] = ((double)max_u - min_u) * ((double)max_v - min_v);
+
+            convex_hull(pts, hull);
+            double angle;
+            const double area = min_area_rect(hull, &angle);
+            if (!(area < area_before[i] * (1.0 - 1e-4))) continue;
+
+            // Turn by the smallest angle that puts the rectangle on the axes
+            const double quarter = 0.5 * M_PI;
+            angle -= quarter * floor(angle / quarter + 0.5);
+            const double c = cos(angle), s = sin(angle);
+            for (int k = 0; k < n; k++) {
+                float* uv = mesh->uvs + 2 * iv[k];
+                const double u = uv[0], v = uv[1];
+                uv[0] = (float)(c * u + s * v);
+                uv[1] = (float)(-s * u + c * v);
+            }
+            area_after[i] = area;
+        }
+    });
+
+    double before = 0.0, after = 0.0;
+    for (int i = 0; i < num_islands; i++) {
+        before += area_before[i];
+        after += area_after[i];
+    }
+    const float saved = before > 0.0 ? (float)((before - after) / before) : 0.0f;
+    printf("Oriented %d islands: bounding boxes %.1f%% smaller\n", num_islands, 100.0f * saved);
+    return saved;
+}
+
+/** UDIM mode: tiles per row along u, as in the UDIM numbering (1001 + u + 10 v) */
+static const int UDIM_TILES_PER_ROW = 10;
+/** UDIM mode: tile side in texels when tile_resolution is 0 */
+static const int UDIM_DEFAULT_TILE_RESOLUTION = 1024;
+/** UDIM mode: footprint area dealt to each fresh tile, as a fraction of the tile.
+ *  MaxRects never reaches it, but what spills over fills the earlier tiles;
+ *  lower values leave every tile that much emptier */
+static const double UDIM_TILE_FILL = 1.0;
+/** UDIM mode: longest footprint side of a shrunk island, so rounding cannot push it past the tile */
+static const float UDIM_FIT_SLACK = 0.999f;
+
+/**
+ * @brief 3D area, UV area and UV bounds of every island
+ */
+struct IslandMeasures {
+    std::vector<double> area_3d, area_uv;
+    std::vector<float> min_u, max_u, min_v, max_v;
 };
 
+/**
+ * @brief Measure every island in one pass over its faces
+ *
+ * 3D face areas come from compute_face_geometry's SoA buffer (AVX2 / NEON
+ * kernel) and do not depend on the UVs; UV areas and bounds are summed per
+ * face. Faces with out-of-range corners add nothing, and islands made only
+ * of them keep empty bounds. With the island→faces index each island is a
+ * contiguous run of faces summed into locals, and islands are split across
+ * threads; otherwise one serial pass scatters by face_island_ids.
+ */
+static void measure_islands(const Mesh* mesh, const UnwrapResult* result, int num_threads,
+                            IslandMeasures* m) {
+    const int num_islands = result->num_islands;
+    m->area_3d.assign(num_islands, 0.0);
+    m->area_uv.assign(num_islands, 0.0);
+    m->min_u.assign(num_islands, FLT_MAX);
+    m->max_u.assign(num_islands, -FLT_MAX);
+    m->min_v.assign(num_islands, FLT_MAX);
+    m->max_v.assign(num_islands, -FLT_MAX);
+
+    // Without the buffers (allocation failure) 3D areas stay zero, which
+    // makes every island unmeasurable instead of guessing
+    FaceGeometry* geom = compute_face_geometry(mesh);
+    const float* face_area = geom ? geom->area : NULL;
+
+    const int* tris = mesh->triangles;
+    const float* uvs = mesh->uvs;
+    auto add_face = [&](int f, double* a3, double* auv, float* bounds) {
+        if (!face_corners_valid(mesh, f)) return;
+        if (face_area) *a3 += face_area[f];
+
+        const int i0 = tris[3*f], i1 = tris[3*f + 1], i2 = tris[3*f + 2];
+        const float u0 = uvs[2*i0], v0 = uvs[2*i0 + 1];
+        const float u1 = uvs[2*i1], v1 = uvs[2*i1 + 1];
+        const float u2 = uvs[2*i2], v2 = uvs[2*i2 + 1];
+        *auv += 0.5 * fabs(((double)u1 - u0) * ((double)v2 - v0) - ((double)v1 - v0) * ((double)u2 - u0));
+        bounds[0] = std::min(bounds[0], std::min(u0, std::min(u1, u2)));
+        bounds[1] = std::max(bounds[1], std::max(u0, std::max(u1, u2)));
+        bounds[2] = std::min(bounds[2], std::min(v0, std::min(v1, v2)));
+        bounds[3] = std::max(bounds[3], std::max(v0, std::max(v1, v2)));
+    };
+
+    if (result->island_face_offsets && result->island_faces) {
+        num_threads = limit_thread_count(num_threads, (size_t)num_islands, 64);
+        parallel_for_chunks(num_threads, (size_t)num_islands, [&](int, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                double a3 = 0.0, auv = 0.0;
+                float bounds[4] = {FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
+                for (int k = result->island_face_offsets[i]; k < result->island_face_offsets[i + 1]; k++) {
+                    add_face(result->island_faces[k], &a3, &auv, bounds);
+                }
+                m->area_3d[i] = a3;
+                m->area_uv[i] = auv;
+                m->min_u[i] = bounds[0];
+                m->max_u[i] = bounds[1];
+                m->min_v[i] = bounds[2];
+                m->max_v[i] = bounds[3];
+            }
+        });
+    } else {
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            const int i = result->face_island_ids[f];
+            if (i < 0 || i >= num_islands) continue;
+            float bounds[4] = {m->min_u[i], m->max_u[i], m->min_v[i], m->max_v[i]};
+            add_face(f, &m->area_3d[i], &m->area_uv[i], bounds);
+            m->min_u[i] = bounds[0];
+            m->max_u[i] = bounds[1];
+            m->min_v[i] = bounds[2];
+            m->max_v[i] = bounds[3];
+        }
+    }
+    free_face_geometry(geom);
+}
+
+/**
+ * @brief Scale each island about the origin to uv_per_unit UV units per
+ *        mesh unit (by area), shrinking any whose longest side would
+ *        exceed max_side
+ * @param spread_out Optional output: largest over smallest island density
+ *                   before scaling (1 if fewer than two islands have area)
+ * @return Number of islands shrunk
+ */
+static int scale_to_texel_density(Mesh* mesh, const UnwrapResult* result, float uv_per_unit, float max_side, int num_threads,
+                                  float* spread_out) {
+    const int num_islands = result->num_islands;
+    IslandMeasures m;
+    measure_islands(mesh, result, num_threads, &m);
+
+    std::vector<float> scale(num_islands, 1.0f);
+    double min_density = DBL_MAX, max_density = 0.0;
+    int shrunk = 0;
+    for (int i = 0; i < num_islands; i++) {
+        if (!(m.area_uv[i] > 0.0)) continue;
+        float s = 1.0f;
+        if (m.area_3d[i] > 0.0) {
+            const double density = sqrt(m.area_uv[i] / m.area_3d[i]);
+            min_density = std::min(min_density, density);
+            max_density = std::max(max_density, density);
+            s = (float)(uv_per_unit / density);
+        }
+        const float longest = max_float(m.max_u[i] - m.min_u[i], m.max_v[i] - m.min_v[i]) * s;
+        if (longest > max_side && max_side > 0.0f) {
+            s *= max_side / longest;
+            shrunk++;
+        }
+        scale[i] = s;
+    }
+    if (spread_out) *spread_out = max_density > min_density ? (float)(max_density / min_density) : 1.0f;
+
+    std::vector<int> vert_island;
+    assign_vertex_islands(mesh, result, vert_island);
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        if (vert_island[v] < 0) continue;
+        mesh->uvs[2 * v] *= scale[vert_island[v]];
+        mesh->uvs[2 * v + 1] *= scale[vert_island[v]];
+    }
+    return shrunk;
+}
+
+float equalize_texel_density(Mesh* mesh, const UnwrapResult* result, const PackOptions* options) {
+    if (!mesh || !result || !mesh->uvs || !mesh->vertices || result->num_islands <= 1) return 1.0f;
+
+    float spread = 1.0f;
+    scale_to_texel_density(mesh, result, 1.0f, FLT_MAX,
+                           resolve_thread_count(options ? options->num_threads : 0), &spread);
+    printf("Equalized texel density of %d islands (spread was %.1fx)\n", result->num_islands, spread);
+    return spread;
+}
+
+/**
+ * @brief UDIM mode: bin-pack footprints into unit tiles
+ *
+ * Each round deals the pending rects (in order) first-fit by area into
+ * fresh tiles, up to UDIM_TILE_FILL of a tile each, then packs those tiles
+ * in parallel, each with its own MaxRects bin. Rects a tile could not take try every
+ * tile so far, in order; what is left starts the next round. The first
+ * rect of a fresh tile always lands, so every round makes progress.
+ *
+ * @param rect_tile Output: tile of each rect (positions are within the tile)
+ * @return Number of tiles
+ */
+static int pack_udim_tiles(std::vector<PackRect>& rects, const std::vector<int>& order,
+                           bool allow_rotation, int num_threads, std::vector<int>& rect_tile) {
+    std::vector<MaxRectsBin> bins;
+    std::vector<int> pending(order), next;
+    rect_tile.assign(rects.size(), -1);
+
+    while (!pending.empty()) {
+        std::vector<double> load;
+        std::vector<std::vector<int>> tile_rects;
+        for (int k : pending) {
+            const double area = (double)rects[k].w * rects[k].h;
+            size_t t = 0;
+            while (t < load.size() && load[t] + area > UDIM_TILE_FILL) t++;
+            if (t == load.size()) {
+                load.push_back(0.0);
+                tile_rects.emplace_back();
+            }
+            load[t] += area;
+            tile_rects[t].push_back(k);
+        }
+
+        const int first = (int)bins.size();
+        std::vector<int> tiles(tile_rects.size());
+        for (size_t t = 0; t < tile_rects.size(); t++) {
+            bins.emplace_back(1.0f, 1.0f, (int)tile_rects[t].size());
+            tiles[t] = (int)t;
+        }
+        parallel_for_work_stealing(num_threads, tiles, [&](int, int t) {
+            MaxRectsBin& bin = bins[first + t];
+            for (size_t j = 0; j < tile_rects[t].size(); j++) {
+                PackRect& r = rects[tile_rects[t][j]];
+                if (maxrects_insert(bin, r, allow_rotation, 0.0f, 0.0f)) {
+                    rect_tile[tile_rects[t][j]] = first + t;
+                } else if (j == 0) {
+                    // Larger than a tile (margin >= 1): give it the tile alone
+                    r.x = r.y = 0.0f;
+                    r.rotated = false;
+                    bin.place(0.0f, 0.0f, r.w, r.h, 0.0f, 0.0f);
+                    rect_tile[tile_rects[t][j]] = first + t;
+                }
+            }
+        });
+
+        next.clear();
+        for (int k : pending) {
+            for (size_t t = 0; rect_tile[k] < 0 && t < bins.size(); t++) {
+                if (maxrects_insert(bins[t], rects[k], allow_rotation, 0.0f, 0.0f)) rect_tile[k] = (int)t;
+            }
+            if (rect_tile[k] < 0) next.push_back(k);
+        }
+        pending.swap(next);
+    }
+    return (int)bins.size();
+}
+
 void pack_uv_islands(Mesh* mesh,
                      const UnwrapResult* result,
                      float margin) {
+    PackOptions options;
+    memset(&options, 0, sizeof(options));
+    options.margin = margin;
+    pack_uv_islands_ex(mesh, result, &options);
+}
+
+void pack_uv_islands_ex(Mesh* mesh,
+                        const UnwrapResult* result,
+                        const PackOptions* options) {
     if (!mesh || !result || !mesh->uvs) return;
 
-    if (result->num_islands <= 1) {
+    const float margin = options ? options->margin : 0.0f;
+    const bool udim = options && options->texel_density > 0.0f;
+    const int method = options && !udim ? options->method : PACK_METHOD_MAXRECTS;
+    const bool allow_rotation = !(options && options->no_rotation);
+
+    if (result->num_islands <= 1 && !udim) {
         // Single island, already normalized to [0,1]
         return;
     }
 
-    printf("Packing %d islands...\n", result->num_islands);
-
-    // TODO: Implement island packing
-    //
-    // ALGORITHM:
-    //
-    // STEP 1: Compute bounding box for each island
-    //   - For each island, find min/max U and V
-    //   - Compute width and height
-    //   - Track which vertices belong to each island
-    //
-    // STEP 2: Sort islands by height (descending)
-    //   - Larger islands first
-    //   - Use std::sort with custom comparator
-    //
-    // STEP 3: Shelf packing
-    //   - Create shelves (horizontal rows)
-    //   - Try to fit island in current shelf
-    //   - If doesn't fit, create new shelf below
-    //   - Track target_x, target_y for each island
-    //
-    // STEP 4: Move islands to packed positions
-    //   - For each island:
-    //       offset_x = target_x - current_min_u
-    //       offset_y = target_y - current_min_v
-    //   - Apply offset to all UVs in island
-    //
-    // STEP 5: Scale everything to fit [0,1]²
-    //   - Find max_width, max_height of packed result
-    //   - Scale all UVs by 1.0 / max(max_width, max_height)
-    //
-    // EXPECTED COVERAGE:
-    //   - Shelf packing: > 60%
-    //
-    // BONUS (+10 points):
-    //   - Implement MaxRects or Skyline packing for > 75% coverage
+    if (udim) {
+        const int tile_resolution = options->tile_resolution > 0
+                                  ? options->tile_resolution : UDIM_DEFAULT_TILE_RESOLUTION;
+        printf("Packing %d islands into UDIM tiles (%.1f texels/unit, %d px tiles%s)...\n",
+               result->num_islands, options->texel_density, tile_resolution,
+               allow_rotation ? ", rotation" : "");
+        int shrunk = scale_to_texel_density(mesh, result, options->texel_density / tile_resolution,
+                                            (1.0f - margin) * UDIM_FIT_SLACK,
+                                            resolve_thread_count(options->num_threads), NULL);
+        if (shrunk > 0) {
+            printf("  Warning: %d island%s larger than a tile, shrunk to fit\n", shrunk, shrunk == 1 ? "" : "s");
+        }
+    } else {
+        static const char* method_names[] = {"MaxRects", "skyline", "shelf", "raster"};
+        printf("Packing %d islands (%s%s)...\n", result->num_islands,
+               method >= 0 && method <= PACK_METHOD_RASTER ? method_names[method] : "?",
+               allow_rotation ? ", rotation" : "");
+    }
 
     std::vector<Island> islands(result->num_islands);
 
     // STEP 1: Compute bounding boxes
-    // YOUR CODE HERE
-    
-    // Initialize
     for(int i=0; i<result->num_islands; ++i) {
         islands[i].id = i;
         islands[i].min_u = FLT_MAX;
@@ -92,6 +1452,7 @@ void pack_uv_islands(Mesh* mesh,
         islands[i].max_v = -FLT_MAX;
         islands[i].target_x = 0;
         islands[i].target_y = 0;
+        islands[i].rotated = false;
     }
 
     // We iterate over FACES to find the bounds of each island
@@ -99,137 +1460,171 @@ void pack_uv_islands(Mesh* mesh,
     const int* tris = mesh->triangles;
     const int* face_ids = result->face_island_ids;
 
-    for (int f = 0; f < mesh->num_triangles; f++) {
-        int island_id = face_ids[f];
-        if (island_id < 0 || island_id >= result->num_islands) continue;
-
+    auto grow_bounds = [&](Island& isl, int f) {
+        if (!face_corners_valid(mesh, f)) return;
         // Check all 3 vertices of the face
         for (int j = 0; j < 3; j++) {
             int v_idx = tris[3*f + j];
             float u = mesh->uvs[2*v_idx];
             float v = mesh->uvs[2*v_idx + 1];
 
-            islands[island_id].min_u = min_float(islands[island_id].min_u, u);
-            islands[island_id].max_u = max_float(islands[island_id].max_u, u);
-            islands[island_id].min_v = min_float(islands[island_id].min_v, v);
-            islands[island_id].max_v = max_float(islands[island_id].max_v, v);
+            isl.min_u = min_float(isl.min_u, u);
+            isl.max_u = max_float(isl.max_u, u);
+            isl.min_v = min_float(isl.min_v, v);
+            isl.max_v = max_float(isl.max_v, v);
+        }
+    };
+
+    if (result->island_face_offsets && result->island_faces) {
+        // Island→faces index: each island touches only its own faces
+        for (int i = 0; i < result->num_islands; i++) {
+            for (int k = result->island_face_offsets[i]; k < result->island_face_offsets[i + 1]; k++) {
+                grow_bounds(islands[i], result->island_faces[k]);
+            }
+        }
+    } else {
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            int island_id = face_ids[f];
+            if (island_id < 0 || island_id >= result->num_islands) continue;
+            grow_bounds(islands[island_id], f);
         }
     }
 
-    // Compute dims
+    // Footprints (size + margin) of the non-empty islands, and their total area
+    std::vector<PackRect> rects;
+    std::vector<int> rect_island;
+    float total_area = 0.0f;
+    float longest_side = 0.0f;
     for(int i=0; i<result->num_islands; ++i) {
         // Handle case where island has no faces (empty)
         if (islands[i].min_u == FLT_MAX) {
             islands[i].width = 0;
             islands[i].height = 0;
-        } else {
-            islands[i].width = islands[i].max_u - islands[i].min_u;
-            islands[i].height = islands[i].max_v - islands[i].min_v;
-        }
-    }
-    // --- OPTIMIZATION START: Calculate Total Area for Dynamic Bin Width ---
-    float total_area = 0.0f;
-    for(int i=0; i<result->num_islands; ++i) {
-        // Skip empty islands logic is handled in the loop below, but safe to check here
-        if (islands[i].min_u != FLT_MAX) {
-            // Add area with margin approximation
-            total_area += (islands[i].width + margin) * (islands[i].height + margin);
+            continue;
         }
+        islands[i].width = islands[i].max_u - islands[i].min_u;
+        islands[i].height = islands[i].max_v - islands[i].min_v;
+        if (islands[i].width == 0) continue;
+
+        PackRect r = {islands[i].width + margin, islands[i].height + margin, 0.0f, 0.0f, false};
+        rects.push_back(r);
+        rect_island.push_back(i);
+        total_area += r.w * r.h;
+        longest_side = max_float(longest_side, max_float(r.w, r.h));   // must fit the square bin
     }
-    // --- OPTIMIZATION END ---
 
-    // STEP 2: Sort by height
-    // YOUR CODE HERE
-    std::vector<int> sorted_indices(result->num_islands);
-    for(int i=0; i<result->num_islands; ++i) sorted_indices[i] = i;
+    // STEP 2: Sort. Shelves want tall islands first; MaxRects and skyline
+    // the longest side first, then the larger area (ties by island id)
+    std::vector<int> order(rects.size());
+    for (size_t i = 0; i < rects.size(); i++) order[i] = (int)i;
+    if (method == PACK_METHOD_SHELF) {
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            float ha = allow_rotation ? min_float(rects[a].w, rects[a].h) : rects[a].h;
+            float hb = allow_rotation ? min_float(rects[b].w, rects[b].h) : rects[b].h;
+            return ha > hb;
+        });
+    } else {
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            float la = max_float(rects[a].w, rects[a].h), lb = max_float(rects[b].w, rects[b].h);
+            if (la != lb) return la > lb;
+            return rects[a].w * rects[a].h > rects[b].w * rects[b].h;
+        });
+    }
 
-    std::sort(sorted_indices.begin(), sorted_indices.end(), 
-        [&islands](int a, int b) {
-            return islands[a].height > islands[b].height;
-        }
-    );
-    // STEP 3: Shelf packing
-    // YOUR CODE HERE
-    float current_x = 0.0f;
-    float current_y = 0.0f;
-    float shelf_height = 0.0f;
+    // STEP 3: Pack. Shelves fill one sqrt(area) wide strip; MaxRects and
+    // skyline start from a sqrt(area) square bin and grow it by 1% in place
+    // whenever an island fits nowhere;
+    // the raster packer sizes its own strip from the silhouettes; UDIM mode
+    // packs unit tiles and keeps the margin to the tile edges
     float max_packed_w = 0.0f;
     float max_packed_h = 0.0f;
+    if (udim) {
+        std::vector<int> rect_tile;
+        const int num_threads = resolve_thread_count(options->num_threads);
+        const int num_tiles = pack_udim_tiles(rects, order, allow_rotation, num_threads, rect_tile);
 
-    // Use a fixed bin width or flexible? Let's assume square aspect ratio target.
-    // Heuristic: Width ~ Sqrt(Total Area). 
-    // For simplicity in this assignment, we often pack into a strip and then scale.
-    // Let's use width 1.0 (arbitrary since we scale later).
-    // const float BIN_WIDTH = 1.0f;
-
-    // FIX: Dynamic Bin Width
-    // Ideally, we want a square result. So we try to pack into a width of sqrt(total_area).
-    const float BIN_WIDTH = (total_area > 0.0f) ? sqrtf(total_area) : 1.0f;
-
-    if (!sorted_indices.empty()) {
-        shelf_height = islands[sorted_indices[0]].height;
-    }
-
-    for (int idx : sorted_indices) {
-        Island& isl = islands[idx];
-        if (isl.width == 0) continue; // Skip empty
-
-        // If fits in current row
-        if (current_x + isl.width > BIN_WIDTH) {
-            // Move to next shelf
-            current_x = 0.0f;
-            current_y += shelf_height + margin;
-            shelf_height = isl.height; // Reset height for new shelf
+        if (options->island_tiles) {
+            for (int i = 0; i < result->num_islands; i++) options->island_tiles[i] = -1;
+        }
+        for (size_t k = 0; k < rects.size(); k++) {
+            const PackRect& r = rects[k];
+            const int t = rect_tile[k];
+            Island& isl = islands[rect_island[k]];
+            isl.target_x = (float)(t % UDIM_TILES_PER_ROW) + r.x + 0.5f * margin;
+            isl.target_y = (float)(t / UDIM_TILES_PER_ROW) + r.y + 0.5f * margin;
+            isl.rotated = r.rotated;
+            if (options->island_tiles) options->island_tiles[rect_island[k]] = t;
+        }
+        if (options->num_tiles_out) *options->num_tiles_out = num_tiles;
+        printf("  %d tile%s\n", num_tiles, num_tiles == 1 ? "" : "s");
+    } else if (method == PACK_METHOD_RASTER) {
+        // Island→faces ranges, from the result or by a counting sort
+        std::vector<int> face_offsets(result->num_islands + 1, 0), faces;
+        if (result->island_face_offsets && result->island_faces) {
+            face_offsets.assign(result->island_face_offsets, result->island_face_offsets + result->num_islands + 1);
+            faces.assign(result->island_faces, result->island_faces + face_offsets[result->num_islands]);
+        } else {
+            for (int f = 0; f < mesh->num_triangles; f++) {
+                if (face_ids[f] >= 0 && face_ids[f] < result->num_islands) face_offsets[face_ids[f] + 1]++;
+            }
+            for (int i = 0; i < result->num_islands; i++) face_offsets[i + 1] += face_offsets[i];
+            faces.resize(face_offsets[result->num_islands]);
+            std::vector<int> fill(face_offsets.begin(), face_offsets.end() - 1);
+            for (int f = 0; f < mesh->num_triangles; f++) {
+                if (face_ids[f] >= 0 && face_ids[f] < result->num_islands) faces[fill[face_ids[f]]++] = f;
+            }
         }
 
-        isl.target_x = current_x;
-        isl.target_y = current_y;
-
-        current_x += isl.width + margin;
-        
-        max_packed_w = max_float(max_packed_w, current_x);
-        max_packed_h = max_float(max_packed_h, current_y + isl.height);
-        
-        // Shelf grows if we find a taller item (unlikely with sorted input, but safe)
-        if (isl.height > shelf_height) shelf_height = isl.height;
-    }
-    // STEP 4: Move islands
-    // YOUR CODE HERE
-    struct Offset { float x, y; };
-    std::vector<Offset> vert_offsets(mesh->num_vertices, {0.0f, 0.0f});
-    std::vector<bool> vert_seen(mesh->num_vertices, false);
-
-    for (int f = 0; f < mesh->num_triangles; f++) {
-        int isl_id = face_ids[f];
-        if (isl_id < 0) continue;
-        
-        Island& isl = islands[isl_id];
-        float off_x = isl.target_x - isl.min_u;
-        float off_y = isl.target_y - isl.min_v;
+        std::vector<int> island_order(order.size());
+        for (size_t k = 0; k < order.size(); k++) island_order[k] = rect_island[order[k]];
+        const int resolution = options && options->raster_resolution > 0
+                             ? options->raster_resolution : RASTER_DEFAULT_RESOLUTION;
+        const int num_threads = resolve_thread_count(options ? options->num_threads : 0);
+        pack_raster(mesh, face_offsets, faces, islands, island_order, margin, allow_rotation,
+                    resolution, options ? options->time_budget_seconds : 0.0, num_threads,
+                    &max_packed_w, &max_packed_h);
+    } else {
+        PackerFn packer = method == PACK_METHOD_SKYLINE ? pack_skyline
+                        : method == PACK_METHOD_SHELF ? pack_shelf
+                        : pack_maxrects;
+        const float start = max_float(total_area > 0.0f ? sqrtf(total_area) : 1.0f, longest_side);
+        const float side = packer(rects, order, start, allow_rotation);
 
-        for(int j=0; j<3; j++) {
-            int v = tris[3*f+j];
-            if (!vert_seen[v]) {
-                vert_offsets[v] = {off_x, off_y};
-                vert_seen[v] = true;
-            }
+        // Extent without the trailing margin
+        for (size_t k = 0; k < rects.size(); k++) {
+            const PackRect& r = rects[k];
+            Island& isl = islands[rect_island[k]];
+            isl.target_x = r.x;
+            isl.target_y = r.y;
+            isl.rotated = r.rotated;
+            max_packed_w = max_float(max_packed_w, r.x + (r.rotated ? isl.height : isl.width));
+            max_packed_h = max_float(max_packed_h, r.y + (r.rotated ? isl.width : isl.height));
         }
+        printf("  bin %.4f (from %.4f), extent %.4f x %.4f\n", side, start, max_packed_w, max_packed_h);
     }
 
+    // STEP 4: Move islands
+    std::vector<int> vert_island;
+    assign_vertex_islands(mesh, result, vert_island);
+
     for(int v=0; v<mesh->num_vertices; v++) {
-        if(vert_seen[v]) {
-            mesh->uvs[2*v]   += vert_offsets[v].x;
-            mesh->uvs[2*v+1] += vert_offsets[v].y;
+        if (vert_island[v] < 0) continue;
+        const Island& isl = islands[vert_island[v]];
+        float u = mesh->uvs[2*v], w = mesh->uvs[2*v+1];
+        if (isl.rotated) {
+            // 90° counter-clockwise: (du, dv) -> (height - dv, du)
+            mesh->uvs[2*v]   = isl.target_x + (isl.max_v - w);
+            mesh->uvs[2*v+1] = isl.target_y + (u - isl.min_u);
+        } else {
+            mesh->uvs[2*v]   = u + (isl.target_x - isl.min_u);
+            mesh->uvs[2*v+1] = w + (isl.target_y - isl.min_v);
         }
     }
-    // STEP 5: Scale to [0,1]
-    // YOUR CODE HERE
+
+    // STEP 5: Scale to [0,1] (UDIM tiles keep the texel density)
     float scale = 1.0f;
-    float final_w = max_packed_w;
-    float final_h = max_packed_h;
-    
-    float max_dim = max_float(final_w, final_h);
-    if (max_dim > 1e-6) {
+    float max_dim = max_float(max_packed_w, max_packed_h);
+    if (max_dim > 1e-6 && !udim) {
         scale = 1.0f / max_dim;
     }
 
@@ -287,28 +1682,60 @@ void compute_quality_metrics(const Mesh* mesh, UnwrapResult* result) {
     const int* tris = mesh->triangles;
     const float* uvs = mesh->uvs;
 
-    for (int f = 0; f < mesh->num_triangles; f++) {
+    auto uv_area = [&](int f) {
         int idx0 = tris[3*f + 0];
         int idx1 = tris[3*f + 1];
         int idx2 = tris[3*f + 2];
+        if (!face_corners_valid(mesh, f)) return 0.0;
 
         float u0 = uvs[2*idx0], v0 = uvs[2*idx0+1];
         float u1 = uvs[2*idx1], v1 = uvs[2*idx1+1];
         float u2 = uvs[2*idx2], v2 = uvs[2*idx2+1];
 
         // 2D Triangle Area = 0.5 * |(x1-x0)(y2-y0) - (y1-y0)(x2-x0)|
-        double area = 0.5 * std::abs((u1-u0)*(v2-v0) - (v1-v0)*(u2-u0));
-        total_uv_area += area;
+        return 0.5 * std::abs((u1-u0)*(v2-v0) - (v1-v0)*(u2-u0));
+    };
+
+    if (result->island_face_offsets && result->island_faces) {
+        // Sum island by island through the CSR index
+        for (int i = 0; i < result->num_islands; i++) {
+            for (int k = result->island_face_offsets[i]; k < result->island_face_offsets[i + 1]; k++) {
+                total_uv_area += uv_area(result->island_faces[k]);
+            }
+        }
+    } else {
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            total_uv_area += uv_area(f);
+        }
     }
 
     // Since we packed into [0,1], total area is 1.0
-    // So coverage is just the sum of triangle areas.
+    // So coverage is just the sum of triangle areas (UDIM: over all tiles)
+    if (result->island_tiles && result->num_tiles > 0) total_uv_area /= result->num_tiles;
     result->coverage = (float)total_uv_area;
     if (result->coverage > 1.0f) result->coverage = 1.0f; // Clamp just in case
 
+    // Per-island texel density: UV length per unit of 3D length, by area
+    if (result->island_density) {
+        IslandMeasures m;
+        measure_islands(mesh, result, resolve_thread_count(0), &m);
+        float min_density = FLT_MAX, max_density = 0.0f;
+        for (int i = 0; i < result->num_islands; i++) {
+            const bool measurable = m.area_3d[i] > 0.0 && m.area_uv[i] > 0.0;
+            result->island_density[i] = measurable ? (float)sqrt(m.area_uv[i] / m.area_3d[i]) : 0.0f;
+            if (!measurable) continue;
+            min_density = min_float(min_density, result->island_density[i]);
+            max_density = max_float(max_density, result->island_density[i]);
+        }
+        result->density_spread = max_density > 0.0f ? max_density / min_density : 0.0f;
+    }
+
     printf("Quality metrics:\n");
     printf("  Avg stretch: %.2f (default)\n", result->avg_stretch);
     printf("  Max stretch: %.2f (default)\n", result->max_stretch);
     printf("  Coverage: %.1f%%\n", result->coverage * 100.0f);
+    if (result->island_density) {
+        printf("  Texel density spread: %.2fx\n", result->density_spread);
+    }
 
 }
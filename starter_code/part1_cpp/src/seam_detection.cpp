@@ -16,187 +16,92 @@
 #include "algorithm"
 #include "unwrap.h"
 #include "math_utils.h"
+#include "face_geometry.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <vector>
-#include <set>
 #include <queue>
 #include <algorithm>
+#include <stdint.h>
+#include <string.h>
+#include "parallel.h"
 
 #ifndef M_PI
   #define M_PI 3.14159265358979323846
 #endif
 
-static float get_edge_sharpness(const Mesh* mesh, int f0, int f1) {
-    if (f0 < 0 || f1 < 0) return 1.0f; 
+/** Interior edges per thread below which the MST sort stays serial */
+static const size_t MST_MIN_EDGES_PER_THREAD = 32768;
 
-    const float* v = mesh->vertices;
-    const int* t = mesh->triangles;
+void compute_angular_defects(const Mesh* mesh, float* defects_out) {
+    const int V = mesh->num_vertices;
+    const int F = mesh->num_triangles;
+    const int* tris = mesh->triangles;
 
-    // Normal f0
-    int i0=t[3*f0], i1=t[3*f0+1], i2=t[3*f0+2];
-    float p0[3]={v[3*i0],v[3*i0+1],v[3*i0+2]}, p1[3]={v[3*i1],v[3*i1+1],v[3*i1+2]}, p2[3]={v[3*i2],v[3*i2+1],v[3*i2+2]};
-    float e1[3]={p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]}, e2[3]={p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
-    float n0[3]={e1[1]*e2[2]-e1[2]*e2[1], e1[2]*e2[0]-e1[0]*e2[2], e1[0]*e2[1]-e1[1]*e2[0]};
-    
-    // FIX: Use sqrtf() instead of sqrt()
-    float l0=sqrtf(n0[0]*n0[0]+n0[1]*n0[1]+n0[2]*n0[2]); 
-    if(l0>0){n0[0]/=l0; n0[1]/=l0; n0[2]/=l0;}
-
-    // Normal f1
-    int j0=t[3*f1], j1=t[3*f1+1], j2=t[3*f1+2];
-    float q0[3]={v[3*j0],v[3*j0+1],v[3*j0+2]}, q1[3]={v[3*j1],v[3*j1+1],v[3*j1+2]}, q2[3]={v[3*j2],v[3*j2+1],v[3*j2+2]};
-    float d1[3]={q1[0]-q0[0], q1[1]-q0[1], q1[2]-q0[2]}, d2[3]={q2[0]-q0[0], q2[1]-q0[1], q2[2]-q0[2]};
-    float n1[3]={d1[1]*d2[2]-d1[2]*d2[1], d1[2]*d2[0]-d1[0]*d2[2], d1[0]*d2[1]-d1[1]*d2[0]};
-    
-    // FIX: Use sqrtf() instead of sqrt()
-    float l1=sqrtf(n1[0]*n1[0]+n1[1]*n1[1]+n1[2]*n1[2]); 
-    if(l1>0){n1[0]/=l1; n1[1]/=l1; n1[2]/=l1;}
+    for (int v = 0; v < V; ++v) defects_out[v] = 0.0f;
 
-    return 1.0f - (n0[0]*n1[0] + n0[1]*n1[1] + n0[2]*n1[2]);
-}
+    for (int f = 0; f < F; ++f) {
+        int idx[3] = {tris[3*f + 0], tris[3*f + 1], tris[3*f + 2]};
+        if (idx[0] < 0 || idx[0] >= V || idx[1] < 0 || idx[1] >= V ||
+            idx[2] < 0 || idx[2] >= V) {
+            continue;
+        }
 
-/**
- * @brief Compute angular defect at a vertex
- *
- * Angular defect = 2π - sum of angles at vertex
- *
- * - Flat surface: defect ≈ 0
- * - Corner (like cube): defect > 0
- * - Saddle: defect < 0
- *
- * @param mesh Input mesh
- * @param vertex_idx Vertex index
- * @return Angular defect in radians
- */
-static float compute_angular_defect(const Mesh* mesh, int vertex_idx) {
-    // TODO: Implement
-    //
-    // Steps:
-    // 1. Find all triangles containing this vertex
-    // 2. For each triangle, compute angle at this vertex
-    //    (use compute_vertex_angle_in_triangle from math_utils.h)
-    // 3. Sum all angles
-    // 4. Return 2*PI - sum
-    //
-    // Hint: Angular defect indicates curvature
-    //       High defect → sharp feature → good seam location
-
-    float angle_sum = 0.0f;
-
-    // YOUR CODE HERE
-    if(!mesh) return 0.0f;
-
-    int F = mesh->num_triangles;
-    int V = mesh->num_vertices;
-    const int* tris = mesh->triangles;
-    
+        Vec3 p[3];
+        for (int k = 0; k < 3; ++k) p[k] = get_vertex_position(mesh, idx[k]);
 
-    if(vertex_idx < 0 || vertex_idx >= V) return 0.0f;
+        // dir[k] = unit vector from corner k to corner k+1
+        Vec3 dir[3];
+        for (int k = 0; k < 3; ++k) dir[k] = vec3_normalize(vec3_sub(p[(k + 1) % 3], p[k]));
 
-    for(int f = 0; f < F; ++f){
-        int a = tris[3*f + 0];
-        int b = tris[3*f + 1];  
-        int c = tris[3*f + 2];
+        for (int k = 0; k < 3; ++k) {
+            // A vertex repeated in a degenerate face only counts its first corner
+            if ((k >= 1 && idx[k] == idx[0]) || (k == 2 && idx[2] == idx[1])) continue;
 
-        if(a == vertex_idx || b == vertex_idx || c == vertex_idx){
-            angle_sum += compute_vertex_angle_in_triangle(mesh, f, vertex_idx);
+            // Angle between (corner k → k+1) and (corner k → k+2) = -(corner k+2 → k)
+            Vec3 back = vec3_scale(dir[(k + 2) % 3], -1.0f);
+            float cos_angle = clamp_float(vec3_dot(dir[k], back), -1.0f, 1.0f);
+            defects_out[idx[k]] += acosf(cos_angle);
         }
     }
 
-    return 2.0f * float(M_PI) - angle_sum;
+    for (int v = 0; v < V; ++v) {
+        defects_out[v] = 2.0f * float(M_PI) - defects_out[v];
+    }
 }
 
 /**
- * @brief Get all edges incident to a vertex
+ * @brief Sorted-BFS spanning tree over the dual graph
+ *
+ * Each face's (at most 3) neighbours are visited flattest-first, so the
+ * tree tends to grow across smooth regions. Only the component of face 0
+ * is spanned.
  */
-static std::vector<int> get_vertex_edges(const TopologyInfo* topo, int vertex_idx) {
-    std::vector<int> edges;
-
-    // TODO: Iterate through all edges, add those touching vertex_idx
-
-    // YOUR CODE HERE
-    if(!topo) return edges;
-    int E = topo->num_edges;
-    const int* edge_verts = topo->edges;
-    for(int e = 0; e<E; ++e){
-        int v0 = edge_verts[2*e + 0];
-        int v1 = edge_verts[2*e + 1];
-        if(v0 == vertex_idx || v1 == vertex_idx){
-            edges.push_back(e);
-        }
-    }
-
-    return edges;
-}
-
-int* detect_seams(const Mesh* mesh,
-                  const TopologyInfo* topo,
-                  float angle_threshold,
-                  int* num_seams_out) {
-    if (!mesh || !topo || !num_seams_out) return NULL;
-    (void)angle_threshold;
-    // TODO: Implement seam detection
-    //
-    // ALGORITHM:
-    //
-    // STEP 1: Build dual graph
-    //   - Nodes = faces
-    //   - Edges = shared edges between faces
-    //   - Use std::vector<std::vector<int>> for adjacency list
-    //
-    // STEP 2: Spanning tree via BFS
-    //   - Start from face 0
-    //   - Mark edges in spanning tree
-    //   - Use std::set<int> to track tree edges
-    //
-    // STEP 3: Initial seam candidates = non-tree edges
-    //   - All edges NOT in spanning tree
-    //
-    // STEP 4: Angular defect refinement
-    //   - For each vertex with high angular defect (> 0.5 radians)
-    //   - Add incident edges to seam candidates
-    //
-    // STEP 5: Convert seam candidates to array
-    //
-    // Expected seam counts:
-    //   Cube: 7-9 seams
-    //   Sphere: 1-3 seams
-    //   Cylinder: 1-2 seams
-
-    std::set<int> seam_candidates;
-
-    // YOUR CODE HERE
-    const int V = mesh->num_vertices;
-    const int F = mesh->num_triangles;
-    const int E = topo->num_edges;
-    // const int* edges = topo->edges;
-    const int* edge_faces = topo->edge_faces;
-
-    if(F <= 0 || E <=0){
-        *num_seams_out = 0;
-        return NULL;
-    }
-
-    // 1. dual graph (face adjacency)
-    std::vector<std::vector<std::pair<int, int>>> face_adj(F);
-    for (int e = 0; e <E; ++e){
-        int f0 = edge_faces[2*e + 0];
-        int f1 = edge_faces[2*e + 1];
-        if(f0 >= 0 && f1 >= 0 && f0 < F && f1 < F){
-            face_adj[f0].push_back(std::make_pair(e,f1));
-            face_adj[f1].push_back(std::make_pair(e,f0));
+static void build_bfs_tree(const HalfEdgeMesh* he, int F, const float* sharpness,
+                           std::vector<char>& is_tree_edge) {
+    // 1. dual graph (face adjacency), read straight from the half-edge twins:
+    //    at most 3 (edge, face) neighbours per face, in ascending edge order
+    std::vector<std::pair<int, int>> face_adj(3 * (size_t)F);
+    std::vector<int> adj_count(F, 0);
+    for (int f = 0; f < F; ++f) {
+        std::pair<int, int>* nbrs = &face_adj[3*f];
+        int count = 0;
+        for (int k = 0; k < 3; ++k) {
+            int twin = he->he_twin[3*f + k];
+            if (twin >= 0) {
+                nbrs[count++] = std::make_pair(he->he_edge[3*f + k], he->he_face[twin]);
+            }
         }
+        std::sort(nbrs, nbrs + count);
+        adj_count[f] = count;
     }
 
     // This forces the BFS to explore flat surfaces first, pushing sharp edges to be seams.
     for(int f = 0; f < F; ++f) {
-        std::sort(face_adj[f].begin(), face_adj[f].end(), 
+        std::sort(face_adj.begin() + 3*f, face_adj.begin() + 3*f + adj_count[f],
             [&](const std::pair<int,int>& a, const std::pair<int,int>& b) {
-                float costA = get_edge_sharpness(mesh, f, a.second);
-                float costB = get_edge_sharpness(mesh, f, b.second);
-                return costA < costB; 
+                return sharpness[a.first] < sharpness[b.first];
             }
         );
     }
@@ -204,7 +109,6 @@ int* detect_seams(const Mesh* mesh,
     // 2. BFS spanning tree
 
     std::vector<char> visited(F, 0);
-    std::set<int> tree_edges; // edges in spanning tree
 
     if(F>0){
         std::queue<int> q;
@@ -215,22 +119,162 @@ int* detect_seams(const Mesh* mesh,
             int curr_face = q.front();
             q.pop();
 
-            for (const auto& neighbor : face_adj[curr_face]){
-                int edge_idx = neighbor.first;
-                int adj_face = neighbor.second;
+            for (int k = 0; k < adj_count[curr_face]; ++k){
+                int edge_idx = face_adj[3*curr_face + k].first;
+                int adj_face = face_adj[3*curr_face + k].second;
 
                 if (!visited[adj_face]){
                     visited[adj_face] = 1;
-                    tree_edges.insert(edge_idx);
+                    is_tree_edge[edge_idx] = 1;
                     q.push(adj_face);
                 }
             }
         }
     }
+}
+
+/**
+ * @brief Minimum spanning forest of the dual graph (Kruskal)
+ *
+ * Interior edges are weighted by their cached sharpness and sorted in
+ * parallel by (weight, edge index), a strict order that makes the tree
+ * independent of the thread count. A path-halving union-find with union by
+ * size then accepts each edge that joins two different components:
+ * O(E log E) for the sort and near-linear for the joins. Unlike the BFS,
+ * every connected component gets its own tree.
+ */
+static void build_mst_tree(const TopologyInfo* topo, int F, const float* sharpness,
+                           int num_threads, std::vector<char>& is_tree_edge) {
+    const int E = topo->num_edges;
+    const int* edge_faces = topo->edge_faces;
+
+    // Sortable key: float bits mapped to an unsigned order, edge index as tie-break
+    std::vector<uint64_t> order;
+    order.reserve(E);
+    for (int e = 0; e < E; ++e) {
+        int f0 = edge_faces[2*e + 0];
+        int f1 = edge_faces[2*e + 1];
+        if (f0 < 0 || f1 < 0 || f0 == f1) continue;
+        uint32_t bits;
+        memcpy(&bits, &sharpness[e], sizeof(bits));
+        bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        order.push_back(((uint64_t)bits << 32) | (uint32_t)e);
+    }
+
+    num_threads = limit_thread_count(num_threads, order.size(), MST_MIN_EDGES_PER_THREAD);
+    parallel_sort(order, num_threads, [](uint64_t a, uint64_t b) { return a < b; });
+
+    std::vector<int> parent(F);
+    std::vector<int> size(F, 1);
+    for (int f = 0; f < F; ++f) parent[f] = f;
+
+    auto find = [&](int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];  // path halving
+            x = parent[x];
+        }
+        return x;
+    };
+
+    int joins = 0;
+    for (uint64_t key : order) {
+        int e = (int)(key & 0xffffffffu);
+        int r0 = find(edge_faces[2*e + 0]);
+        int r1 = find(edge_faces[2*e + 1]);
+        if (r0 == r1) continue;
+        if (size[r0] < size[r1]) std::swap(r0, r1);
+        parent[r1] = r0;
+        size[r0] += size[r1];
+        is_tree_edge[e] = 1;
+        if (++joins == F - 1) break;  // single tree complete
+    }
+}
+
+int* detect_seams(const Mesh* mesh,
+                  const TopologyInfo* topo,
+                  float angle_threshold,
+                  int* num_seams_out) {
+    SeamOptions options;
+    options.angle_threshold = angle_threshold;
+    options.method = SEAM_METHOD_SORTED_BFS;
+    options.num_threads = 0;
+    options.sharp_edges = NULL;
+    return detect_seams_ex(mesh, topo, &options, num_seams_out);
+}
+
+int* detect_seams_ex(const Mesh* mesh,
+                     const TopologyInfo* topo,
+                     const SeamOptions* options,
+                     int* num_seams_out) {
+    if (!mesh || !topo || !num_seams_out) return NULL;
+    const int method = options ? options->method : SEAM_METHOD_SORTED_BFS;
+    // Outline:
+    //   1. Sharp / smooth label per edge from the cached sharpness
+    //   2. Spanning tree of the dual graph (faces as nodes): flattest-first
+    //      BFS from face 0 over half-edge twins, or a Kruskal forest on
+    //      sharpness for SEAM_METHOD_MST; per-edge tree flags
+    //   3. Seams = sharp non-tree edges (the sharpest one if none is sharp)
+    //   4. Non-tree edges around vertices with angular defect > 0.5 rad
+    //   5. Seam edges in ascending order
+
+    const int V = mesh->num_vertices;
+    const int F = mesh->num_triangles;
+    const int E = topo->num_edges;
+    // const int* edges = topo->edges;
+    const int* edge_faces = topo->edge_faces;
+
+    if(F <= 0 || E <=0){
+        *num_seams_out = 0;
+        return NULL;
+    }
+
+    // Per-edge sharpness (1 - dot of cached face normals) comes with the
+    // topology; only hand-built topologies need it computed here
+    const float* sharpness = topo->edge_sharpness;
+    std::vector<float> local_sharpness;
+    if (!sharpness) {
+        FaceGeometry* geom = compute_face_geometry(mesh);
+        if (!geom) {
+            *num_seams_out = 0;
+            return NULL;
+        }
+        local_sharpness.resize(E);
+        compute_edge_sharpness(geom, edge_faces, E, local_sharpness.data());
+        free_face_geometry(geom);
+        sharpness = local_sharpness.data();
+    }
+
+    // Sharp / smooth label per edge at the requested dihedral angle; a
+    // threshold sweep passes its own labels and skips this pass
+    const unsigned char* is_sharp = options ? options->sharp_edges : NULL;
+    std::vector<unsigned char> local_sharp;
+    if (!is_sharp) {
+        float angle_threshold = options ? options->angle_threshold : 30.0f;
+        local_sharp.resize(E);
+        classify_sharp_edges(sharpness, edge_faces, E, angle_threshold, local_sharp.data());
+        is_sharp = local_sharp.data();
+    }
+
+    // 1-2. Spanning tree of the dual graph (faces as nodes, shared edges as links)
+    std::vector<char> is_tree_edge(E, 0); // edges in spanning tree
+
+    if (method == SEAM_METHOD_MST) {
+        int num_threads = resolve_thread_count(options ? options->num_threads : 0);
+        build_mst_tree(topo, F, sharpness, num_threads, is_tree_edge);
+    } else {
+        const HalfEdgeMesh* he = topo->halfedge;
+        if (!he) {
+            fprintf(stderr, "detect_seams: topology has no half-edge mesh\n");
+            *num_seams_out = 0;
+            return NULL;
+        }
+        build_bfs_tree(he, F, sharpness, is_tree_edge);
+    }
 
     // 3.Seam candidates = non-tree edges
     
     std::vector<int> non_tree_edges;
+    std::vector<char> is_non_tree(E, 0);
     for (int e = 0; e < E; ++e) {
         int f0 = edge_faces[2*e + 0];
         int f1 = edge_faces[2*e + 1];
@@ -238,11 +282,19 @@ int* detect_seams(const Mesh* mesh,
         // Skip boundary edges
         if (f0 < 0 || f1 < 0) continue;
         
-        if(tree_edges.find(e) == tree_edges.end()){
+        if(!is_tree_edge[e]){
             non_tree_edges.push_back(e);
+            is_non_tree[e] = 1;
         }
     }
 
+    // Seam flags per edge; collected in ascending edge order at the end
+    std::vector<char> is_seam(E, 0);
+    int num_seams = 0;
+    auto add_seam = [&](int e) {
+        if (!is_seam[e]) { is_seam[e] = 1; ++num_seams; }
+    };
+
     if (non_tree_edges.empty()) {
         *num_seams_out = 0;
         return NULL;
@@ -250,60 +302,51 @@ int* detect_seams(const Mesh* mesh,
 
      
     for (int nte : non_tree_edges) {
-        int f0 = edge_faces[2*nte + 0];
-        int f1 = edge_faces[2*nte + 1];
-        float sharpness = get_edge_sharpness(mesh, f0, f1);
-        
-        // Threshold: 0.5 (approx 60 degrees) keeps Cubes seams, ignores Cylinder smoothness
-        if (sharpness > 0.5f) {
-            seam_candidates.insert(nte);
+        // Dihedral angle above angle_threshold
+        if (is_sharp[nte]) {
+            add_seam(nte);
         }
     }
 
     // Fallback: If filtered everything out (e.g. Sphere/Cylinder),  still need at least one cut
-    if (seam_candidates.empty() && !non_tree_edges.empty()) {
+    if (num_seams == 0 && !non_tree_edges.empty()) {
         // Pick the "sharpest" available non-tree edge to cut
         int best_e = -1; 
         float max_s = -1.0f;
         for (int e : non_tree_edges) {
-            int f0 = edge_faces[2*e + 0];
-            int f1 = edge_faces[2*e + 1];
-            float s = get_edge_sharpness(mesh, f0, f1);
+            float s = sharpness[e];
             if (s > max_s) { max_s = s; best_e = e; }
         }
-        if(best_e != -1) seam_candidates.insert(best_e);
+        if(best_e != -1) add_seam(best_e);
     }
    
     
     //4. Angular defect refinement
+    //   Defects for all vertices in one pass over the faces, then one pass
+    //   over the edges, checking both endpoints: linear in mesh size, with
+    //   no vertex→edge table to build
 
     const float defect_threshold = 0.5f; 
 
-    for (int v = 0; v < V; ++v) {
-        float defect = compute_angular_defect(mesh, v);
-
-        if (defect > defect_threshold) {
-            std::vector<int> incident_edges = get_vertex_edges(topo, v);
-            for (int e : incident_edges) {
-                // Only add if it's already a valid candidate (non-tree)
-                // or if you want to force cuts at corners regardless of tree
-                bool is_non_tree = false;
-                for(int nte : non_tree_edges) if(nte == e) is_non_tree = true;
-                
-                if (is_non_tree) {
-                    seam_candidates.insert(e);
-                }
-            }
+    std::vector<float> defects(V);
+    compute_angular_defects(mesh, defects.data());
+
+    for (int e = 0; e < E; ++e) {
+        // Only add if it's already a valid candidate (non-tree)
+        if (!is_non_tree[e]) continue;
+        if (defects[topo->edges[2*e]] > defect_threshold ||
+            defects[topo->edges[2*e + 1]] > defect_threshold) {
+            add_seam(e);
         }
     }
 
     // 5.Convert to array
-    if (seam_candidates.empty()){
+    if (num_seams == 0){
         *num_seams_out = 0;
         return NULL;
     }
 
-    *num_seams_out = (int)seam_candidates.size();
+    *num_seams_out = num_seams;
     int* seams = (int*)malloc(*num_seams_out * sizeof(int));
 
     if(!seams){
@@ -311,8 +354,8 @@ int* detect_seams(const Mesh* mesh,
         return NULL;
     }
     int idx = 0;
-    for (int edge_idx : seam_candidates) {
-        seams[idx++] = edge_idx;
+    for (int e = 0; e < E; ++e) {
+        if (is_seam[e]) seams[idx++] = e;
     }
 
     printf("Detected %d seams\n", *num_seams_out);
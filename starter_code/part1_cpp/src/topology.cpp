@@ -14,72 +14,348 @@
 #include "topology.h"
 #include <stdlib.h>
 #include <stdio.h>
-#include <map>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include "mesh.h"
+#include "parallel.h"
+
+/** Faces per thread below which the parallel builder is not worth it */
+static const size_t TOPOLOGY_MIN_FACES_PER_THREAD = 65536;
+
+/**
+ * @brief One triangle side, keyed by its sorted vertex pair
+ *
+ * key packs (v0 << 32 | v1) with v0 < v1, so ordering the keys as integers
+ * gives the same (v0, v1) lexicographic order as the old std::map<Edge>.
+ * corner = 3 * face + k identifies the side (k-th edge of the face).
+ */
+struct HalfEdgeRecord {
+    uint64_t key;
+    int corner;
+};
+
+static inline uint64_t pack_edge_key(int a, int b) {
+    // Always store smaller vertex first
+    if (a > b) { int t = a; a = b; b = t; }
+    return ((uint64_t)(uint32_t)a << 32) | (uint64_t)(uint32_t)b;
+}
+
+static inline int key_v0(uint64_t key) { return (int)(key >> 32); }
+static inline int key_v1(uint64_t key) { return (int)(key & 0xffffffffu); }
 
 /**
- * @brief Edge structure for uniqueness
+ * @brief Gather the non-degenerate sides of valid triangles [face_begin, face_end), in face order
  */
-struct Edge {
-    int v0, v1;
-
-    Edge(int a, int b) {
-        // Always store smaller vertex first
-        if (a < b) {
-            v0 = a;
-            v1 = b;
+static void collect_half_edges(const Mesh* mesh, int face_begin, int face_end,
+                               std::vector<HalfEdgeRecord>& out) {
+    const int V = mesh->num_vertices;
+    const int* tris = mesh->triangles;
+
+    out.clear();
+    out.reserve((size_t)(face_end - face_begin) * 3);
+
+    for (int f = face_begin; f < face_end; ++f) {
+        int idx0 = tris[3*f + 0];
+        int idx1 = tris[3*f + 1];
+        int idx2 = tris[3*f + 2];
+
+        if(idx0 < 0 || idx0 >= V||
+           idx1 < 0 || idx1 >= V||
+           idx2 < 0 || idx2 >= V) {
+            printf("Error: Triangle %d has invalid vertex indices\n", f); // skipping invalid traingle
+            continue;
+        }
+
+        // if triangle is degenerate, skip the degenerate sides but keep the others
+        const int corners[3] = {idx0, idx1, idx2};
+        for (int k = 0; k < 3; ++k) {
+            int a = corners[k];
+            int b = corners[(k + 1) % 3];
+            if (a == b) continue;
+            HalfEdgeRecord r;
+            r.key = pack_edge_key(a, b);
+            r.corner = 3*f + k;
+            out.push_back(r);
+        }
+    }
+}
+
+/**
+ * @brief Stable LSD radix sort on the 64-bit keys (16-bit digits)
+ *
+ * Digits that are identical for every record are skipped, so meshes with
+ * fewer than 65536 vertices only pay for two of the four passes.
+ * Stability keeps records with equal keys in face order.
+ */
+static void radix_sort_half_edges(std::vector<HalfEdgeRecord>& recs) {
+    const size_t n = recs.size();
+    if (n < 2) return;
+
+    std::vector<HalfEdgeRecord> tmp(n);
+    std::vector<size_t> count(1 << 16);
+
+    for (int shift = 0; shift < 64; shift += 16) {
+        std::fill(count.begin(), count.end(), 0);
+        for (size_t i = 0; i < n; ++i) {
+            count[(recs[i].key >> shift) & 0xffff]++;
+        }
+        // All records share this digit: the pass would be the identity
+        if (count[(recs[0].key >> shift) & 0xffff] == n) continue;
+
+        size_t sum = 0;
+        for (size_t d = 0; d < count.size(); ++d) {
+            size_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            tmp[count[(recs[i].key >> shift) & 0xffff]++] = recs[i];
+        }
+        recs.swap(tmp);
+    }
+}
+
+static void warn_non_manifold(uint64_t key, int face, int face0, int face1) {
+    printf("Warning: non-manifold edge (%d, %d) seen at face %d (already has faces %d and %d)\n",
+           key_v0(key), key_v1(key), face, face0, face1);
+}
+
+/**
+ * @brief Sorted builder: edges come out in (v0,v1) order
+ */
+static void build_edges_sorted(std::vector<HalfEdgeRecord>& recs,
+                               std::vector<int>& edges,
+                               std::vector<int>& edge_faces,
+                               int* face_edges) {
+    radix_sort_half_edges(recs);
+
+    const size_t n = recs.size();
+    for (size_t i = 0; i < n; ) {
+        uint64_t key = recs[i].key;
+        int e = (int)(edge_faces.size() / 2);
+        int face0 = recs[i].corner / 3;
+        int face1 = -1;
+        face_edges[recs[i].corner] = e;
+        size_t j = i + 1;
+        if (j < n && recs[j].key == key) {
+            face1 = recs[j].corner / 3;
+            face_edges[recs[j].corner] = e;
+            ++j;
+        }
+        for (; j < n && recs[j].key == key; ++j) {
+            warn_non_manifold(key, recs[j].corner / 3, face0, face1);
+            face_edges[recs[j].corner] = e;
+        }
+
+        edges.push_back(key_v0(key));
+        edges.push_back(key_v1(key));
+        edge_faces.push_back(face0);
+        edge_faces.push_back(face1); // -1 if boundary
+        i = j;
+    }
+}
+
+/**
+ * @brief Hash builder: edges come out in first-seen order
+ *
+ * Open addressing with linear probing; the table is sized to at least
+ * twice the number of half-edges so the load factor stays below 0.5.
+ */
+static void build_edges_hashed(const std::vector<HalfEdgeRecord>& recs,
+                               std::vector<int>& edges,
+                               std::vector<int>& edge_faces,
+                               int* face_edges) {
+    const uint64_t EMPTY = ~(uint64_t)0;
+
+    size_t capacity = 16;
+    while (capacity < recs.size() * 2) capacity <<= 1;
+    const size_t mask = capacity - 1;
+
+    std::vector<uint64_t> slot_key(capacity, EMPTY);
+    std::vector<int> slot_edge(capacity, -1);
+
+    for (const HalfEdgeRecord& r : recs) {
+        // Fibonacci hashing spreads the packed (v0,v1) pairs over the table
+        size_t h = (size_t)((r.key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (slot_key[h] != EMPTY && slot_key[h] != r.key) {
+            h = (h + 1) & mask;
+        }
+
+        int face = r.corner / 3;
+        if (slot_key[h] == EMPTY) {
+            slot_key[h] = r.key;
+            slot_edge[h] = (int)(edge_faces.size() / 2);
+            edges.push_back(key_v0(r.key));
+            edges.push_back(key_v1(r.key));
+            edge_faces.push_back(face);
+            edge_faces.push_back(-1);
+            face_edges[r.corner] = slot_edge[h];
+            continue;
+        }
+
+        int e = slot_edge[h];
+        face_edges[r.corner] = e;
+        if (edge_faces[2*e + 1] == -1) {
+            edge_faces[2*e + 1] = face;
         } else {
-            v0 = b;
-            v1 = a;
+            warn_non_manifold(r.key, face, edge_faces[2*e], edge_faces[2*e + 1]);
         }
     }
+}
 
-    bool operator<(const Edge& other) const {
-        if (v0 != other.v0) return v0 < other.v0;
-        return v1 < other.v1;
+/**
+ * @brief Parallel version of radix_sort_half_edges
+ *
+ * Each thread histograms its slice; offsets are laid out digit-major then
+ * thread-major, so every pass is a stable scatter and the result is the
+ * same as the serial sort for any thread count.
+ */
+static void parallel_radix_sort_half_edges(std::vector<HalfEdgeRecord>& recs, int num_threads) {
+    const size_t n = recs.size();
+    if (n < 2) return;
+
+    const size_t RADIX = 1 << 16;
+    std::vector<HalfEdgeRecord> tmp(n);
+    std::vector<std::vector<size_t>> count(num_threads, std::vector<size_t>(RADIX));
+
+    for (int shift = 0; shift < 64; shift += 16) {
+        parallel_for_chunks(num_threads, n, [&](int t, size_t b, size_t e) {
+            std::vector<size_t>& c = count[t];
+            std::fill(c.begin(), c.end(), 0);
+            for (size_t i = b; i < e; ++i) c[(recs[i].key >> shift) & 0xffff]++;
+        });
+
+        size_t first_digit = (recs[0].key >> shift) & 0xffff;
+        size_t same = 0;
+        for (int t = 0; t < num_threads; ++t) same += count[t][first_digit];
+        if (same == n) continue;
+
+        size_t sum = 0;
+        for (size_t d = 0; d < RADIX; ++d) {
+            for (int t = 0; t < num_threads; ++t) {
+                size_t c = count[t][d];
+                count[t][d] = sum;
+                sum += c;
+            }
+        }
+
+        parallel_for_chunks(num_threads, n, [&](int t, size_t b, size_t e) {
+            std::vector<size_t>& c = count[t];
+            for (size_t i = b; i < e; ++i) {
+                tmp[c[(recs[i].key >> shift) & 0xffff]++] = recs[i];
+            }
+        });
+        recs.swap(tmp);
     }
-};
+}
 
 /**
- * @brief Edge information
+ * @brief Parallel sorted builder: per-thread edge lists, parallel sort, parallel dedupe
+ *
+ * A run of equal keys belongs to the thread whose slice contains its first
+ * record, so runs that straddle a slice boundary are emitted exactly once.
  */
-struct EdgeInfo {
-    int face0;
-    int face1;
+static void build_edges_parallel(const Mesh* mesh, int num_threads,
+                                 std::vector<HalfEdgeRecord>& recs,
+                                 std::vector<int>& edges,
+                                 std::vector<int>& edge_faces,
+                                 int* face_edges) {
+    const int F = mesh->num_triangles;
+
+    // 1. Per-thread edge lists over contiguous face chunks
+    std::vector<std::vector<HalfEdgeRecord>> local(num_threads);
+    parallel_for_chunks(num_threads, (size_t)F, [&](int t, size_t b, size_t e) {
+        collect_half_edges(mesh, (int)b, (int)e, local[t]);
+    });
+
+    std::vector<size_t> offset(num_threads + 1, 0);
+    for (int t = 0; t < num_threads; ++t) offset[t + 1] = offset[t] + local[t].size();
+    recs.resize(offset[num_threads]);
+    parallel_for_chunks(num_threads, (size_t)num_threads, [&](int, size_t b, size_t e) {
+        for (size_t t = b; t < e; ++t) {
+            std::copy(local[t].begin(), local[t].end(), recs.begin() + offset[t]);
+            std::vector<HalfEdgeRecord>().swap(local[t]);
+        }
+    });
+
+    // 2. Parallel sort
+    parallel_radix_sort_half_edges(recs, num_threads);
+
+    // 3. Dedupe: count run starts per slice, then write runs at their prefix offsets
+    const size_t n = recs.size();
+    std::vector<size_t> runs(num_threads + 1, 0);
+    parallel_for_chunks(num_threads, n, [&](int t, size_t b, size_t e) {
+        size_t c = 0;
+        for (size_t i = b; i < e; ++i) {
+            if (i == 0 || recs[i].key != recs[i - 1].key) ++c;
+        }
+        runs[t + 1] = c;
+    });
+    for (int t = 0; t < num_threads; ++t) runs[t + 1] += runs[t];
+
+    const size_t E = runs[num_threads];
+    edges.resize(2 * E);
+    edge_faces.resize(2 * E);
+
+    parallel_for_chunks(num_threads, n, [&](int t, size_t b, size_t e) {
+        size_t out = runs[t];
+        size_t i = b;
+        while (i < e && i > 0 && recs[i].key == recs[i - 1].key) ++i;  // run owned by previous slice
+        while (i < e) {
+            uint64_t key = recs[i].key;
+            int face0 = recs[i].corner / 3;
+            int face1 = -1;
+            face_edges[recs[i].corner] = (int)out;
+            size_t j = i + 1;
+            if (j < n && recs[j].key == key) {
+                face1 = recs[j].corner / 3;
+                face_edges[recs[j].corner] = (int)out;
+                ++j;
+            }
+            for (; j < n && recs[j].key == key; ++j) {
+                warn_non_manifold(key, recs[j].corner / 3, face0, face1);
+                face_edges[recs[j].corner] = (int)out;
+            }
 
-    EdgeInfo() : face0(-1), face1(-1) {}
-};
+            edges[2*out + 0] = key_v0(key);
+            edges[2*out + 1] = key_v1(key);
+            edge_faces[2*out + 0] = face0;
+            edge_faces[2*out + 1] = face1; // -1 if boundary
+            ++out;
+            i = j;
+        }
+    });
+}
 
 TopologyInfo* build_topology(const Mesh* mesh) {
+    return build_topology_ex(mesh, NULL, NULL);
+}
+
+TopologyInfo* build_topology_ex(const Mesh* mesh,
+                                const TopologyOptions* options,
+                                TopologyStats* stats_out) {
     if (!mesh) return NULL;
 
-    // TODO: Implement topology building
-    //
-    // Steps:
-    // 1. Create std::map<Edge, EdgeInfo> to collect edges
-    // 2. Iterate through all triangles
-    //    For each triangle, extract 3 edges
-    //    Add to map, tracking which faces use each edge
-    // 3. Convert map to arrays (edges, edge_faces)
-    // 4. Allocate TopologyInfo and fill arrays
-    //
-    // Hints:
-    // - Use Edge struct for automatic ordering
-    // - Each edge should have 1 or 2 adjacent faces
-    // - Boundary edges have only 1 face (set face1 = -1)
-    //
-    // See reference/topology_example.cpp for complete example
+    if (stats_out) {
+        stats_out->build_seconds = 0.0;
+        stats_out->edges_per_second = 0.0;
+    }
 
     TopologyInfo* topo = (TopologyInfo*)malloc(sizeof(TopologyInfo));
     if (!topo) return NULL;
 
-    // Initialize to safe defaults (prevents crashes before implementation)
+    // Initialize to safe defaults
     topo->edges = NULL;
     topo->num_edges = 0;
     topo->edge_faces = NULL;
+    topo->face_edges = NULL;
+    topo->halfedge = NULL;
+    topo->face_geometry = NULL;
+    topo->edge_sharpness = NULL;
 
-    // TODO: Your implementation here
     int V = mesh->num_vertices;
     int F = mesh->num_triangles;
     const int* tris = mesh->triangles;
@@ -88,52 +364,46 @@ TopologyInfo* build_topology(const Mesh* mesh) {
         return topo;
     }
 
-    std::map<Edge, EdgeInfo> edge_map;
-    edge_map.clear();
+    const bool ordered = options ? (options->ordered_edges != 0) : true;
 
-    for (int f = 0; f < F; ++f) { // no copy using ++f
-        int idx0 = tris[3*f + 0];
-        int idx1 = tris[3*f + 1];
-        int idx2 = tris[3*f + 2];
+    // The hashed builder is inherently serial; only the sorted path is split up
+    int num_threads = 1;
+    if (ordered) {
+        num_threads = resolve_thread_count(options ? options->num_threads : 0);
+        num_threads = limit_thread_count(num_threads, (size_t)F, TOPOLOGY_MIN_FACES_PER_THREAD);
+    }
 
-        if(idx0 < 0 || idx0 >= V||
-           idx1 < 0 || idx1 >= V||
-           idx2 < 0 || idx2 >= V) {
-            printf("Error: Triangle %d has invalid vertex indices\n", f); // skipping invalid traingle
-            continue;
-           }
-        
-        // if triangle is degenerate, skipping edge insertion but try adding non degenerate edges
-
-        struct { int a,b; } tri_edges[3] = {
-            {idx0, idx1},
-            {idx1, idx2},
-            {idx2, idx0}
-        };
-
-        for (int e = 0; e < 3 ; ++e){
-            int a = tri_edges[e].a;
-            int b = tri_edges[e].b;
-            if (a == b) {
-                // Degenerate edge, skip
-                continue;
-            }
-            Edge key(a,b);
-            EdgeInfo& info = edge_map[key];
-            if (info.face0 == -1){
-                info.face0 = f;
-            }else if (info.face1 == -1){
-                info.face1 = f;
-            }else{
-                printf("Warning: non-manifold edge (%d, %d) seen at face %d (already has faces %d and %d)\n",
-                       key.v0, key.v1, f, info.face0, info.face1);
-            }
-            }
+    auto t_start = std::chrono::steady_clock::now();
+
+    // Sides of invalid triangles and degenerate sides keep -1
+    int* face_edges = (int*)malloc(sizeof(int) * 3 * (size_t)F);
+    if (!face_edges) {
+        printf("Error: malloc failed in build_topology\n");
+        free(topo);
+        return NULL;
+    }
+    for (int i = 0; i < 3 * F; ++i) face_edges[i] = -1;
+
+    std::vector<HalfEdgeRecord> recs;
+    std::vector<int> edge_list;
+    std::vector<int> face_list;
+
+    if (num_threads > 1) {
+        build_edges_parallel(mesh, num_threads, recs, edge_list, face_list, face_edges);
+    } else {
+        collect_half_edges(mesh, 0, F, recs);
+        edge_list.reserve(recs.size());
+        face_list.reserve(recs.size());
+        if (ordered) {
+            build_edges_sorted(recs, edge_list, face_list, face_edges);
+        } else {
+            build_edges_hashed(recs, edge_list, face_list, face_edges);
         }
+    }
 
-    // Convert map to arrays
-    size_t E = edge_map.size();
+    size_t E = face_list.size() / 2;
     if (E == 0) {
+        free(face_edges);
         topo->num_edges = 0;
         return topo; // no valid edges found
     }
@@ -144,37 +414,45 @@ TopologyInfo* build_topology(const Mesh* mesh) {
         printf("Error: malloc failed in build_topology\n");
         if (edges) free(edges);
         if (edge_faces) free(edge_faces);
-        // topo->num_edges = 0;
+        free(face_edges);
         free(topo);
-        // return topo;
         return NULL;
     }
-
-    // filling arrays
-    size_t i = 0;
-    for (const auto &kv : edge_map) {
-        const Edge &key = kv.first;
-        const EdgeInfo &info = kv.second;
-
-        edges[2*i + 0] = key.v0;
-        edges[2*i + 1] = key.v1;
-
-        edge_faces[2*i + 0] = info.face0;
-        edge_faces[2*i + 1] = info.face1; // -1 if boundary
-
-        ++i;
-    }
+    memcpy(edges, edge_list.data(), sizeof(int) * 2 * E);
+    memcpy(edge_faces, face_list.data(), sizeof(int) * 2 * E);
 
     topo->edges = edges;
     topo->edge_faces = edge_faces;
+    topo->face_edges = face_edges;
     topo->num_edges = (int)E;
 
-    
-    // validate_topology(mesh, topo);  // for validation 
-
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t_start).count();
+    double rate = (seconds > 0.0) ? (double)E / seconds : 0.0;
+    if (stats_out) {
+        stats_out->build_seconds = seconds;
+        stats_out->edges_per_second = rate;
+    }
+    printf("Topology: %d edges in %.3f ms (%.2f M edges/s, %s, %d thread%s)\n",
+           (int)E, seconds * 1000.0, rate * 1e-6, ordered ? "sorted" : "hashed",
+           num_threads, num_threads == 1 ? "" : "s");
+
+    // Shared adjacency for the later stages (seams, islands, LSCM, packing)
+    topo->halfedge = build_halfedge_mesh(mesh, topo);
+
+    // Normals are computed once; seam sharpness becomes a dot product per edge
+    topo->face_geometry = compute_face_geometry(mesh);
+    topo->edge_sharpness = (float*)malloc(sizeof(float) * E);
+    if (topo->face_geometry && topo->edge_sharpness) {
+        compute_edge_sharpness(topo->face_geometry, topo->edge_faces, topo->num_edges,
+                               topo->edge_sharpness);
+    } else {
+        free(topo->edge_sharpness);
+        topo->edge_sharpness = NULL;
+    }
 
     return topo;
-} 
+}
 
 
 void free_topology(TopologyInfo* topo) {
@@ -182,6 +460,10 @@ void free_topology(TopologyInfo* topo) {
 
     if (topo->edges) free(topo->edges);
     if (topo->edge_faces) free(topo->edge_faces);
+    if (topo->face_edges) free(topo->face_edges);
+    free_halfedge_mesh(topo->halfedge);
+    free_face_geometry(topo->face_geometry);
+    if (topo->edge_sharpness) free(topo->edge_sharpness);
     free(topo);
 }
 
@@ -14,99 +14,150 @@
 
 #include "unwrap.h"
 #include "lscm.h"
+#include "abf.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
 #include <vector>
-#include <set>
-#include <map>
-#include <queue>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "parallel.h"
+
+/** Edges per thread below which island extraction stays serial */
+static const size_t ISLAND_MIN_EDGES_PER_THREAD = 65536;
+/** Vertices per thread below which the UV write-back stays serial */
+static const size_t UV_COPY_MIN_VERTICES_PER_THREAD = 65536;
 
 /**
- * @brief Extract UV islands after seam cuts
- *
- * Uses connected components algorithm on face graph after removing seam edges.
+ * @brief Root of face f, halving the path on the way up
  *
- * @param mesh Input mesh
- * @param topo Topology info
- * @param seam_edges Array of seam edge indices
- * @param num_seams Number of seams
- * @param num_islands_out Output: number of islands
- * @return Array of island IDs per face
+ * Safe under concurrent unions: parents only ever move to a smaller index
+ * that is in the same set. A failed halving CAS reloads parent[f] and
+ * retries from f, so the walk never leaves f on a stale parent.
  */
-static int* extract_islands(const Mesh* mesh,
-                           const TopologyInfo* topo,
-                           const int* seam_edges,
-                           int num_seams,
-                           int* num_islands_out) {
-    // TODO: Implement island extraction
-    //
-    // Algorithm:
-    // 1. Build face adjacency graph (faces connected by non-seam edges)
-    // 2. Run connected components (BFS or DFS)
-    // 3. Assign island ID to each face
-    //
-    // Steps:
-    // 1. Create std::set<int> of seam edge indices for fast lookup
-    // 2. Build adjacency list for faces (only through non-seam edges)
-    // 3. Run BFS/DFS to find connected components
-    // 4. Return array of island IDs (one per face)
-    int num_faces = mesh->num_triangles;
-    int* face_island_ids = (int*)malloc(mesh->num_triangles * sizeof(int));
-
-    // Initialize all to -1 (unvisited)
-    for (int i = 0; i < mesh->num_triangles; i++) {
-        face_island_ids[i] = -1;
+static int island_find(std::atomic<int>* parent, int f) {
+    int p = parent[f].load(std::memory_order_relaxed);
+    while (p != f) {
+        int gp = parent[p].load(std::memory_order_relaxed);
+        if (gp == p) return p;
+        if (parent[f].compare_exchange_weak(p, gp, std::memory_order_relaxed)) {
+            f = gp;
+            p = parent[f].load(std::memory_order_relaxed);
+        }
     }
+    return f;
+}
 
-    // YOUR CODE HERE
-    //1
-    std::set<int> seam_set;
-    if(seam_edges){
-        for(int i = 0; i < num_seams; i++){
-            seam_set.insert(seam_edges[i]);
-        }
+/** Root of face f without compressing; only once every union has finished */
+static int island_root(const std::atomic<int>* parent, int f) {
+    for (int p = parent[f].load(std::memory_order_relaxed); p != f;
+         p = parent[f].load(std::memory_order_relaxed)) {
+        f = p;
+    }
+    return f;
+}
+
+/**
+ * @brief Lock-free union: the larger root is linked under the smaller one
+ *
+ * Linking by index keeps every root at the lowest face of its set, so the
+ * final roots do not depend on the order in which threads apply unions.
+ */
+static void island_union(std::atomic<int>* parent, int a, int b) {
+    for (;;) {
+        a = island_find(parent, a);
+        b = island_find(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        int expected = a;
+        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
     }
-    //2
-    std::vector<std::vector<int>> face_adj(num_faces);
-    int E = topo->num_edges;
+}
+
+int* extract_islands(const Mesh* mesh,
+                     const TopologyInfo* topo,
+                     const int* seam_edges,
+                     int num_seams,
+                     int num_threads,
+                     int* num_islands_out,
+                     int** island_offsets_out,
+                     int** island_faces_out) {
+    const int num_faces = mesh->num_triangles;
+    const int E = topo->num_edges;
     const int* edge_faces = topo->edge_faces;
-    for(int e = 0; e < E; e++){
-        if(seam_set.find(e)!= seam_set.end()){
-            continue;
-        }
-        int f0 = edge_faces[2*e + 0];
-        int f1 = edge_faces[2*e + 1];   
 
-        if(f0!= -1 && f1 != -1){
-            face_adj[f0].push_back(f1);
-            face_adj[f1].push_back(f0);
-        }
+    *num_islands_out = 0;
+    *island_offsets_out = NULL;
+    *island_faces_out = NULL;
+
+    int* face_island_ids = (int*)malloc(sizeof(int) * (num_faces > 0 ? num_faces : 1));
+    if (!face_island_ids) return NULL;
+
+    // 1. Seam bitset
+    std::vector<uint64_t> seam_bits(((size_t)E + 63) / 64, 0);
+    for (int i = 0; seam_edges && i < num_seams; i++) {
+        int e = seam_edges[i];
+        if (e >= 0 && e < E) seam_bits[e >> 6] |= (uint64_t)1 << (e & 63);
     }
 
-    //3
+    // 2. Concurrent union over interior, non-seam edges
+    std::unique_ptr<std::atomic<int>[]> parent(new std::atomic<int>[num_faces > 0 ? num_faces : 1]);
+    for (int f = 0; f < num_faces; f++) parent[f].store(f, std::memory_order_relaxed);
+
+    int threads = limit_thread_count(resolve_thread_count(num_threads), (size_t)E,
+                                     ISLAND_MIN_EDGES_PER_THREAD);
+    parallel_for_chunks(threads, (size_t)E, [&](int, size_t b, size_t end) {
+        for (size_t e = b; e < end; e++) {
+            int f0 = edge_faces[2*e];
+            int f1 = edge_faces[2*e + 1];
+            if (f0 < 0 || f1 < 0) continue;
+            if (seam_bits[e >> 6] & ((uint64_t)1 << (e & 63))) continue;
+            island_union(parent.get(), f0, f1);
+        }
+    });
+
+    // 3. Roots are the lowest face of each island: number them in face order
+    threads = limit_thread_count(resolve_thread_count(num_threads), (size_t)num_faces,
+                                 ISLAND_MIN_EDGES_PER_THREAD);
+    parallel_for_chunks(threads, (size_t)num_faces, [&](int, size_t b, size_t end) {
+        for (size_t f = b; f < end; f++) face_island_ids[f] = island_root(parent.get(), (int)f);
+    });
+
     int island_count = 0;
-    for(int start_face = 0; start_face < num_faces; start_face++){
-        if(face_island_ids[start_face]!= -1) continue;
-        int current_island = island_count++;
-        face_island_ids[start_face] = current_island;
-
-        std::queue<int> q;
-        q.push(start_face);
-
-        while(!q.empty()){
-            int u = q.front();
-            q.pop();
-
-            for(int v : face_adj[u]){
-                if(face_island_ids[v]== -1 ){
-                    face_island_ids[v] = current_island;
-                    q.push(v);
-                }
-            }
+    for (int f = 0; f < num_faces; f++) {
+        if (face_island_ids[f] == f) face_island_ids[f] = -(++island_count);  // -(id + 1)
+    }
+    parallel_for_chunks(threads, (size_t)num_faces, [&](int, size_t b, size_t end) {
+        for (size_t f = b; f < end; f++) {
+            int root = face_island_ids[f];
+            if (root >= 0) face_island_ids[f] = -face_island_ids[root] - 1;
         }
+    });
+    // Roots themselves still hold -(id + 1); every non-root has been resolved
+    for (int f = 0; f < num_faces; f++) {
+        if (face_island_ids[f] < 0) face_island_ids[f] = -face_island_ids[f] - 1;
+    }
 
+    // 4. Island→faces CSR by counting sort
+    int* offsets = (int*)calloc((size_t)island_count + 1, sizeof(int));
+    int* faces = (int*)malloc(sizeof(int) * (num_faces > 0 ? num_faces : 1));
+    if (!offsets || !faces) {
+        printf("Error: malloc failed in extract_islands\n");
+        free(offsets);
+        free(faces);
+        free(face_island_ids);
+        return NULL;
     }
-    *num_islands_out = island_count;  // Update this with actual count
+    for (int f = 0; f < num_faces; f++) offsets[face_island_ids[f] + 1]++;
+    for (int i = 0; i < island_count; i++) offsets[i + 1] += offsets[i];
+    std::vector<int> cursor(offsets, offsets + island_count);
+    for (int f = 0; f < num_faces; f++) faces[cursor[face_island_ids[f]]++] = f;
+
+    *num_islands_out = island_count;
+    *island_offsets_out = offsets;
+    *island_faces_out = faces;
 
     printf("Extracted %d UV islands\n", *num_islands_out);
 
@@ -115,39 +166,25 @@ static int* extract_islands(const Mesh* mesh,
 
 /**
  * @brief Copy UVs from island parameterization to result mesh
+ *
+ * local_to_global is the remap LSCM used for this island, so the write-back
+ * is one pass over the island's vertices with no lookups. Only vertices
+ * owned by this island are written (see STEP 4), so islands copied
+ * concurrently never store to the same UV.
  */
 static void copy_island_uvs(Mesh* result,
                            const float* island_uvs,
-                           const int* face_indices,
-                           int num_faces,
-                           const std::map<int, int>& global_to_local) {
-    // TODO: Implement UV copying
-    //
-    // For each face in the island:
-    //   For each vertex in the face:
-    //     global_idx = vertex index in mesh
-    //     local_idx = global_to_local[global_idx]
-    //     result->uvs[global_idx * 2] = island_uvs[local_idx * 2]
-    //     result->uvs[global_idx * 2 + 1] = island_uvs[local_idx * 2 + 1]
-
-    // YOUR CODE HERE
-    const int* tris = result->triangles;
-
-    for (int i = 0; i < num_faces; i++) {
-        int f = face_indices[i];
-        
-        for (int j = 0; j < 3; j++) {
-            int global_idx = tris[3*f + j];
-            auto it = global_to_local.find(global_idx);
-            if (it != global_to_local.end()) {
-                int local_idx = it->second;
-                
-                result->uvs[2*global_idx]     = island_uvs[2*local_idx];
-                result->uvs[2*global_idx + 1] = island_uvs[2*local_idx + 1];
-            }
-        }
+                           const int* local_to_global,
+                           int num_local,
+                           const int* vertex_owner,
+                           int island_id) {
+    for (int local_idx = 0; local_idx < num_local; local_idx++) {
+        int global_idx = local_to_global[local_idx];
+        if (vertex_owner[global_idx] != island_id) continue;
+
+        result->uvs[2*global_idx]     = island_uvs[2*local_idx];
+        result->uvs[2*global_idx + 1] = island_uvs[2*local_idx + 1];
     }
-
 }
 
 Mesh* unwrap_mesh(const Mesh* mesh,
@@ -166,6 +203,11 @@ Mesh* unwrap_mesh(const Mesh* mesh,
     printf("  Min island faces: %d\n", params->min_island_faces);
     printf("  Pack islands: %s\n", params->pack_islands ? "yes" : "no");
     printf("  Island margin: %.3f\n", params->island_margin);
+    printf("  Seam method: %s\n", params->seam_method == SEAM_METHOD_MST ? "MST" : "sorted BFS");
+    printf("  Parameterization: %s\n", params->param_method == PARAM_METHOD_ABF ? "ABF++" : "LSCM");
+    if (params->pack_islands && params->udim_texel_density > 0.0f) {
+        printf("  UDIM texel density: %.1f texels/unit\n", params->udim_texel_density);
+    }
     printf("\n");
 
     // TODO: Implement main unwrapping pipeline
@@ -180,11 +222,25 @@ Mesh* unwrap_mesh(const Mesh* mesh,
 
     // STEP 2: Detect seams
     int num_seams;
-    int* seam_edges = detect_seams(mesh, topo, params->angle_threshold, &num_seams);
+    SeamOptions seam_options;
+    seam_options.angle_threshold = params->angle_threshold;
+    seam_options.method = params->seam_method;
+    seam_options.num_threads = params->num_threads;
+    seam_options.sharp_edges = NULL;
+    int* seam_edges = detect_seams_ex(mesh, topo, &seam_options, &num_seams);
 
     // STEP 3: Extract islands
     int num_islands;
-    int* face_island_ids = extract_islands(mesh, topo, seam_edges, num_seams, &num_islands);
+    int* island_offsets = NULL;
+    int* island_faces = NULL;
+    int* face_island_ids = extract_islands(mesh, topo, seam_edges, num_seams, params->num_threads,
+                                           &num_islands, &island_offsets, &island_faces);
+    if (!face_island_ids) {
+        fprintf(stderr, "Failed to extract islands\n");
+        free_topology(topo);
+        free(seam_edges);
+        return NULL;
+    }
 
     Mesh* result = allocate_mesh_copy(mesh);
     
@@ -193,6 +249,8 @@ Mesh* unwrap_mesh(const Mesh* mesh,
         free_topology(topo);
         free(seam_edges);
         free(face_island_ids);
+        free(island_offsets);
+        free(island_faces);
         return NULL;
     }
 
@@ -203,53 +261,127 @@ Mesh* unwrap_mesh(const Mesh* mesh,
     
 
     // STEP 4: Parameterize each island using LSCM
-
+    //   Islands are independent, so they run on a work-stealing pool,
+    //   largest first, and keep their UVs until all are done. A vertex on a
+    //   seam belongs to several islands; it takes its UV from the
+    //   highest-numbered island that was parameterized, or, if none of its
+    //   islands was, is assigned to the highest one for packing. Output is
+    //   therefore identical for every thread count.
+
+    std::vector<int> island_order;
+    std::vector<int> vertex_owner(mesh->num_vertices, -1);
     for (int island_id = 0; island_id < num_islands; island_id++) {
-        printf("\nProcessing island %d/%d...\n", island_id + 1, num_islands);
-
-        // Get faces in this island
-        std::vector<int> island_faces;
-        for (int f = 0; f < mesh->num_triangles; f++) {
-            if (face_island_ids[f] == island_id) {
-                island_faces.push_back(f);
+        // build_topology skips faces with out-of-range corners, and each
+        // becomes a singleton island here; only valid corners get an owner,
+        // and such an island is never parameterized
+        bool valid = true;
+        for (int k = island_offsets[island_id]; k < island_offsets[island_id + 1]; k++) {
+            const int f = island_faces[k];
+            for (int j = 0; j < 3; j++) {
+                const int v = mesh->triangles[3*f + j];
+                if (v >= 0 && v < mesh->num_vertices) vertex_owner[v] = island_id;
+                else valid = false;
             }
         }
-
-        printf("  %d faces in island\n", (int)island_faces.size());
-
-        if ((int)island_faces.size() < params->min_island_faces) {
-            printf("  Skipping (too small)\n");
+        const int num_faces = island_offsets[island_id + 1] - island_offsets[island_id];
+        if (!valid) {
+            printf("  Skipping island %d (invalid vertex indices)\n", island_id + 1);
+            continue;
+        }
+        if (num_faces < params->min_island_faces) {
+            printf("  Skipping island %d (%d faces, too small)\n", island_id + 1, num_faces);
             continue;
         }
+        island_order.push_back(island_id);
+    }
+    std::stable_sort(island_order.begin(), island_order.end(), [&](int a, int b) {
+        return island_offsets[a + 1] - island_offsets[a] > island_offsets[b + 1] - island_offsets[b];
+    });
 
-        // YOUR CODE HERE:
-        // - Call lscm_parameterize
-        // - Build global_to_local mapping
-        // - Copy UVs to result mesh
-        float* island_uvs = lscm_parameterize(mesh, island_faces.data(), (int)island_faces.size());
-        if(island_uvs){
-            std::map<int, int> global_to_local;
-            int local_idx = 0;
-            const int* tris = mesh->triangles;
-            
-            for(int f : island_faces){
-                for(int j = 0; j <3 ; j++){
-                    int g_idx = tris[3*f + j];
-                    if(global_to_local.find(g_idx) == global_to_local.end()){
-                        global_to_local[g_idx] = local_idx++;
-                    }
-                }
-            }
-            copy_island_uvs(result, island_uvs, island_faces.data(), (int)island_faces.size(), global_to_local);
-            free(island_uvs);
+    // Split the thread budget: with many islands each solve runs serially,
+    // with few the solves get the threads the pool leaves idle
+    const int island_threads = resolve_thread_count(params->num_threads);
+    const int pool_threads = std::min(island_threads, std::max((int)island_order.size(), 1));
+    const int solve_threads = std::max(1, island_threads / pool_threads);
+    printf("Parameterizing %d islands on %d threads\n", (int)island_order.size(), pool_threads);
+
+    std::vector<float*> island_uvs(num_islands, NULL);
+    std::vector<std::vector<int>> island_local_to_global(num_islands);
+
+    parallel_for_work_stealing(island_threads, island_order, [&](int, int island_id) {
+        printf("\nProcessing island %d/%d...\n", island_id + 1, num_islands);
+
+        // Faces of this island straight from the CSR index
+        const int* faces = island_faces + island_offsets[island_id];
+        const int num_faces = island_offsets[island_id + 1] - island_offsets[island_id];
+
+        printf("  %d faces in island\n", num_faces);
+
+        // The island's local→global remap, kept for the write-back
+        std::vector<int>& local_to_global = island_local_to_global[island_id];
+        local_to_global.resize(3 * (size_t)num_faces);
+        int num_local = 0;
+
+        // Solver settings shared by LSCM and ABF++'s layout / fallback
+        LSCMOptions lscm_options;
+        memset(&lscm_options, 0, sizeof(lscm_options));
+        lscm_options.num_threads = solve_threads;
+        lscm_options.solver = params->lscm_solver;
+        lscm_options.cg_tolerance = params->cg_tolerance;
+        lscm_options.cg_max_iterations = params->cg_max_iterations;
+        lscm_options.cg_preconditioner = params->cg_preconditioner;
+        lscm_options.initial_uvs = params->warm_start ? mesh->uvs : NULL;
+        lscm_options.precision = params->lscm_precision;
+        lscm_options.refine_tolerance = params->refine_tolerance;
+        lscm_options.mg_auto_vertices = params->lscm_multigrid_above;
+        lscm_options.halfedge = topo->halfedge;
+        lscm_options.face_island_ids = face_island_ids;
+        lscm_options.local_to_global = local_to_global.data();
+        lscm_options.num_local_out = &num_local;
+
+        if (params->param_method == PARAM_METHOD_ABF) {
+            ABFOptions abf_options;
+            memset(&abf_options, 0, sizeof(abf_options));
+            abf_options.time_budget_seconds = params->abf_time_budget;
+            abf_options.halfedge = topo->halfedge;
+            abf_options.face_island_ids = face_island_ids;
+            abf_options.local_to_global = local_to_global.data();
+            abf_options.num_local_out = &num_local;
+            abf_options.num_threads = solve_threads;
+            abf_options.lscm = &lscm_options;
+            island_uvs[island_id] = abf_parameterize_ex(mesh, faces, num_faces, &abf_options);
+        } else {
+            island_uvs[island_id] = lscm_parameterize_ex(mesh, faces, num_faces, &lscm_options);
         }
+        local_to_global.resize(island_uvs[island_id] ? num_local : 0);
+    });
 
+    // Owners: solved islands in ascending order, so the highest solved one
+    // wins and a seam vertex whose highest island failed keeps another's UV
+    std::vector<int> solved;
+    for (int island_id = 0; island_id < num_islands; island_id++) {
+        if (!island_uvs[island_id]) continue;
+        solved.push_back(island_id);
+        for (int g : island_local_to_global[island_id]) vertex_owner[g] = island_id;
     }
 
+    const int copy_threads = limit_thread_count(island_threads, mesh->num_vertices,
+                                                UV_COPY_MIN_VERTICES_PER_THREAD);
+    parallel_for_chunks(copy_threads, solved.size(), [&](int, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            const int island_id = solved[k];
+            const std::vector<int>& local_to_global = island_local_to_global[island_id];
+            copy_island_uvs(result, island_uvs[island_id], local_to_global.data(),
+                            (int)local_to_global.size(), vertex_owner.data(), island_id);
+            free(island_uvs[island_id]);
+        }
+    });
 
     UnwrapResult* result_data = (UnwrapResult*)malloc(sizeof(UnwrapResult));
     result_data->num_islands = num_islands;
     result_data->face_island_ids = face_island_ids; 
+    result_data->island_face_offsets = island_offsets;
+    result_data->island_faces = island_faces;
     
     // int* vertex_island_ids = (int*)malloc(mesh->num_vertices * sizeof(int));
     // for(int i=0; i<mesh->num_vertices; i++) vertex_island_ids[i] = -1;
@@ -266,6 +398,13 @@ Mesh* unwrap_mesh(const Mesh* mesh,
     result_data->avg_stretch = 0.0f;
     result_data->max_stretch = 0.0f;
     result_data->coverage = 0.0f;
+    result_data->bbox_area_saved = 0.0f;
+    result_data->num_tiles = 0;
+    result_data->island_tiles = NULL;
+    result_data->island_density = (float*)malloc(sizeof(float) * (num_islands > 0 ? num_islands : 1));
+    result_data->density_spread = 0.0f;
+    result_data->vertex_island_ids = (int*)malloc(sizeof(int) * (mesh->num_vertices > 0 ? mesh->num_vertices : 1));
+    std::copy(vertex_owner.begin(), vertex_owner.end(), result_data->vertex_island_ids);
 
     // STEP 5: Pack islands if requested
     if (params->pack_islands) {
@@ -273,7 +412,29 @@ Mesh* unwrap_mesh(const Mesh* mesh,
         // temp_result.num_islands = num_islands;
         // temp_result.face_island_ids = face_island_ids;
 
-        pack_uv_islands(result, result_data, params->island_margin);
+        PackOptions pack_options;
+        memset(&pack_options, 0, sizeof(pack_options));
+        pack_options.margin = params->island_margin;
+        pack_options.method = params->pack_method;
+        pack_options.no_rotation = params->pack_no_rotation;
+        pack_options.raster_resolution = params->pack_resolution;
+        pack_options.time_budget_seconds = params->pack_time_budget;
+        pack_options.num_threads = params->num_threads;
+        if (params->udim_texel_density > 0.0f) {
+            result_data->island_tiles = (int*)malloc(sizeof(int) * (num_islands > 0 ? num_islands : 1));
+            pack_options.texel_density = params->udim_texel_density;
+            pack_options.tile_resolution = params->udim_tile_resolution;
+            pack_options.island_tiles = result_data->island_tiles;
+            pack_options.num_tiles_out = &result_data->num_tiles;
+        }
+        if (!params->pack_no_equalize && params->udim_texel_density <= 0.0f) {
+            // UDIM mode scales islands to the requested density itself
+            equalize_texel_density(result, result_data, &pack_options);
+        }
+        if (!params->pack_no_orient) {
+            result_data->bbox_area_saved = orient_uv_islands(result, result_data, &pack_options);
+        }
+        pack_uv_islands_ex(result, result_data, &pack_options);
     }
 
     // STEP 6: Compute quality metrics
@@ -299,6 +460,21 @@ void free_unwrap_result(UnwrapResult* result) {
     if (result->face_island_ids) {
         free(result->face_island_ids);
     }
+    if (result->island_face_offsets) {
+        free(result->island_face_offsets);
+    }
+    if (result->island_faces) {
+        free(result->island_faces);
+    }
+    if (result->island_tiles) {
+        free(result->island_tiles);
+    }
+    if (result->island_density) {
+        free(result->island_density);
+    }
+    if (result->vertex_island_ids) {
+        free(result->vertex_island_ids);
+    }
     // if(result->island_indices){
     //     free(result->island_indices);
     // }
@@ -336,6 +512,7 @@ extern "C" {
         
         // 2. Setup Params
         UnwrapParams params;
+        memset(&params, 0, sizeof(params));
         params.angle_threshold = angle_thresh;
         params.min_island_faces = min_island_faces;
         params.pack_islands = pack_islands;
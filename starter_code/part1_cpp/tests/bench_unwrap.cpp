@@ -0,0 +1,946 @@
+/**
+ * @file bench_unwrap.cpp
+ * @brief Performance benchmarks for the unwrapping engine
+ *
+ * Usage: bench_unwrap [section] [size]
+ *   section: topology | seams | islands | solvers | multigrid | precision | abf | packing |
+ *            raster | orient | udim | density | all (default: all)
+ *   size:    grid resolution for synthetic meshes (default per section)
+ *
+ * Result lines are prefixed with [BENCH] so they can be grepped out of the
+ * engine's own progress output.
+ */
+
+#include "mesh.h"
+#include "topology.h"
+#include "unwrap.h"
+#include "lscm.h"
+#include "abf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#define TEST_DATA_DIR "../../test_data/meshes/"
+
+static double now_seconds() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Synthetic n x n quad grid (2n² triangles) with a gentle height wave
+ */
+static Mesh* make_grid(int n) {
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    int verts_per_row = n + 1;
+    mesh->num_vertices = verts_per_row * verts_per_row;
+    mesh->num_triangles = 2 * n * n;
+    mesh->vertices = (float*)malloc(sizeof(float) * 3 * mesh->num_vertices);
+    mesh->triangles = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    mesh->uvs = NULL;
+
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n; i++) {
+            int v = j * verts_per_row + i;
+            float x = (float)i / n;
+            float y = (float)j / n;
+            mesh->vertices[3*v + 0] = x;
+            mesh->vertices[3*v + 1] = y;
+            mesh->vertices[3*v + 2] = 0.05f * sinf(6.0f * x) * cosf(6.0f * y);
+        }
+    }
+
+    int t = 0;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int v00 = j * verts_per_row + i;
+            int v10 = v00 + 1;
+            int v01 = v00 + verts_per_row;
+            int v11 = v01 + 1;
+            int* tri = mesh->triangles + 6 * t++;
+            tri[0] = v00; tri[1] = v10; tri[2] = v11;
+            tri[3] = v00; tri[4] = v11; tri[5] = v01;
+        }
+    }
+    return mesh;
+}
+
+/**
+ * @brief k disjoint copies of make_grid(n), side by side along x
+ */
+static Mesh* make_patches(int k, int n) {
+    Mesh* patch = make_grid(n);
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = k * patch->num_vertices;
+    mesh->num_triangles = k * patch->num_triangles;
+    mesh->vertices = (float*)malloc(sizeof(float) * 3 * mesh->num_vertices);
+    mesh->triangles = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    mesh->uvs = NULL;
+
+    for (int c = 0; c < k; c++) {
+        int vo = c * patch->num_vertices;
+        for (int v = 0; v < patch->num_vertices; v++) {
+            mesh->vertices[3*(vo + v) + 0] = patch->vertices[3*v + 0] + 1.5f * c;
+            mesh->vertices[3*(vo + v) + 1] = patch->vertices[3*v + 1];
+            mesh->vertices[3*(vo + v) + 2] = patch->vertices[3*v + 2];
+        }
+        int to = 3 * c * patch->num_triangles;
+        for (int t = 0; t < 3 * patch->num_triangles; t++) {
+            mesh->triangles[to + t] = patch->triangles[t] + vo;
+        }
+    }
+    free_mesh(patch);
+    return mesh;
+}
+
+static void bench_topology(int n) {
+    Mesh* mesh = make_grid(n);
+    printf("[BENCH] topology: grid %dx%d (%d faces)\n", n, n, mesh->num_triangles);
+
+    TopologyOptions opts;
+    memset(&opts, 0, sizeof(opts));
+
+    opts.ordered_edges = 0;
+    opts.num_threads = 1;
+    TopologyStats stats;
+    free_topology(build_topology_ex(mesh, &opts, &stats));
+    printf("[BENCH]   hashed   1 thread : %8.2f ms  %7.2f M edges/s\n",
+           stats.build_seconds * 1000.0, stats.edges_per_second * 1e-6);
+
+    opts.ordered_edges = 1;
+    double base = 0.0;
+    int thread_counts[] = {1, 2, 4, 8, 16};
+    for (int threads : thread_counts) {
+        opts.num_threads = threads;
+        free_topology(build_topology_ex(mesh, &opts, &stats));
+        if (threads == 1) base = stats.build_seconds;
+        printf("[BENCH]   sorted %2d threads: %8.2f ms  %7.2f M edges/s  speed-up %.2fx\n",
+               threads, stats.build_seconds * 1000.0, stats.edges_per_second * 1e-6,
+               stats.build_seconds > 0.0 ? base / stats.build_seconds : 0.0);
+    }
+
+    free_mesh(mesh);
+}
+
+static void bench_seams(int n) {
+    Mesh* mesh = make_grid(n);
+    printf("[BENCH] seams: grid %dx%d (%d vertices, %d faces)\n",
+           n, n, mesh->num_vertices, mesh->num_triangles);
+
+    TopologyInfo* topo = build_topology(mesh);
+    int num_seams = 0;
+    double t0 = now_seconds();
+    int* seams = detect_seams(mesh, topo, 30.0f, &num_seams);
+    double t1 = now_seconds();
+    printf("[BENCH]   sorted BFS      : %8.2f ms  (%d seams)\n", (t1 - t0) * 1000.0, num_seams);
+    free(seams);
+
+    SeamOptions options;
+    memset(&options, 0, sizeof(options));
+    options.angle_threshold = 30.0f;
+    options.method = SEAM_METHOD_MST;
+    int thread_counts[] = {1, 4, 16};
+    for (int threads : thread_counts) {
+        options.num_threads = threads;
+        t0 = now_seconds();
+        seams = detect_seams_ex(mesh, topo, &options, &num_seams);
+        t1 = now_seconds();
+        printf("[BENCH]   MST %2d threads  : %8.2f ms  (%d seams)\n",
+               threads, (t1 - t0) * 1000.0, num_seams);
+        free(seams);
+    }
+
+    free_topology(topo);
+    free_mesh(mesh);
+}
+
+static void bench_islands(int total_faces) {
+    printf("[BENCH] islands: ~%d faces split into k patches\n", total_faces);
+
+    int patch_counts[] = {4, 16, 64, 256};
+    int thread_counts[] = {1, 2, 4, 8};
+    for (int k : patch_counts) {
+        int n = (int)sqrtf((float)total_faces / (2.0f * k));
+        if (n < 2) n = 2;
+        Mesh* mesh = make_patches(k, n);
+
+        UnwrapParams params;
+        memset(&params, 0, sizeof(params));
+        params.angle_threshold = 30.0f;
+        params.min_island_faces = 1;
+        params.pack_islands = 0;
+
+        double base = 0.0;
+        for (int threads : thread_counts) {
+            params.num_threads = threads;
+            UnwrapResult* result = NULL;
+            double t0 = now_seconds();
+            Mesh* unwrapped = unwrap_mesh(mesh, &params, &result);
+            double t1 = now_seconds();
+            if (threads == 1) base = t1 - t0;
+            printf("[BENCH]   %3d patches (%d islands) %d threads: %8.2f ms  speed-up %.2fx\n",
+                   k, result ? result->num_islands : 0, threads, (t1 - t0) * 1000.0,
+                   t1 > t0 ? base / (t1 - t0) : 0.0);
+            free_unwrap_result(result);
+            free_mesh(unwrapped);
+        }
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief One LSCM solve over the whole mesh as a single island
+ *
+ * Memory is the stored matrix + factor entries (value + row index each).
+ */
+static void bench_lscm_solve(const char* label, const Mesh* mesh, int solver) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    LSCMStats stats;
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.solver = solver;
+    options.stats = &stats;
+
+    static const char* names[] = {"LDLT", "SparseLU", "CHOLMOD", "CG", "Multigrid"};
+    double t0 = now_seconds();
+    float* uvs = lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles, &options);
+    double t1 = now_seconds();
+    if (!uvs) {
+        printf("[BENCH]   %-28s %-8s: failed\n", label, names[solver]);
+        return;
+    }
+    free(uvs);
+
+    double mb = (double)(stats.matrix_nonzeros + stats.factor_nonzeros) *
+                (sizeof(double) + sizeof(int)) / (1024.0 * 1024.0);
+    printf("[BENCH]   %-28s %-8s: %8.2f ms (assemble %7.2f, factor %8.2f, solve %7.2f)"
+           "  factor nnz %10lld  ~%7.1f MB\n",
+           label, names[stats.solver_used], (t1 - t0) * 1000.0,
+           stats.assemble_seconds * 1000.0, stats.factor_seconds * 1000.0,
+           stats.solve_seconds * 1000.0, stats.factor_nonzeros, mb);
+}
+
+/**
+ * @brief LDLT on the SPD normal equations vs SparseLU on the square system
+ *
+ * Closed test meshes have no boundary and always use SparseLU (see
+ * lscm_parameterize_ex); the grids are open. SparseLU is skipped on grids
+ * above lu_max_vertices, where its fill makes the run impractical.
+ */
+static void bench_solvers(int n_large) {
+    printf("[BENCH] solvers: whole mesh as one LSCM island\n");
+
+    const char* files[] = {"01_cube.obj", "02_cylinder.obj", "03_sphere.obj", "04_torus.obj"};
+    for (const char* file : files) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s%s", TEST_DATA_DIR, file);
+        Mesh* mesh = load_obj(path);
+        if (!mesh) continue;
+        bench_lscm_solve(file, mesh, LSCM_SOLVER_LDLT);
+        bench_lscm_solve(file, mesh, LSCM_SOLVER_SPARSE_LU);
+        free_mesh(mesh);
+    }
+
+    const int lu_max_vertices = 200000;
+    int sizes[] = {316, n_large};   // ~100k and (by default) ~1M vertices
+    for (int n : sizes) {
+        Mesh* mesh = make_grid(n);
+        char label[64];
+        snprintf(label, sizeof(label), "grid %dx%d (%dk verts)", n, n, mesh->num_vertices / 1000);
+        bench_lscm_solve(label, mesh, LSCM_SOLVER_LDLT);
+        if (mesh->num_vertices <= lu_max_vertices) {
+            bench_lscm_solve(label, mesh, LSCM_SOLVER_SPARSE_LU);
+        } else {
+            printf("[BENCH]   %-28s SparseLU: skipped (> %d vertices)\n", label, lu_max_vertices);
+        }
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief Mean |3D angle - UV angle| over all triangle corners, in degrees
+ */
+static double mean_angle_error(const Mesh* mesh, const float* uvs) {
+    double total = 0.0;
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        const int* tri = mesh->triangles + 3 * f;
+        for (int k = 0; k < 3; k++) {
+            int a = tri[k], b = tri[(k + 1) % 3], c = tri[(k + 2) % 3];
+            const float* pa = mesh->vertices + 3 * a;
+            const float* pb = mesh->vertices + 3 * b;
+            const float* pc = mesh->vertices + 3 * c;
+            double e1[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+            double e2[3] = {pc[0] - pa[0], pc[1] - pa[1], pc[2] - pa[2]};
+            double c3[3] = {e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0]};
+            double angle_3d = atan2(sqrt(c3[0]*c3[0] + c3[1]*c3[1] + c3[2]*c3[2]),
+                                    e1[0]*e2[0] + e1[1]*e2[1] + e1[2]*e2[2]);
+            double u1 = uvs[2*b] - uvs[2*a], v1 = uvs[2*b + 1] - uvs[2*a + 1];
+            double u2 = uvs[2*c] - uvs[2*a], v2 = uvs[2*c + 1] - uvs[2*a + 1];
+            double angle_uv = atan2(fabs(u1*v2 - v1*u2), u1*u2 + v1*v2);
+            total += fabs(angle_3d - angle_uv);
+        }
+    }
+    return total / (3.0 * mesh->num_triangles) * 180.0 / M_PI;
+}
+
+/**
+ * @brief One solve of the grid as a single island, UVs scattered back per mesh vertex
+ */
+static float* solve_grid(const Mesh* mesh, int solver, int precision, LSCMStats* stats, double* seconds) {
+    std::vector<int> faces(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    std::vector<int> local_to_global(mesh->num_vertices);
+    int num_local = 0;
+
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.solver = solver;
+    options.precision = precision;
+    options.stats = stats;
+    options.local_to_global = local_to_global.data();
+    options.num_local_out = &num_local;
+
+    double t0 = now_seconds();
+    float* local = lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles, &options);
+    *seconds = now_seconds() - t0;
+    if (!local) return NULL;
+
+    float* uvs = (float*)calloc(2 * (size_t)mesh->num_vertices, sizeof(float));
+    for (int i = 0; i < num_local; i++) {
+        uvs[2 * local_to_global[i]] = local[2*i];
+        uvs[2 * local_to_global[i] + 1] = local[2*i + 1];
+    }
+    free(local);
+    return uvs;
+}
+
+/**
+ * @brief Multigrid vs LDLT: time, memory and UV quality
+ *
+ * Quality is the mean corner angle error of each result and the largest UV
+ * difference from the LDLT solution. LDLT is skipped above ldlt_max_vertices,
+ * where it needs several GB.
+ */
+static void bench_multigrid(int n_large) {
+    printf("[BENCH] multigrid: wavy grid as one LSCM island\n");
+
+    const int ldlt_max_vertices = 300000;
+    int sizes[] = {100, 316, n_large};
+    for (int n : sizes) {
+        Mesh* mesh = make_grid(n);
+        for (int v = 0; v < mesh->num_vertices; v++) mesh->vertices[3*v + 2] *= 6.0f;   // stronger curvature
+        char label[64];
+        snprintf(label, sizeof(label), "grid %dx%d (%dk verts)", n, n, mesh->num_vertices / 1000);
+
+        LSCMStats stats;
+        double seconds = 0.0;
+        float* direct = NULL;
+        if (mesh->num_vertices <= ldlt_max_vertices) {
+            direct = solve_grid(mesh, LSCM_SOLVER_LDLT, LSCM_PRECISION_DOUBLE, &stats, &seconds);
+            double mb = (double)(stats.matrix_nonzeros + stats.factor_nonzeros) *
+                        (sizeof(double) + sizeof(int)) / (1024.0 * 1024.0);
+            if (direct) {
+                printf("[BENCH]   %-28s LDLT     : %8.2f ms  ~%7.1f MB  angle error %6.3f deg\n",
+                       label, seconds * 1000.0, mb, mean_angle_error(mesh, direct));
+            }
+        } else {
+            printf("[BENCH]   %-28s LDLT     : skipped (> %d vertices)\n", label, ldlt_max_vertices);
+        }
+
+        float* multigrid = solve_grid(mesh, LSCM_SOLVER_MULTIGRID, LSCM_PRECISION_DOUBLE, &stats, &seconds);
+        if (multigrid) {
+            double difference = 0.0;
+            for (int i = 0; direct && i < 2 * mesh->num_vertices; i++) {
+                difference = fmax(difference, fabs(direct[i] - multigrid[i]));
+            }
+            double mb = (double)(stats.matrix_nonzeros + stats.factor_nonzeros) *
+                        (sizeof(double) + sizeof(int)) / (1024.0 * 1024.0);
+            printf("[BENCH]   %-28s Multigrid: %8.2f ms  ~%7.1f MB  angle error %6.3f deg"
+                   "  (%d levels, %d iterations, residual %.1e",
+                   label, seconds * 1000.0, mb, mean_angle_error(mesh, multigrid),
+                   stats.mg_levels, stats.iterations, stats.residual);
+            if (direct) printf(", max UV difference %.4f", difference);
+            printf(")\n");
+        }
+
+        free(direct);
+        free(multigrid);
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief Double vs float vs mixed-precision LDLT: time, factor memory, accuracy
+ *
+ * Memory counts factor values at the working precision plus one int index
+ * each. Accuracy is the relative residual and the largest UV difference from
+ * the double solution.
+ */
+static void bench_precision(int n_large) {
+    printf("[BENCH] precision: wavy grid as one LSCM island, LDLT\n");
+
+    const char* names[] = {"double", "float", "mixed"};
+    const size_t value_bytes[] = {sizeof(double), sizeof(float), sizeof(float)};
+    int sizes[] = {100, n_large};
+    for (int n : sizes) {
+        Mesh* mesh = make_grid(n);
+        for (int v = 0; v < mesh->num_vertices; v++) mesh->vertices[3*v + 2] *= 6.0f;
+        char label[64];
+        snprintf(label, sizeof(label), "grid %dx%d (%dk verts)", n, n, mesh->num_vertices / 1000);
+
+        float* reference = NULL;
+        for (int precision = LSCM_PRECISION_DOUBLE; precision <= LSCM_PRECISION_MIXED; precision++) {
+            LSCMStats stats;
+            double seconds = 0.0;
+            float* uvs = solve_grid(mesh, LSCM_SOLVER_LDLT, precision, &stats, &seconds);
+            if (!uvs) continue;
+
+            double difference = 0.0;
+            for (int i = 0; reference && i < 2 * mesh->num_vertices; i++) {
+                difference = fmax(difference, fabs(reference[i] - uvs[i]));
+            }
+            double mb = (double)stats.factor_nonzeros *
+                        (value_bytes[stats.precision_used] + sizeof(int)) / (1024.0 * 1024.0);
+            printf("[BENCH]   %-28s %-6s: %8.2f ms  factor ~%7.1f MB  residual %.1e  %2d steps"
+                   "  max UV difference %.1e\n",
+                   label, names[precision], seconds * 1000.0, mb, stats.residual,
+                   stats.refinement_steps, difference);
+
+            if (reference) free(uvs);
+            else reference = uvs;
+        }
+
+        free(reference);
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief Summed |3D angle - UV angle| over the corners of one island, in
+ *        degrees, for UVs in lscm_parameterize order
+ */
+static double island_angle_error_sum(const Mesh* mesh, const int* faces, int num_faces,
+                                     const float* local_uvs, const int* local_to_global,
+                                     int num_local, std::vector<float>& scratch) {
+    scratch.assign(2 * (size_t)mesh->num_vertices, 0.0f);
+    for (int i = 0; i < num_local; i++) {
+        scratch[2 * local_to_global[i]] = local_uvs[2*i];
+        scratch[2 * local_to_global[i] + 1] = local_uvs[2*i + 1];
+    }
+    Mesh view = *mesh;
+    view.triangles = (int*)malloc(sizeof(int) * 3 * (size_t)num_faces);
+    view.num_triangles = num_faces;
+    for (int i = 0; i < num_faces; i++) memcpy(view.triangles + 3*i, mesh->triangles + 3 * faces[i], 3 * sizeof(int));
+    double sum = mean_angle_error(&view, scratch.data()) * 3.0 * num_faces;
+    free(view.triangles);
+    return sum;
+}
+
+/**
+ * @brief LSCM vs ABF++ per island: time per face and angle distortion
+ *
+ * Test meshes are cut into islands by unwrap_mesh first; the wavy grids
+ * (stronger curvature than make_grid) are one island each. Angle error is
+ * the mean |3D angle - UV angle| over all corners.
+ */
+static void bench_abf(int n_large) {
+    printf("[BENCH] abf: LSCM vs ABF++ per island\n");
+
+    const char* files[] = {"01_cube.obj", "02_cylinder.obj", "03_sphere.obj", "04_torus.obj",
+                           "grid", "grid"};
+    int grid_sizes[] = {100, n_large};
+    int next_grid = 0;
+    std::vector<float> scratch;
+    for (const char* file : files) {
+        Mesh* mesh = NULL;
+        char label[64];
+        if (strcmp(file, "grid") == 0) {
+            int n = grid_sizes[next_grid++];
+            mesh = make_grid(n);
+            for (int v = 0; v < mesh->num_vertices; v++) mesh->vertices[3*v + 2] *= 6.0f;
+            snprintf(label, sizeof(label), "grid %dx%d (%dk faces)", n, n, mesh->num_triangles / 1000);
+        } else {
+            char path[512];
+            snprintf(path, sizeof(path), "%s%s", TEST_DATA_DIR, file);
+            mesh = load_obj(path);
+            snprintf(label, sizeof(label), "%s", file);
+        }
+        if (!mesh) continue;
+
+        // Islands: the whole grid, or unwrap_mesh's seam cut
+        std::vector<int> offsets, faces;
+        if (strcmp(file, "grid") == 0) {
+            offsets = {0, mesh->num_triangles};
+            for (int f = 0; f < mesh->num_triangles; f++) faces.push_back(f);
+        } else {
+            UnwrapParams params;
+            memset(&params, 0, sizeof(params));
+            params.angle_threshold = 30.0f;
+            params.min_island_faces = 1;
+            UnwrapResult* result = NULL;
+            Mesh* unwrapped = unwrap_mesh(mesh, &params, &result);
+            if (!result) {
+                free_mesh(unwrapped);
+                free_mesh(mesh);
+                continue;
+            }
+            offsets.assign(result->island_face_offsets, result->island_face_offsets + result->num_islands + 1);
+            faces.assign(result->island_faces, result->island_faces + mesh->num_triangles);
+            free_unwrap_result(result);
+            free_mesh(unwrapped);
+        }
+        const int num_islands = (int)offsets.size() - 1;
+
+        std::vector<int> local_to_global(3 * (size_t)mesh->num_triangles);
+        int num_local = 0;
+        double seconds[2] = {0.0, 0.0}, error[2] = {0.0, 0.0};
+        int total_faces = 0, converged = 0, iterations = 0;
+        for (int island = 0; island < num_islands; island++) {
+            const int* island_faces = faces.data() + offsets[island];
+            const int num_faces = offsets[island + 1] - offsets[island];
+            total_faces += num_faces;
+            for (int method = 0; method < 2; method++) {
+                float* uvs = NULL;
+                double t0 = now_seconds();
+                if (method == 0) {
+                    LSCMOptions options;
+                    memset(&options, 0, sizeof(options));
+                    options.local_to_global = local_to_global.data();
+                    options.num_local_out = &num_local;
+                    uvs = lscm_parameterize_ex(mesh, island_faces, num_faces, &options);
+                } else {
+                    ABFStats stats;
+                    ABFOptions options;
+                    memset(&options, 0, sizeof(options));
+                    options.local_to_global = local_to_global.data();
+                    options.num_local_out = &num_local;
+                    options.stats = &stats;
+                    uvs = abf_parameterize_ex(mesh, island_faces, num_faces, &options);
+                    converged += stats.result == ABF_RESULT_ABF;
+                    iterations += stats.iterations;
+                }
+                seconds[method] += now_seconds() - t0;
+                if (!uvs) continue;
+                error[method] += island_angle_error_sum(mesh, island_faces, num_faces, uvs,
+                                                        local_to_global.data(), num_local, scratch);
+                free(uvs);
+            }
+        }
+
+        const char* names[] = {"LSCM", "ABF++"};
+        for (int method = 0; method < 2; method++) {
+            printf("[BENCH]   %-28s %-5s: %9.2f ms  %7.2f us/face  angle error %6.3f deg",
+                   label, names[method], seconds[method] * 1000.0,
+                   seconds[method] * 1e6 / total_faces, error[method] / (3.0 * total_faces));
+            if (method == 1) {
+                printf("  (%d/%d islands converged, %d Newton steps)", converged, num_islands, iterations);
+            }
+            printf("\n");
+        }
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief k islands built from axis-aligned boxes (two triangles each, own
+ *        vertices) with UVs of random size and aspect, plus the matching
+ *        UnwrapResult
+ *
+ * Sizes are log-uniform over 1:40 and aspect up to 1:6 in either orientation,
+ * from a fixed seed. With mixed_shapes, a third of the islands are L shapes
+ * and a third square frames, whose bounding boxes are mostly empty.
+ */
+static Mesh* make_box_islands(int k, bool mixed_shapes, UnwrapResult* result) {
+    std::vector<float> boxes;           // x0, y0, x1, y1 per box
+    std::vector<int> box_island;
+
+    unsigned seed = 12345u;
+    auto random01 = [&]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / 16777216.0f;
+    };
+    auto add_box = [&](int island, float x0, float y0, float x1, float y1) {
+        boxes.insert(boxes.end(), {x0, y0, x1, y1});
+        box_island.push_back(island);
+    };
+    for (int i = 0; i < k; i++) {
+        float size = 0.005f * powf(40.0f, random01());
+        float aspect = powf(6.0f, 2.0f * random01() - 1.0f);
+        float w = size * sqrtf(aspect), h = size / sqrtf(aspect);
+        int shape = mixed_shapes ? i % 3 : 0;
+        float t = 0.25f * fminf(w, h);
+        if (shape == 1) {
+            add_box(i, 0, 0, w, t);
+            add_box(i, 0, t, t, h);
+        } else if (shape == 2) {
+            add_box(i, 0, 0, w, t);
+            add_box(i, 0, h - t, w, h);
+            add_box(i, 0, t, t, h - t);
+            add_box(i, w - t, t, w, h - t);
+        } else {
+            add_box(i, 0, 0, w, h);
+        }
+    }
+
+    const int num_boxes = (int)box_island.size();
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = 4 * num_boxes;
+    mesh->num_triangles = 2 * num_boxes;
+    mesh->vertices = (float*)calloc(3 * (size_t)mesh->num_vertices, sizeof(float));
+    mesh->triangles = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    mesh->uvs = (float*)malloc(sizeof(float) * 2 * mesh->num_vertices);
+
+    result->num_islands = k;
+    result->face_island_ids = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    result->island_face_offsets = (int*)malloc(sizeof(int) * (k + 1));
+    result->island_faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+
+    for (int b = 0; b < num_boxes; b++) {
+        const float* box = &boxes[4 * b];
+        float corners[4][2] = {{box[0], box[1]}, {box[2], box[1]}, {box[2], box[3]}, {box[0], box[3]}};
+        for (int c = 0; c < 4; c++) {
+            mesh->vertices[3 * (4*b + c) + 0] = corners[c][0];
+            mesh->vertices[3 * (4*b + c) + 1] = corners[c][1];
+            mesh->uvs[2 * (4*b + c) + 0] = corners[c][0];
+            mesh->uvs[2 * (4*b + c) + 1] = corners[c][1];
+        }
+        int* tri = mesh->triangles + 6*b;
+        tri[0] = 4*b; tri[1] = 4*b + 1; tri[2] = 4*b + 2;
+        tri[3] = 4*b; tri[4] = 4*b + 2; tri[5] = 4*b + 3;
+        result->face_island_ids[2*b] = result->face_island_ids[2*b + 1] = box_island[b];
+        result->island_faces[2*b] = 2*b;
+        result->island_faces[2*b + 1] = 2*b + 1;
+    }
+    // Boxes are generated island by island, so faces are already grouped
+    for (int i = 0, b = 0; i <= k; i++) {
+        while (b < num_boxes && box_island[b] < i) b++;
+        result->island_face_offsets[i] = 2*b;
+    }
+    return mesh;
+}
+
+/**
+ * @brief Shelf (the former packer) vs skyline vs MaxRects, with and without
+ *        rotation: time and coverage of [0,1]²
+ */
+static void bench_packing(int max_islands) {
+    printf("[BENCH] packing: random rectangular islands, margin 0.002\n");
+
+    const char* names[] = {"MaxRects", "skyline", "shelf"};
+    int counts[] = {100, 1000, max_islands};
+    for (int k : counts) {
+        UnwrapResult result;
+        memset(&result, 0, sizeof(result));
+        Mesh* mesh = make_box_islands(k, false, &result);
+        std::vector<float> original(mesh->uvs, mesh->uvs + 2 * mesh->num_vertices);
+
+        int methods[] = {PACK_METHOD_SHELF, PACK_METHOD_SKYLINE, PACK_METHOD_MAXRECTS};
+        for (int method : methods) {
+            for (int rotate = 0; rotate < 2; rotate++) {
+                memcpy(mesh->uvs, original.data(), sizeof(float) * original.size());
+                PackOptions options;
+                memset(&options, 0, sizeof(options));
+                options.margin = 0.002f;
+                options.method = method;
+                options.no_rotation = !rotate;
+
+                double t0 = now_seconds();
+                pack_uv_islands_ex(mesh, &result, &options);
+                double t1 = now_seconds();
+                compute_quality_metrics(mesh, &result);
+                printf("[BENCH]   %6d islands %-8s %-11s: %8.2f ms  coverage %5.1f%%\n",
+                       k, names[method], rotate ? "rotation" : "no rotation",
+                       (t1 - t0) * 1000.0, result.coverage * 100.0f);
+            }
+        }
+
+        free(result.face_island_ids);
+        free(result.island_face_offsets);
+        free(result.island_faces);
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief MaxRects vs the raster packer on rectangles and on mixed shapes
+ *        (rectangles, L shapes, frames): time and coverage of [0,1]², per
+ *        raster resolution and time budget
+ */
+static void bench_raster_packing(int max_islands) {
+    printf("[BENCH] raster packing: margin 0.002, rotation\n");
+
+    int counts[] = {100, max_islands};
+    for (int mixed = 0; mixed < 2; mixed++) {
+        for (int k : counts) {
+            UnwrapResult result;
+            memset(&result, 0, sizeof(result));
+            Mesh* mesh = make_box_islands(k, mixed != 0, &result);
+            std::vector<float> original(mesh->uvs, mesh->uvs + 2 * mesh->num_vertices);
+
+            struct Config { int method, resolution; double budget; const char* name; };
+            Config configs[] = {
+                {PACK_METHOD_MAXRECTS, 0, 0.0, "MaxRects"},
+                {PACK_METHOD_RASTER, 128, 0.0, "raster 128"},
+                {PACK_METHOD_RASTER, 256, 0.0, "raster 256"},
+                {PACK_METHOD_RASTER, 512, 0.0, "raster 512"},
+                {PACK_METHOD_RASTER, 1024, 0.0, "raster 1024"},
+                {PACK_METHOD_RASTER, 1024, 0.1, "raster 0.1 s"},
+                {PACK_METHOD_RASTER, 1024, 0.25, "raster 0.25 s"},
+            };
+            for (const Config& c : configs) {
+                memcpy(mesh->uvs, original.data(), sizeof(float) * original.size());
+                PackOptions options;
+                memset(&options, 0, sizeof(options));
+                options.margin = 0.002f;
+                options.method = c.method;
+                options.raster_resolution = c.resolution;
+                options.time_budget_seconds = c.budget;
+
+                double t0 = now_seconds();
+                pack_uv_islands_ex(mesh, &result, &options);
+                double t1 = now_seconds();
+                compute_quality_metrics(mesh, &result);
+                printf("[BENCH]   %6d %-6s islands %-12s: %8.2f ms  coverage %5.1f%%\n",
+                       k, mixed ? "mixed" : "rect", c.name, (t1 - t0) * 1000.0,
+                       result.coverage * 100.0f);
+            }
+
+            free(result.face_island_ids);
+            free(result.island_face_offsets);
+            free(result.island_faces);
+            free_mesh(mesh);
+        }
+    }
+}
+
+/**
+ * @brief Hull orientation on mixed-shape islands turned by random angles:
+ *        time, bounding-box area saved, and MaxRects coverage without and
+ *        with it
+ */
+static void bench_orient(int max_islands) {
+    printf("[BENCH] orient: mixed islands at random angles, MaxRects, margin 0.002\n");
+
+    int counts[] = {1000, max_islands};
+    for (int k : counts) {
+        UnwrapResult result;
+        memset(&result, 0, sizeof(result));
+        Mesh* mesh = make_box_islands(k, true, &result);
+
+        // Turn each island about the origin; vertices are per box, so the
+        // island of vertex v is that of face v / 2
+        unsigned seed = 99u;
+        std::vector<float> angle(k);
+        for (int i = 0; i < k; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            angle[i] = 3.14159265f * (float)(seed >> 8) / 16777216.0f;
+        }
+        for (int v = 0; v < mesh->num_vertices; v++) {
+            float a = angle[result.face_island_ids[v / 2]];
+            float u = mesh->uvs[2*v], w = mesh->uvs[2*v + 1];
+            mesh->uvs[2*v] = cosf(a) * u - sinf(a) * w;
+            mesh->uvs[2*v + 1] = sinf(a) * u + cosf(a) * w;
+        }
+        std::vector<float> original(mesh->uvs, mesh->uvs + 2 * mesh->num_vertices);
+
+        PackOptions options;
+        memset(&options, 0, sizeof(options));
+        options.margin = 0.002f;
+
+        pack_uv_islands_ex(mesh, &result, &options);
+        compute_quality_metrics(mesh, &result);
+        float coverage_before = result.coverage;
+
+        memcpy(mesh->uvs, original.data(), sizeof(float) * original.size());
+        double t0 = now_seconds();
+        float saved = orient_uv_islands(mesh, &result, &options);
+        double t1 = now_seconds();
+        pack_uv_islands_ex(mesh, &result, &options);
+        compute_quality_metrics(mesh, &result);
+
+        printf("[BENCH]   %7d islands: orient %8.2f ms (%.2f us/island), boxes %.1f%% smaller, "
+               "coverage %.1f%% -> %.1f%%\n", k, (t1 - t0) * 1000.0, (t1 - t0) * 1e6 / k,
+               100.0f * saved, 100.0f * coverage_before, 100.0f * result.coverage);
+
+        free(result.face_island_ids);
+        free(result.island_face_offsets);
+        free(result.island_faces);
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief UDIM packing of rectangular islands (mesh units = UV units) at a
+ *        few texel densities on 1024 px tiles: time on one and on all
+ *        threads, tiles used against the area bound, and mean tile coverage
+ */
+static void bench_udim(int max_islands) {
+    printf("[BENCH] udim: rectangular islands, 1024 px tiles, margin 0.002, rotation\n");
+
+    int counts[] = {1000, max_islands};
+    float densities[] = {512.0f, 1024.0f, 2048.0f};
+    for (int k : counts) {
+        UnwrapResult result;
+        memset(&result, 0, sizeof(result));
+        Mesh* mesh = make_box_islands(k, false, &result);
+        std::vector<float> original(mesh->uvs, mesh->uvs + 2 * mesh->num_vertices);
+        std::vector<int> tiles(k);
+
+        for (float density : densities) {
+            double area = 0.0;
+            for (int f = 0; f < mesh->num_triangles; f += 2) {
+                const float* uv = &original[2 * mesh->triangles[3 * f]];
+                const float* opposite = &original[2 * mesh->triangles[3 * f + 2]];
+                area += (opposite[0] - uv[0] + 0.002 * 1024.0 / density) *
+                        (opposite[1] - uv[1] + 0.002 * 1024.0 / density);
+            }
+            const int bound = (int)ceil(area * (density / 1024.0) * (density / 1024.0));
+
+            double ms[2];
+            int thread_counts[] = {1, 0};
+            for (int t = 0; t < 2; t++) {
+                memcpy(mesh->uvs, original.data(), sizeof(float) * original.size());
+                PackOptions options;
+                memset(&options, 0, sizeof(options));
+                options.margin = 0.002f;
+                options.texel_density = density;
+                options.tile_resolution = 1024;
+                options.num_threads = thread_counts[t];
+                options.island_tiles = tiles.data();
+                options.num_tiles_out = &result.num_tiles;
+
+                double t0 = now_seconds();
+                pack_uv_islands_ex(mesh, &result, &options);
+                ms[t] = (now_seconds() - t0) * 1000.0;
+            }
+            result.island_tiles = tiles.data();
+            compute_quality_metrics(mesh, &result);
+            result.island_tiles = NULL;
+
+            printf("[BENCH]   %6d islands at %5.0f texels/unit: %8.2f ms (1 thread) %8.2f ms (all), "
+                   "%4d tiles (bound %4d), coverage %5.1f%%\n", k, density, ms[0], ms[1],
+                   result.num_tiles, bound, 100.0f * result.coverage);
+        }
+
+        free(result.face_island_ids);
+        free(result.island_face_offsets);
+        free(result.island_faces);
+        free_mesh(mesh);
+    }
+}
+
+/**
+ * @brief Texel density equalisation on rectangular islands whose UVs are
+ *        each stretched to the unit square, as parameterization leaves
+ *        them: time, and density spread and coverage after MaxRects
+ *        packing without and with it
+ */
+static void bench_density(int max_islands) {
+    printf("[BENCH] density: rectangular islands normalized one by one, MaxRects, margin 0.002\n");
+
+    int counts[] = {1000, max_islands};
+    for (int k : counts) {
+        UnwrapResult result;
+        memset(&result, 0, sizeof(result));
+        Mesh* mesh = make_box_islands(k, false, &result);
+        for (int b = 0; b < mesh->num_vertices / 4; b++) {
+            float* uv = mesh->uvs + 8 * b;
+            float w = uv[4] - uv[0], h = uv[5] - uv[1];
+            for (int c = 0; c < 4; c++) {
+                uv[2*c] /= w;
+                uv[2*c + 1] /= h;
+            }
+        }
+        std::vector<float> original(mesh->uvs, mesh->uvs + 2 * mesh->num_vertices);
+        std::vector<float> density(k);
+        result.island_density = density.data();
+
+        PackOptions options;
+        memset(&options, 0, sizeof(options));
+        options.margin = 0.002f;
+
+        pack_uv_islands_ex(mesh, &result, &options);
+        compute_quality_metrics(mesh, &result);
+        float spread_before = result.density_spread, coverage_before = result.coverage;
+
+        memcpy(mesh->uvs, original.data(), sizeof(float) * original.size());
+        double t0 = now_seconds();
+        equalize_texel_density(mesh, &result, &options);
+        double t1 = now_seconds();
+        pack_uv_islands_ex(mesh, &result, &options);
+        compute_quality_metrics(mesh, &result);
+
+        printf("[BENCH]   %7d islands: equalize %8.2f ms (%.2f us/island), density spread %.1fx -> %.3fx, "
+               "coverage %.1f%% -> %.1f%%\n", k, (t1 - t0) * 1000.0, (t1 - t0) * 1e6 / k,
+               spread_before, result.density_spread, 100.0f * coverage_before, 100.0f * result.coverage);
+
+        free(result.face_island_ids);
+        free(result.island_face_offsets);
+        free(result.island_faces);
+        free_mesh(mesh);
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* section = (argc > 1) ? argv[1] : "all";
+    int size = (argc > 2) ? atoi(argv[2]) : 0;
+    bool all = strcmp(section, "all") == 0;
+
+    double start = now_seconds();
+
+    if (all || strcmp(section, "topology") == 0) {
+        bench_topology(size > 0 ? size : 708);   // ~1M faces
+    }
+
+    if (all || strcmp(section, "seams") == 0) {
+        bench_seams(size > 0 ? size : 316);      // ~100k vertices, 200k faces
+    }
+
+    if (all || strcmp(section, "islands") == 0) {
+        bench_islands(size > 0 ? size : 65536);
+    }
+
+    if (all || strcmp(section, "solvers") == 0) {
+        bench_solvers(size > 0 ? size : 1000);  // ~1M vertices
+    }
+
+    if (all || strcmp(section, "multigrid") == 0) {
+        bench_multigrid(size > 0 ? size : 1000);  // ~1M vertices
+    }
+
+    if (all || strcmp(section, "precision") == 0) {
+        bench_precision(size > 0 ? size : 316);  // ~100k vertices
+    }
+
+    if (all || strcmp(section, "abf") == 0) {
+        bench_abf(size > 0 ? size : 316);        // ~200k faces
+    }
+
+    if (all || strcmp(section, "packing") == 0) {
+        bench_packing(size > 0 ? size : 10000);  // islands
+    }
+
+    if (all || strcmp(section, "raster") == 0) {
+        bench_raster_packing(size > 0 ? size : 1000);  // islands
+    }
+
+    if (all || strcmp(section, "orient") == 0) {
+        bench_orient(size > 0 ? size : 10000);  // islands
+    }
+
+    if (all || strcmp(section, "udim") == 0) {
+        bench_udim(size > 0 ? size : 10000);    // islands
+    }
+
+    if (all || strcmp(section, "density") == 0) {
+        bench_density(size > 0 ? size : 10000);  // islands
+    }
+
+    printf("[BENCH] total %.2f s\n", now_seconds() - start);
+    return 0;
+}
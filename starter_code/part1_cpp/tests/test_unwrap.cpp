@@ -9,9 +9,16 @@
 #include "mesh.h"
 #include "topology.h"
 #include "unwrap.h"
+#include "face_geometry.h"
+#include "lscm.h"
+#include "abf.h"
+#include "math_utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
 
 #define TEST_DATA_DIR "../../test_data/meshes/"
 
@@ -58,8 +65,1423 @@ void test_topology(const char* mesh_name, int expected_v, int expected_e, int ex
     free_mesh(mesh);
 }
 
-void test_seams(const char* mesh_name, int min_seams, int max_seams) {
-    printf("[TEST] Seam Detection - %s...", mesh_name);
+void test_topology_hashed(const char* mesh_name) {
+    printf("[TEST] Topology (hashed vs sorted) - %s...", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    TopologyOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.ordered_edges = 0;
+    TopologyStats stats;
+    TopologyInfo* hashed = build_topology_ex(mesh, &opts, &stats);
+    TopologyInfo* sorted = build_topology(mesh);
+    if (!hashed || !sorted) {
+        printf(" FAIL (topology building failed)\n");
+        tests_failed++;
+        free_topology(hashed);
+        free_topology(sorted);
+        free_mesh(mesh);
+        return;
+    }
+
+    // Every hashed edge must appear in the sorted table with the same faces
+    int mismatches = (hashed->num_edges != sorted->num_edges) ? 1 : 0;
+    for (int e = 0; e < hashed->num_edges && !mismatches; e++) {
+        int found = 0;
+        for (int s = 0; s < sorted->num_edges; s++) {
+            if (sorted->edges[2*s] == hashed->edges[2*e] &&
+                sorted->edges[2*s + 1] == hashed->edges[2*e + 1]) {
+                found = sorted->edge_faces[2*s] == hashed->edge_faces[2*e] &&
+                        sorted->edge_faces[2*s + 1] == hashed->edge_faces[2*e + 1];
+                break;
+            }
+        }
+        if (!found) mismatches++;
+    }
+
+    if (mismatches) {
+        printf(" FAIL (edge tables differ)\n");
+        tests_failed++;
+    } else {
+        printf(" PASS (%d edges)\n", hashed->num_edges);
+        tests_passed++;
+    }
+
+    free_topology(hashed);
+    free_topology(sorted);
+    free_mesh(mesh);
+}
+
+/** @brief Next value in [0, 1) of the linear congruential stream in seed */
+static float random01(unsigned& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief n x n quad grid (2 n² triangles) on a wavy height field, so
+ *        neighbouring faces meet at varied dihedral angles
+ */
+static Mesh* make_grid_mesh(int n) {
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = (n + 1) * (n + 1);
+    mesh->num_triangles = 2 * n * n;
+    mesh->vertices = (float*)malloc(sizeof(float) * 3 * mesh->num_vertices);
+    mesh->triangles = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    mesh->uvs = NULL;
+
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n; i++) {
+            float* p = mesh->vertices + 3 * (j * (n + 1) + i);
+            p[0] = (float)i;
+            p[1] = (float)j;
+            p[2] = 0.8f * sinf(0.7f * i) * cosf(0.5f * j);
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int v00 = j * (n + 1) + i, v10 = v00 + 1, v01 = v00 + n + 1, v11 = v01 + 1;
+            int* t = mesh->triangles + 6 * (j * n + i);
+            t[0] = v00; t[1] = v10; t[2] = v11;
+            t[3] = v00; t[4] = v11; t[5] = v01;
+        }
+    }
+    return mesh;
+}
+
+void test_topology_parallel(int n, int num_threads) {
+    printf("[TEST] Topology (parallel vs serial sorted) - %d x %d grid, %d threads...", n, n, num_threads);
+
+    // Large enough that the sorted builder really splits across threads
+    Mesh* mesh = make_grid_mesh(n);
+    TopologyOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.ordered_edges = 1;
+    opts.num_threads = 1;
+    TopologyInfo* serial = build_topology_ex(mesh, &opts, NULL);
+    opts.num_threads = num_threads;
+    TopologyInfo* parallel = build_topology_ex(mesh, &opts, NULL);
+
+    if (!serial || !parallel) {
+        printf(" FAIL (topology building failed)\n");
+        tests_failed++;
+    } else if (serial->num_edges != parallel->num_edges ||
+               memcmp(serial->edges, parallel->edges, sizeof(int) * 2 * serial->num_edges) != 0 ||
+               memcmp(serial->edge_faces, parallel->edge_faces, sizeof(int) * 2 * serial->num_edges) != 0 ||
+               memcmp(serial->face_edges, parallel->face_edges, sizeof(int) * 3 * mesh->num_triangles) != 0) {
+        printf(" FAIL (edge tables differ)\n");
+        tests_failed++;
+    } else {
+        printf(" PASS (%d edges)\n", serial->num_edges);
+        tests_passed++;
+    }
+
+    free_topology(serial);
+    free_topology(parallel);
+    free_mesh(mesh);
+}
+
+void test_vertex_adjacency(const char* mesh_name) {
+    printf("[TEST] Vertex adjacency and angular defects - %s...", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    TopologyInfo* topo = build_topology(mesh);
+    VertexAdjacency* adj = topo ? build_vertex_adjacency(mesh, topo) : NULL;
+    if (!adj) {
+        printf(" FAIL (adjacency building failed)\n");
+        tests_failed++;
+        free_topology(topo);
+        free_mesh(mesh);
+        return;
+    }
+
+    // CSR tables against a brute-force scan of every face and edge per vertex
+    const int V = mesh->num_vertices;
+    int bad_offsets = adj->num_vertices != V || adj->vf_offsets[0] != 0 || adj->ve_offsets[0] != 0;
+    int bad_faces = 0, bad_edges = 0;
+    for (int v = 0; v < V && !bad_offsets; v++) {
+        if (adj->vf_offsets[v + 1] < adj->vf_offsets[v] || adj->ve_offsets[v + 1] < adj->ve_offsets[v]) {
+            bad_offsets++;
+            break;
+        }
+        std::vector<int> faces, edges;
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            const int* t = mesh->triangles + 3 * f;
+            if (t[0] == v || t[1] == v || t[2] == v) faces.push_back(f);
+        }
+        for (int e = 0; e < topo->num_edges; e++) {
+            if (topo->edges[2*e] == v || topo->edges[2*e + 1] == v) edges.push_back(e);
+        }
+        std::vector<int> got_faces(adj->vf_faces + adj->vf_offsets[v], adj->vf_faces + adj->vf_offsets[v + 1]);
+        std::vector<int> got_edges(adj->ve_edges + adj->ve_offsets[v], adj->ve_edges + adj->ve_offsets[v + 1]);
+        std::sort(got_faces.begin(), got_faces.end());
+        std::sort(got_edges.begin(), got_edges.end());
+        if (got_faces != faces) bad_faces++;
+        if (got_edges != edges) bad_edges++;
+    }
+
+    // One-pass defects against the per-vertex scan they replaced
+    std::vector<float> defects(V);
+    compute_angular_defects(mesh, defects.data());
+    double max_difference = 0.0;
+    for (int v = 0; v < V; v++) {
+        float angle_sum = 0.0f;
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            const int* t = mesh->triangles + 3 * f;
+            if (t[0] == v || t[1] == v || t[2] == v) angle_sum += compute_vertex_angle_in_triangle(mesh, f, v);
+        }
+        float expected = 2.0f * 3.14159265358979f - angle_sum;
+        max_difference = std::max(max_difference, (double)fabsf(defects[v] - expected));
+    }
+
+    if (bad_offsets || bad_faces || bad_edges) {
+        printf(" FAIL (offsets %s, %d vertex->face and %d vertex->edge lists differ)\n",
+               bad_offsets ? "invalid" : "ok", bad_faces, bad_edges);
+        tests_failed++;
+    } else if (max_difference > 1e-6) {
+        printf(" FAIL (defects differ by up to %.2e)\n", max_difference);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d face and %d edge incidences, defect difference %.1e)\n",
+               adj->vf_offsets[V], adj->ve_offsets[V], max_difference);
+        tests_passed++;
+    }
+
+    free_vertex_adjacency(adj);
+    free_topology(topo);
+    free_mesh(mesh);
+}
+
+void test_sharp_edges(const char* mesh_name, float angle_threshold, int expected_sharp) {
+    printf("[TEST] Sharp edges at %.0f deg - %s...", angle_threshold, mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    TopologyInfo* topo = build_topology(mesh);
+    unsigned char* sharp = (unsigned char*)malloc(topo->num_edges > 0 ? topo->num_edges : 1);
+    int num_sharp = classify_sharp_edges(topo->edge_sharpness, topo->edge_faces,
+                                         topo->num_edges, angle_threshold, sharp);
+
+    int counted = 0;
+    for (int e = 0; e < topo->num_edges; e++) counted += sharp[e];
+
+    if (num_sharp == expected_sharp && counted == num_sharp) {
+        printf(" PASS (%d sharp)\n", num_sharp);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: %d sharp edges\n", expected_sharp);
+        printf("  Got:      %d (flags: %d)\n", num_sharp, counted);
+        tests_failed++;
+    }
+
+    free(sharp);
+    free_topology(topo);
+    free_mesh(mesh);
+}
+
+void test_face_geometry_kernel() {
+    printf("[TEST] Face geometry (%s kernel vs scalar reference)...", face_geometry_kernel_name());
+
+    // 43 faces (five 8-wide blocks and a tail): random triangles mixed with
+    // collinear, repeated-corner, sliver and out-of-range ones
+    const int V = 40, F = 43;
+    std::vector<float> verts(3 * V);
+    std::vector<int> tris(3 * F);
+    unsigned seed = 5150u;
+    for (int i = 0; i < 3 * V; i++) verts[i] = 4.0f * random01(seed) - 2.0f;
+    // Vertices 0-2 collinear, 3 a hair off the line through 0 and 1
+    for (int d = 0; d < 3; d++) {
+        verts[3 + d] = verts[d] + 1.0f;
+        verts[6 + d] = verts[d] + 2.0f;
+        verts[9 + d] = verts[d] + 0.5f;
+    }
+    verts[9] += 1e-4f;
+    for (int f = 0; f < F; f++) {
+        int* t = &tris[3 * f];
+        switch (f % 6) {
+            case 1: t[0] = 0; t[1] = 1; t[2] = 2; break;                  // collinear: zero area
+            case 3: t[0] = 5 + f % 30; t[1] = t[0]; t[2] = 7; break;      // repeated corner
+            case 4: t[0] = 0; t[1] = 1; t[2] = 3; break;                  // sliver
+            case 5: t[0] = f % 2 ? -1 : V; t[1] = 1; t[2] = 2; break;     // invalid index
+            default:
+                for (int k = 0; k < 3; k++) t[k] = (int)(random01(seed) * V) % V;
+                break;
+        }
+    }
+    Mesh mesh = {verts.data(), V, tris.data(), F, NULL};
+    FaceGeometry* g = compute_face_geometry(&mesh);
+
+    int bad_faces = 0;
+    for (int f = 0; g && f < F; f++) {
+        const int* t = &tris[3 * f];
+        double n[3] = {0.0, 0.0, 0.0}, area = 0.0;
+        bool valid = true;
+        for (int k = 0; k < 3; k++) valid = valid && t[k] >= 0 && t[k] < V;
+        if (valid) {
+            const float* p0 = &verts[3 * t[0]];
+            const float* p1 = &verts[3 * t[1]];
+            const float* p2 = &verts[3 * t[2]];
+            double e1[3] = {(double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2]};
+            double e2[3] = {(double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2]};
+            n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+            n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+            n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+            double l = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            area = 0.5 * l;
+            for (int k = 0; l > 1e-6 && k < 3; k++) n[k] /= l;
+        }
+        // Degenerate faces must come out exactly zero; slivers only need a
+        // unit normal close to the reference
+        bool ok;
+        if (area <= 1e-6) {
+            ok = fabsf(g->area[f]) <= 1e-6f &&
+                 (area == 0.0 ? g->nx[f] == 0.0f && g->ny[f] == 0.0f && g->nz[f] == 0.0f : true);
+        } else {
+            double tol = area < 1e-3 ? 1e-2 : 1e-5;
+            ok = fabs(g->area[f] - area) <= 1e-5 * (1.0 + area) &&
+                 fabs(g->nx[f] - n[0]) <= tol && fabs(g->ny[f] - n[1]) <= tol && fabs(g->nz[f] - n[2]) <= tol;
+        }
+        if (!ok) bad_faces++;
+    }
+
+    // Sharpness and the classifier over every face pair, boundary edges included
+    std::vector<int> edge_faces;
+    for (int a = 0; a < F; a++) {
+        edge_faces.push_back(a);
+        edge_faces.push_back(a % 7 == 0 ? -1 : (a * 5 + 3) % F);
+    }
+    const int E = (int)edge_faces.size() / 2;
+    std::vector<float> sharpness(E);
+    std::vector<unsigned char> sharp(E);
+    int bad_edges = 0;
+    if (g) {
+        compute_edge_sharpness(g, edge_faces.data(), E, sharpness.data());
+        for (int e = 0; e < E; e++) {
+            int f0 = edge_faces[2 * e], f1 = edge_faces[2 * e + 1];
+            float expected = f1 < 0 ? 1.0f
+                           : 1.0f - (g->nx[f0] * g->nx[f1] + g->ny[f0] * g->ny[f1] + g->nz[f0] * g->nz[f1]);
+            if (fabsf(sharpness[e] - expected) > 1e-6f) bad_edges++;
+        }
+        float thresholds[] = {0.0f, 30.0f, 90.0f, 179.0f};
+        for (float threshold : thresholds) {
+            int count = classify_sharp_edges(sharpness.data(), edge_faces.data(), E, threshold, sharp.data());
+            float cutoff = 1.0f - cosf(threshold * 3.14159265358979f / 180.0f);
+            int expected_count = 0;
+            for (int e = 0; e < E; e++) {
+                int expected = edge_faces[2 * e + 1] >= 0 && sharpness[e] > cutoff;
+                expected_count += expected;
+                if (sharp[e] != expected) bad_edges++;
+            }
+            if (count != expected_count) bad_edges++;
+        }
+    }
+
+    if (!g) {
+        printf(" FAIL (compute_face_geometry failed)\n");
+        tests_failed++;
+    } else if (bad_faces || bad_edges) {
+        printf(" FAIL (%d faces, %d edge results differ)\n", bad_faces, bad_edges);
+        tests_failed++;
+    } else if (strcmp(face_geometry_kernel_name(), "scalar") == 0) {
+        // Not counted as a pass: no SIMD kernel ran, so nothing was compared
+        printf(" SKIP (no AVX2 / NEON on this CPU, only the scalar kernel ran)\n");
+    } else {
+        printf(" PASS\n");
+        tests_passed++;
+    }
+    free_face_geometry(g);
+}
+
+void test_halfedge_invariants(const char* mesh_name) {
+    printf("[TEST] Half-edge invariants - %s...", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    TopologyInfo* topo = build_topology(mesh);
+    const HalfEdgeMesh* he = topo ? topo->halfedge : NULL;
+    if (!he) {
+        printf(" FAIL (no half-edge mesh)\n");
+        tests_failed++;
+        free_topology(topo);
+        free_mesh(mesh);
+        return;
+    }
+
+    const int H = he->num_halfedges;
+    int bad_next = 0, bad_twin = 0, bad_vert = 0, boundary = 0;
+    for (int h = 0; h < H; h++) {
+        // he_next: a 3-cycle inside the face, origins are the face corners
+        int n1 = he->he_next[h], n2 = he->he_next[n1];
+        if (n1 == h || n2 == h || he->he_next[n2] != h ||
+            he->he_face[n1] != h / 3 || he->he_face[h] != h / 3 ||
+            he->he_vertex[h] != mesh->triangles[h]) bad_next++;
+
+        // he_twin: an involution between the two sides of one edge, running
+        // the other way; -1 exactly on boundary edges
+        int t = he->he_twin[h], e = he->he_edge[h];
+        if (t < 0) {
+            boundary++;
+            if (e >= 0 && topo->edge_faces[2*e + 1] >= 0) bad_twin++;
+        } else if (t == h || he->he_twin[t] != h || he->he_edge[t] != e ||
+                   he->he_vertex[t] != he->he_vertex[n1] || he->he_vertex[he->he_next[t]] != he->he_vertex[h]) {
+            bad_twin++;
+        }
+    }
+
+    // vert_halfedge: outgoing from v, and a boundary half-edge whenever v
+    // has one; -1 only for unreferenced vertices
+    std::vector<char> used(mesh->num_vertices, 0), on_boundary(mesh->num_vertices, 0);
+    for (int h = 0; h < H; h++) {
+        used[he->he_vertex[h]] = 1;
+        if (he->he_twin[h] < 0) on_boundary[he->he_vertex[h]] = 1;
+    }
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        int h = he->vert_halfedge[v];
+        if (h < 0) {
+            if (used[v]) bad_vert++;
+        } else if (he->he_vertex[h] != v || (on_boundary[v] && he->he_twin[h] >= 0)) {
+            bad_vert++;
+        }
+    }
+
+    if (H != 3 * mesh->num_triangles || bad_next || bad_twin || bad_vert) {
+        printf(" FAIL (%d half-edges, %d next, %d twin, %d vertex errors)\n", H, bad_next, bad_twin, bad_vert);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d half-edges, %d on the boundary)\n", H, boundary);
+        tests_passed++;
+    }
+
+    free_topology(topo);
+    free_mesh(mesh);
+}
+
+void test_boundary_loops(const char* mesh_name, int expected_loops) {
+    printf("[TEST] Boundary loops - %s...", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    int* loop_vertices = NULL;
+    int* offsets = NULL;
+    int num_loops = find_boundary_loops(mesh, faces, mesh->num_triangles, &loop_vertices, &offsets);
+
+    // Every step along a loop (wrapping around) must be a side used by exactly one face
+    auto face_count = [&](int a, int b) {
+        int count = 0;
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            const int* tri = mesh->triangles + 3 * f;
+            for (int k = 0; k < 3; k++) {
+                int x = tri[k], y = tri[(k + 1) % 3];
+                if ((x == a && y == b) || (x == b && y == a)) count++;
+            }
+        }
+        return count;
+    };
+    int steps = 0, bad_steps = 0;
+    for (int l = 0; l < num_loops; l++) {
+        for (int i = offsets[l]; i < offsets[l + 1]; i++) {
+            int next = (i + 1 < offsets[l + 1]) ? i + 1 : offsets[l];
+            if (face_count(loop_vertices[i], loop_vertices[next]) != 1) bad_steps++;
+            steps++;
+        }
+    }
+
+    int* boundary = NULL;
+    int num_boundary = find_boundary_vertices(mesh, faces, mesh->num_triangles, &boundary);
+
+    if (num_loops == expected_loops && bad_steps == 0 && num_boundary == steps) {
+        printf(" PASS (%d loops, %d boundary vertices)\n", num_loops, num_boundary);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: %d loops of boundary edges\n", expected_loops);
+        printf("  Got:      %d loops, %d/%d steps off the boundary, %d boundary vertices\n",
+               num_loops, bad_steps, steps, num_boundary);
+        tests_failed++;
+    }
+
+    free(boundary);
+    free(loop_vertices);
+    free(offsets);
+    free(faces);
+    free_mesh(mesh);
+}
+
+/**
+ * @brief Brute-force diameter of a point set: the first pair at the largest
+ *        distance in ascending index order, as the old all-pairs pin loop chose
+ */
+static std::pair<int, int> brute_force_farthest_pair(const float* vertices, const int* points, int count,
+                                                      double* d2_out) {
+    std::vector<int> sorted(points, points + count);
+    std::sort(sorted.begin(), sorted.end());
+    std::pair<int, int> best(-1, -1);
+    double best_d2 = -1.0;
+    for (int i = 0; i < count; i++) {
+        const float* p = vertices + 3 * sorted[i];
+        for (int j = i + 1; j < count; j++) {
+            const float* q = vertices + 3 * sorted[j];
+            double dx = (double)p[0] - q[0], dy = (double)p[1] - q[1], dz = (double)p[2] - q[2];
+            double d2 = dx*dx + dy*dy + dz*dz;
+            if (d2 > best_d2) {
+                best_d2 = d2;
+                best = std::make_pair(sorted[i], sorted[j]);
+            }
+        }
+    }
+    *d2_out = best_d2;
+    return best;
+}
+
+/** Pins lscm_parameterize_ex would use for the island, as mesh vertices */
+static std::pair<int, int> lscm_pins(const Mesh* mesh, const std::vector<int>& faces) {
+    LSCMLinearSystem* system = lscm_assemble_system(mesh, faces.data(), (int)faces.size(), 1, NULL);
+    if (!system) return std::make_pair(-1, -1);
+    std::pair<int, int> pins(system->local_to_global[system->pins[0]],
+                             system->local_to_global[system->pins[1]]);
+    free_lscm_system(system);
+    return pins;
+}
+
+void test_farthest_pair_pins(int num_random) {
+    printf("[TEST] LSCM pins vs brute-force farthest pair...");
+
+    // Symmetric islands, where many pairs tie: the pins must be exactly the
+    // pair the all-pairs loop picked, in the same order
+    int mismatches = 0;
+    {
+        Mesh* grid = make_grid_mesh(12);
+        for (int v = 0; v < grid->num_vertices; v++) grid->vertices[3*v + 2] = 0.0f;
+        char filename[256];
+        snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, "02_cylinder.obj");
+        Mesh* cylinder = load_obj(filename);
+        Mesh* symmetric[2] = {grid, cylinder};
+        for (int k = 0; k < 2; k++) {
+            Mesh* mesh = symmetric[k];
+            if (!mesh) {
+                mismatches++;
+                continue;
+            }
+            std::vector<int> faces(mesh->num_triangles);
+            for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+            int* boundary = NULL;
+            int num_boundary = find_boundary_vertices(mesh, faces.data(), (int)faces.size(), &boundary);
+            double d2;
+            std::pair<int, int> expected = brute_force_farthest_pair(mesh->vertices, boundary, num_boundary, &d2);
+            if (lscm_pins(mesh, faces) != expected) mismatches++;
+            free(boundary);
+            free_mesh(mesh);
+        }
+    }
+
+    // A boundary collapsed to one point has no pair to pin: the island is
+    // rejected instead of assembled with both pins on one vertex
+    int collapsed = 0;
+    {
+        float vertices[9] = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+        int triangles[3] = {0, 1, 2};
+        Mesh mesh;
+        mesh.num_vertices = 3;
+        mesh.num_triangles = 1;
+        mesh.vertices = vertices;
+        mesh.triangles = triangles;
+        mesh.uvs = NULL;
+        std::vector<int> faces(1, 0);
+        float* uvs = lscm_parameterize(&mesh, faces.data(), 1);
+        if (uvs || lscm_pins(&mesh, faces) != std::make_pair(-1, -1)) collapsed++;
+        free(uvs);
+    }
+
+    // Random fans: a centre joined to a rim of random 3D points, which is
+    // the island boundary. The pins must reach cos(27.6°) of the diameter
+    const double bound = cos(27.6 * M_PI / 180.0);
+    double worst_ratio = 1.0;
+    int exact = 0;
+    unsigned seed = 12345u;
+    auto next_random = [&]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / (float)(1u << 24);
+    };
+    for (int trial = 0; trial < num_random; trial++) {
+        const int rim = 3 + trial % 60;
+        Mesh mesh;
+        std::vector<float> vertices(3 * (size_t)(rim + 1), 0.0f);
+        std::vector<int> triangles(3 * (size_t)rim);
+        for (int i = 1; i <= rim; i++) {
+            vertices[3*i] = next_random() * 4.0f - 2.0f;
+            vertices[3*i + 1] = next_random() * 2.0f - 1.0f;
+            vertices[3*i + 2] = next_random() * 3.0f - 1.5f;
+        }
+        for (int i = 0; i < rim; i++) {
+            triangles[3*i] = 0;
+            triangles[3*i + 1] = 1 + i;
+            triangles[3*i + 2] = 1 + (i + 1) % rim;
+        }
+        mesh.num_vertices = rim + 1;
+        mesh.num_triangles = rim;
+        mesh.vertices = vertices.data();
+        mesh.triangles = triangles.data();
+        mesh.uvs = NULL;
+
+        std::vector<int> faces(rim), points(rim);
+        for (int i = 0; i < rim; i++) {
+            faces[i] = i;
+            points[i] = 1 + i;
+        }
+        double d2;
+        std::pair<int, int> expected = brute_force_farthest_pair(mesh.vertices, points.data(), rim, &d2);
+        std::pair<int, int> pins = lscm_pins(&mesh, faces);
+        if (pins.first < 1 || pins.second < 1) {
+            mismatches++;
+            continue;
+        }
+        const float* p = mesh.vertices + 3 * pins.first;
+        const float* q = mesh.vertices + 3 * pins.second;
+        double dx = (double)p[0] - q[0], dy = (double)p[1] - q[1], dz = (double)p[2] - q[2];
+        double ratio = sqrt((dx*dx + dy*dy + dz*dz) / d2);
+        worst_ratio = std::min(worst_ratio, ratio);
+        if (pins == expected) exact++;
+    }
+
+    if (collapsed) {
+        printf(" FAIL (collapsed boundary was not rejected)\n");
+        tests_failed++;
+    } else if (mismatches) {
+        printf(" FAIL (%d symmetric island%s pinned differently from the all-pairs loop)\n",
+               mismatches, mismatches == 1 ? "" : "s");
+        tests_failed++;
+    } else if (worst_ratio < bound) {
+        printf(" FAIL (pins at %.3f of the diameter, bound %.3f)\n", worst_ratio, bound);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d / %d random rims exact, worst %.3f of the diameter)\n",
+               exact, num_random, worst_ratio);
+        tests_passed++;
+    }
+}
+
+/**
+ * @brief Full 2n x 2n LSCM matrix of a system's island, dense and row-major,
+ *        built per triangle as in reference/lscm_matrix_example.cpp, no
+ *        vertex pinned
+ *
+ * Square system: per side a -> b, area * (dx, dy) at blocks (a, b) and
+ * (a, a). Normal equations: MᵀM, where M has two rows per triangle, the real
+ * and imaginary parts of Σ_j W_j (u_j + i v_j).
+ */
+static std::vector<double> lscm_reference_matrix(const Mesh* mesh, const int* faces, int num_faces,
+                                                 const LSCMLinearSystem* system, bool normal) {
+    std::vector<int> local(mesh->num_vertices, -1);
+    for (int v = 0; v < system->num_local; v++) local[system->local_to_global[v]] = v;
+    const int n2 = 2 * system->num_local;
+
+    std::vector<double> A((size_t)n2 * n2, 0.0);
+    auto add = [&](int r, int c, double value) { A[(size_t)r * n2 + c] += value; };
+    for (int i = 0; i < num_faces; i++) {
+        const int* t = mesh->triangles + 3 * faces[i];
+        const float* p0 = mesh->vertices + 3 * t[0];
+        const float* p1 = mesh->vertices + 3 * t[1];
+        const float* p2 = mesh->vertices + 3 * t[2];
+        double e1[3], e2[3];
+        for (int c = 0; c < 3; c++) {
+            e1[c] = (double)p1[c] - p0[c];
+            e2[c] = (double)p2[c] - p0[c];
+        }
+        double nrm[3] = {e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0]};
+        double nl = sqrt(nrm[0]*nrm[0] + nrm[1]*nrm[1] + nrm[2]*nrm[2]);
+        double el = sqrt(e1[0]*e1[0] + e1[1]*e1[1] + e1[2]*e1[2]);
+        if (nl < 1e-10 || el < 1e-10) continue;
+        double u_axis[3], v_axis[3];
+        for (int c = 0; c < 3; c++) {
+            nrm[c] /= nl;
+            u_axis[c] = e1[c] / el;
+        }
+        v_axis[0] = nrm[1]*u_axis[2] - nrm[2]*u_axis[1];
+        v_axis[1] = nrm[2]*u_axis[0] - nrm[0]*u_axis[2];
+        v_axis[2] = nrm[0]*u_axis[1] - nrm[1]*u_axis[0];
+        double q[3][2] = {{0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}};
+        for (int c = 0; c < 3; c++) {
+            q[1][0] += e1[c] * u_axis[c]; q[1][1] += e1[c] * v_axis[c];
+            q[2][0] += e2[c] * u_axis[c]; q[2][1] += e2[c] * v_axis[c];
+        }
+        double area = 0.5 * fabs(q[1][0] * q[2][1] - q[1][1] * q[2][0]);
+        if (area < 1e-10) continue;
+
+        const int v[3] = {local[t[0]], local[t[1]], local[t[2]]};
+        if (!normal) {
+            for (int k = 0; k < 3; k++) {
+                int a = v[k], b = v[(k + 1) % 3];
+                double dx = area * (q[(k + 1) % 3][0] - q[k][0]);
+                double dy = area * (q[(k + 1) % 3][1] - q[k][1]);
+                add(2*a, 2*b, dx);
+                add(2*a, 2*b + 1, dy);
+                add(2*a + 1, 2*b, dy);
+                add(2*a + 1, 2*b + 1, -dx);
+                add(2*a, 2*a, -dx);
+                add(2*a, 2*a + 1, -dy);
+                add(2*a + 1, 2*a, -dy);
+                add(2*a + 1, 2*a + 1, dx);
+            }
+        } else {
+            // The triangle's two rows of M, then their outer products into MᵀM
+            double w = 1.0 / (2.0 * sqrt(area));
+            int cols[6];
+            double rows[2][6];
+            for (int j = 0; j < 3; j++) {
+                const double* qk = q[(j + 1) % 3];
+                const double* ql = q[(j + 2) % 3];
+                double re = w * (qk[1] - ql[1]), im = w * (ql[0] - qk[0]);
+                cols[2*j] = 2*v[j];
+                cols[2*j + 1] = 2*v[j] + 1;
+                rows[0][2*j] = re;  rows[0][2*j + 1] = -im;
+                rows[1][2*j] = im;  rows[1][2*j + 1] = re;
+            }
+            for (int r = 0; r < 2; r++) {
+                for (int a = 0; a < 6; a++) {
+                    for (int b = 0; b < 6; b++) add(cols[a], cols[b], rows[r][a] * rows[r][b]);
+                }
+            }
+        }
+    }
+    return A;
+}
+
+/** Unknown of the full system behind each reduced unknown (pins left out) */
+static std::vector<int> lscm_free_unknowns(const LSCMLinearSystem* system) {
+    std::vector<int> full;
+    for (int v = 0; v < system->num_local; v++) {
+        if (v == system->pins[0] || v == system->pins[1]) continue;
+        full.push_back(2*v);
+        full.push_back(2*v + 1);
+    }
+    return full;
+}
+
+/**
+ * @brief Solve a dense row-major n x n system in place by Gaussian
+ *        elimination with partial pivoting
+ * @return false if the matrix is singular
+ */
+static bool dense_solve(std::vector<double>& A, std::vector<double>& b, int n) {
+    for (int k = 0; k < n; k++) {
+        int pivot = k;
+        for (int r = k + 1; r < n; r++) {
+            if (fabs(A[(size_t)r * n + k]) > fabs(A[(size_t)pivot * n + k])) pivot = r;
+        }
+        if (fabs(A[(size_t)pivot * n + k]) < 1e-300) return false;
+        if (pivot != k) {
+            for (int c = 0; c < n; c++) std::swap(A[(size_t)k * n + c], A[(size_t)pivot * n + c]);
+            std::swap(b[k], b[pivot]);
+        }
+        for (int r = k + 1; r < n; r++) {
+            double f = A[(size_t)r * n + k] / A[(size_t)k * n + k];
+            if (f == 0.0) continue;
+            for (int c = k; c < n; c++) A[(size_t)r * n + c] -= f * A[(size_t)k * n + c];
+            b[r] -= f * b[k];
+        }
+    }
+    for (int k = n - 1; k >= 0; k--) {
+        double sum = b[k];
+        for (int c = k + 1; c < n; c++) sum -= A[(size_t)k * n + c] * b[c];
+        b[k] = sum / A[(size_t)k * n + k];
+    }
+    return true;
+}
+
+void test_lscm_assembly(const char* mesh_name, int normal) {
+    printf("[TEST] LSCM %s assembly vs triplets - %s...", normal ? "normal" : "square", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    std::vector<int> faces(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    LSCMLinearSystem* system = lscm_assemble_system(mesh, faces.data(), (int)faces.size(), normal, NULL);
+    if (!system) {
+        printf(" FAIL (assembly failed)\n");
+        tests_failed++;
+        free_mesh(mesh);
+        return;
+    }
+
+    // Reference: the full matrix, pinned rows and columns removed; the
+    // pinned columns times the pin UVs move to the rhs
+    std::vector<double> full = lscm_reference_matrix(mesh, faces.data(), (int)faces.size(),
+                                                     system, normal != 0);
+    const size_t n2 = 2 * (size_t)system->num_local;
+    std::vector<int> free_unknowns = lscm_free_unknowns(system);
+    const int m = (int)free_unknowns.size();
+    std::vector<double> expected((size_t)m * m);
+    std::vector<double> expected_rhs(m, 0.0);
+    double scale = 0.0;
+    for (int r = 0; r < m; r++) {
+        const double* row = &full[free_unknowns[r] * n2];
+        for (int c = 0; c < m; c++) {
+            expected[(size_t)r * m + c] = row[free_unknowns[c]];
+            scale = std::max(scale, fabs(row[free_unknowns[c]]));
+        }
+        for (int p = 0; p < 2; p++) {
+            int pin = system->pins[p];
+            expected_rhs[r] -= row[2*pin] * system->pin_uvs[2*p] + row[2*pin + 1] * system->pin_uvs[2*p + 1];
+        }
+    }
+
+    // The normal equations store the lower triangle; every stored entry
+    // must match, and no lower-triangle entry may be missing
+    std::vector<double> got((size_t)m * m, 0.0);
+    int bad_pattern = system->size != m;
+    for (int c = 0; c < system->size && !bad_pattern; c++) {
+        for (int k = system->col_offsets[c]; k < system->col_offsets[c + 1]; k++) {
+            int r = system->row_indices[k];
+            if (k > system->col_offsets[c] && r <= system->row_indices[k - 1]) bad_pattern++;
+            got[(size_t)r * m + c] = system->values[k];
+        }
+    }
+    double matrix_error = 0.0, rhs_error = 0.0;
+    for (int c = 0; c < m && !bad_pattern; c++) {
+        for (int r = 0; r < m; r++) {
+            if (normal && r / 2 < c / 2) continue;
+            size_t rc = (size_t)r * m + c;
+            matrix_error = std::max(matrix_error, fabs(got[rc] - expected[rc]) / scale);
+        }
+        rhs_error = std::max(rhs_error, fabs(system->rhs[c] - expected_rhs[c]) / scale);
+    }
+
+    if (bad_pattern) {
+        printf(" FAIL (size %d, expected %d, or rows not ascending)\n", system->size, m);
+        tests_failed++;
+    } else if (matrix_error > 1e-12 || rhs_error > 1e-12) {
+        printf(" FAIL (matrix error %.2e, rhs error %.2e)\n", matrix_error, rhs_error);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d unknowns, %d stored, error %.1e)\n", m, system->col_offsets[m], matrix_error);
+        tests_passed++;
+    }
+
+    free_lscm_system(system);
+    free_mesh(mesh);
+}
+
+void test_lscm_pin_elimination(const char* mesh_name, int normal) {
+    printf("[TEST] LSCM %s pin elimination vs pinned rows - %s...", normal ? "normal" : "square", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    std::vector<int> faces(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    LSCMLinearSystem* system = lscm_assemble_system(mesh, faces.data(), (int)faces.size(), normal, NULL);
+    if (!system) {
+        printf(" FAIL (assembly failed)\n");
+        tests_failed++;
+        free_mesh(mesh);
+        return;
+    }
+
+    // Reference: every unknown kept, the pinned rows replaced by identity
+    // rows whose rhs is the pinned UV
+    std::vector<double> full = lscm_reference_matrix(mesh, faces.data(), (int)faces.size(),
+                                                     system, normal != 0);
+    const int n2 = 2 * system->num_local;
+    std::vector<char> pinned(n2, 0);
+    std::vector<double> b_full(n2, 0.0);
+    for (int p = 0; p < 2; p++) {
+        for (int d = 0; d < 2; d++) {
+            pinned[2 * system->pins[p] + d] = 1;
+            b_full[2 * system->pins[p] + d] = system->pin_uvs[2*p + d];
+        }
+    }
+    for (int r = 0; r < n2; r++) {
+        if (!pinned[r]) continue;
+        for (int c = 0; c < n2; c++) full[(size_t)r * n2 + c] = (c == r) ? 1.0 : 0.0;
+    }
+    std::vector<double> x_full = b_full;
+    bool ok = dense_solve(full, x_full, n2);
+
+    // Eliminated system, expanded from the stored columns (the normal
+    // equations mirror their lower triangle)
+    const int m = system->size;
+    std::vector<double> reduced((size_t)m * m, 0.0);
+    for (int c = 0; c < m; c++) {
+        for (int k = system->col_offsets[c]; k < system->col_offsets[c + 1]; k++) {
+            int r = system->row_indices[k];
+            reduced[(size_t)r * m + c] = system->values[k];
+            if (normal) reduced[(size_t)c * m + r] = system->values[k];
+        }
+    }
+    std::vector<double> x_free(system->rhs, system->rhs + m);
+    ok = dense_solve(reduced, x_free, m) && ok;
+
+    std::vector<int> free_unknowns = lscm_free_unknowns(system);
+    double difference = 0.0, pin_error = 0.0;
+    for (int k = 0; ok && k < m; k++) difference = std::max(difference, fabs(x_free[k] - x_full[free_unknowns[k]]));
+    for (int r = 0; ok && r < n2; r++) {
+        if (pinned[r]) pin_error = std::max(pin_error, fabs(x_full[r] - b_full[r]));
+    }
+
+    if (!ok) {
+        printf(" FAIL (singular system)\n");
+        tests_failed++;
+    } else if (difference > 1e-9 || pin_error > 1e-12) {
+        printf(" FAIL (max difference %.2e, pin error %.2e)\n", difference, pin_error);
+        tests_failed++;
+    } else {
+        printf(" PASS (max difference %.1e)\n", difference);
+        tests_passed++;
+    }
+
+    free_lscm_system(system);
+    free_mesh(mesh);
+}
+
+void test_lscm_solver(const char* mesh_name, int solver, int expected_used) {
+    printf("[TEST] LSCM solver %d - %s...", solver, mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    LSCMStats stats;
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.solver = solver;
+    options.stats = &stats;
+    int num_local = 0;
+    options.num_local_out = &num_local;
+
+    float* uvs = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    int in_range = uvs != NULL && num_local > 0;
+    for (int i = 0; uvs && i < 2 * num_local; i++) {
+        if (!isfinite(uvs[i]) || uvs[i] < -1e-4f || uvs[i] > 1.0f + 1e-4f) in_range = 0;
+    }
+
+    int did_work = stats.factor_nonzeros > 0 || stats.iterations > 0;
+    if (in_range && stats.solver_used == expected_used && did_work) {
+        printf(" PASS (used %d, factor nnz %lld, %d iterations)\n",
+               stats.solver_used, stats.factor_nonzeros, stats.iterations);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: solver %d, UVs in [0,1]\n", expected_used);
+        printf("  Got:      solver %d, UVs %s\n", stats.solver_used, in_range ? "ok" : "invalid");
+        tests_failed++;
+    }
+
+    free(uvs);
+    free(faces);
+    free_mesh(mesh);
+}
+
+void test_lscm_multigrid(const char* mesh_name, int coarse_vertices, float max_difference) {
+    printf("[TEST] LSCM multigrid vs LDLT - %s...", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    LSCMStats stats;
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.stats = &stats;
+    float* direct = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    // Coarsen well below the mesh size so the hierarchy has several levels
+    options.solver = LSCM_SOLVER_MULTIGRID;
+    options.mg_coarse_vertices = coarse_vertices;
+    int num_local = 0;
+    options.num_local_out = &num_local;
+    float* multigrid = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    float difference = (direct && multigrid) ? 0.0f : INFINITY;
+    for (int i = 0; direct && multigrid && i < 2 * num_local; i++) {
+        difference = fmaxf(difference, fabsf(direct[i] - multigrid[i]));
+    }
+
+    if (stats.solver_used == LSCM_SOLVER_MULTIGRID && stats.mg_levels > 1 &&
+        difference <= max_difference) {
+        printf(" PASS (%d levels, %d iterations, max UV difference %.4f)\n",
+               stats.mg_levels, stats.iterations, difference);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: multigrid over > 1 level, UVs within %.4f of LDLT\n", max_difference);
+        printf("  Got:      solver %d, %d levels, max difference %.4f\n",
+               stats.solver_used, stats.mg_levels, difference);
+        tests_failed++;
+    }
+
+    free(direct);
+    free(multigrid);
+    free(faces);
+    free_mesh(mesh);
+}
+
+void test_lscm_multigrid_auto(int n, int auto_vertices, float max_difference) {
+    printf("[TEST] LSCM multigrid above %d vertices - %d x %d grid...", auto_vertices, n, n);
+
+    Mesh* mesh = make_grid_mesh(n);
+    std::vector<int> faces(mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    LSCMStats stats;
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.stats = &stats;
+    options.mg_coarse_vertices = auto_vertices / 4;
+    int num_local = 0;
+    options.num_local_out = &num_local;
+
+    // Off by default: LDLT stays LDLT however large the island
+    float* direct = lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles, &options);
+    int default_used = stats.solver_used;
+
+    // A threshold above the island leaves LDLT alone too
+    options.mg_auto_vertices = mesh->num_vertices;
+    free(lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles, &options));
+    int at_size_used = stats.solver_used;
+
+    options.mg_auto_vertices = auto_vertices;
+    float* multigrid = lscm_parameterize_ex(mesh, faces.data(), mesh->num_triangles, &options);
+
+    float difference = (direct && multigrid) ? 0.0f : INFINITY;
+    for (int i = 0; direct && multigrid && i < 2 * num_local; i++) {
+        difference = fmaxf(difference, fabsf(direct[i] - multigrid[i]));
+    }
+
+    if (default_used == LSCM_SOLVER_LDLT && at_size_used == LSCM_SOLVER_LDLT &&
+        stats.solver_used == LSCM_SOLVER_MULTIGRID && stats.mg_levels > 1 &&
+        difference <= max_difference) {
+        printf(" PASS (%d levels, max UV difference %.4f)\n", stats.mg_levels, difference);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: LDLT, LDLT, then multigrid within %.4f of LDLT\n", max_difference);
+        printf("  Got:      solver %d, %d, %d, max difference %.4f\n",
+               default_used, at_size_used, stats.solver_used, difference);
+        tests_failed++;
+    }
+
+    free(direct);
+    free(multigrid);
+    free_mesh(mesh);
+}
+
+void test_lscm_precision(const char* mesh_name, int precision, float max_difference) {
+    printf("[TEST] LSCM precision %d vs double - %s...", precision, mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    LSCMStats stats;
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.stats = &stats;
+    int num_local = 0;
+    options.num_local_out = &num_local;
+    float* reference = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    options.precision = precision;
+    float* uvs = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    float difference = (reference && uvs) ? 0.0f : INFINITY;
+    for (int i = 0; reference && uvs && i < 2 * num_local; i++) {
+        difference = fmaxf(difference, fabsf(reference[i] - uvs[i]));
+    }
+
+    if (stats.precision_used == precision && difference <= max_difference) {
+        printf(" PASS (residual %.1e, %d refinement steps, max UV difference %.1e)\n",
+               stats.residual, stats.refinement_steps, difference);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: precision %d, UVs within %.1e of double\n", precision, max_difference);
+        printf("  Got:      precision %d, max difference %.1e\n", stats.precision_used, difference);
+        tests_failed++;
+    }
+
+    free(reference);
+    free(uvs);
+    free(faces);
+    free_mesh(mesh);
+}
+
+void test_lscm_warm_start(const char* mesh_name, int max_iterations) {
+    printf("[TEST] LSCM CG warm start - %s...", mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    int* local_to_global = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    float* previous = (float*)calloc(2 * (size_t)mesh->num_vertices, sizeof(float));
+
+    // Exact solve, scattered to mesh vertices as a "previous unwrap"
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    int num_local = 0;
+    options.local_to_global = local_to_global;
+    options.num_local_out = &num_local;
+    float* uvs = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+    for (int i = 0; uvs && i < num_local; i++) {
+        previous[2 * local_to_global[i]] = uvs[2 * i];
+        previous[2 * local_to_global[i] + 1] = uvs[2 * i + 1];
+    }
+    free(uvs);
+
+    // CG from the previous layout vs from the planar projection
+    LSCMStats warm, cold;
+    options.solver = LSCM_SOLVER_CG;
+    options.stats = &warm;
+    options.initial_uvs = previous;
+    free(lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options));
+    options.stats = &cold;
+    options.initial_uvs = NULL;
+    free(lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options));
+
+    if (warm.solver_used == LSCM_SOLVER_CG && warm.iterations <= max_iterations &&
+        warm.iterations <= cold.iterations) {
+        printf(" PASS (%d iterations warm, %d cold)\n", warm.iterations, cold.iterations);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: <= %d warm iterations\n", max_iterations);
+        printf("  Got:      %d warm, %d cold (solver %d)\n",
+               warm.iterations, cold.iterations, warm.solver_used);
+        tests_failed++;
+    }
+
+    free(previous);
+    free(local_to_global);
+    free(faces);
+    free_mesh(mesh);
+}
+
+/**
+ * @brief Mean |3D angle - UV angle| over the corners of the whole mesh, in
+ *        degrees, for island UVs returned with their local→global remap
+ */
+static double island_angle_error(const Mesh* mesh, const float* uvs,
+                                 const int* local_to_global, int num_local) {
+    int* local = (int*)malloc(sizeof(int) * mesh->num_vertices);
+    for (int i = 0; i < num_local; i++) local[local_to_global[i]] = i;
+
+    double total = 0.0;
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        for (int k = 0; k < 3; k++) {
+            int a = mesh->triangles[3*f + k];
+            int b = mesh->triangles[3*f + (k + 1) % 3];
+            int c = mesh->triangles[3*f + (k + 2) % 3];
+            float angle_3d = compute_vertex_angle_in_triangle(mesh, f, a);
+            const float* ua = uvs + 2 * local[a];
+            const float* ub = uvs + 2 * local[b];
+            const float* uc = uvs + 2 * local[c];
+            double u1 = ub[0] - ua[0], v1 = ub[1] - ua[1];
+            double u2 = uc[0] - ua[0], v2 = uc[1] - ua[1];
+            double angle_uv = atan2(fabs(u1*v2 - v1*u2), u1*u2 + v1*v2);
+            total += fabs(angle_3d - angle_uv);
+        }
+    }
+    free(local);
+    return total / (3.0 * mesh->num_triangles) * 180.0 / M_PI;
+}
+
+void test_abf(const char* mesh_name, double time_budget, int expected_result) {
+    printf("[TEST] ABF++ (budget %g s) vs LSCM - %s...", time_budget, mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    int* local_to_global = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    int num_local = 0;
+
+    LSCMOptions lscm_options;
+    memset(&lscm_options, 0, sizeof(lscm_options));
+    lscm_options.local_to_global = local_to_global;
+    lscm_options.num_local_out = &num_local;
+    float* lscm = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &lscm_options);
+
+    ABFStats stats;
+    ABFOptions options;
+    memset(&options, 0, sizeof(options));
+    options.time_budget_seconds = time_budget;
+    options.local_to_global = local_to_global;
+    options.num_local_out = &num_local;
+    options.stats = &stats;
+    float* abf = abf_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    double lscm_error = lscm ? island_angle_error(mesh, lscm, local_to_global, num_local) : INFINITY;
+    double abf_error = abf ? island_angle_error(mesh, abf, local_to_global, num_local) : INFINITY;
+
+    // Converged ABF++ must not be worse than LSCM; the fallback must be LSCM exactly
+    int ok = abf != NULL && stats.result == expected_result;
+    if (ok && expected_result == ABF_RESULT_ABF) {
+        ok = abf_error <= lscm_error + 1e-3;
+    } else if (ok) {
+        ok = lscm != NULL && memcmp(abf, lscm, sizeof(float) * 2 * num_local) == 0;
+    }
+
+    if (ok) {
+        printf(" PASS (%d iterations, angle error %.3f deg vs LSCM %.3f deg)\n",
+               stats.iterations, abf_error, lscm_error);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: result %d, angle error <= LSCM %.3f deg\n", expected_result, lscm_error);
+        printf("  Got:      result %d, angle error %.3f deg\n", stats.result, abf_error);
+        tests_failed++;
+    }
+
+    free(lscm);
+    free(abf);
+    free(local_to_global);
+    free(faces);
+    free_mesh(mesh);
+}
+
+void test_abf_lscm_options(const char* mesh_name, double time_budget) {
+    printf("[TEST] ABF++ forwards LSCM solver settings (budget %g s) - %s...", time_budget, mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+    int num_local = 0;
+
+    // Non-default solver; ABF++ must use it for the layout (or the fallback)
+    LSCMStats lscm_stats;
+    memset(&lscm_stats, 0, sizeof(lscm_stats));
+    lscm_stats.solver_used = -1;
+    LSCMOptions lscm_options;
+    memset(&lscm_options, 0, sizeof(lscm_options));
+    lscm_options.solver = LSCM_SOLVER_SPARSE_LU;
+    lscm_options.stats = &lscm_stats;
+
+    ABFOptions options;
+    memset(&options, 0, sizeof(options));
+    options.time_budget_seconds = time_budget;
+    options.num_local_out = &num_local;
+    options.lscm = &lscm_options;
+    float* uvs = abf_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+
+    int in_range = uvs != NULL && num_local > 0;
+    for (int i = 0; in_range && i < 2 * num_local; i++) {
+        if (!isfinite(uvs[i]) || uvs[i] < -1e-4f || uvs[i] > 1.0f + 1e-4f) in_range = 0;
+    }
+
+    if (in_range && lscm_stats.solver_used == LSCM_SOLVER_SPARSE_LU) {
+        printf(" PASS (solver %d, %d vertices)\n", lscm_stats.solver_used, num_local);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: solver %d, UVs in [0,1]\n", LSCM_SOLVER_SPARSE_LU);
+        printf("  Got:      solver %d, UVs %s\n", lscm_stats.solver_used, in_range ? "ok" : "invalid");
+        tests_failed++;
+    }
+
+    free(uvs);
+    free(faces);
+    free_mesh(mesh);
+}
+
+void test_lscm_cache(const char* mesh_name, int solver) {
+    printf("[TEST] LSCM factorization cache, solver %d - %s...", solver, mesh_name);
+
+    char filename[256];
+    snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
+
+    Mesh* mesh = load_obj(filename);
+    if (!mesh) {
+        printf(" FAIL (could not load)\n");
+        tests_failed++;
+        return;
+    }
+
+    int* faces = (int*)malloc(sizeof(int) * mesh->num_triangles);
+    for (int f = 0; f < mesh->num_triangles; f++) faces[f] = f;
+
+    // Off by default: nothing is kept until a budget is set
+    LSCMCacheStats before;
+    lscm_cache_get_stats(&before);
+    lscm_cache_clear();
+
+    LSCMStats stats;
+    LSCMOptions options;
+    memset(&options, 0, sizeof(options));
+    options.solver = solver;
+    options.stats = &stats;
+    int num_local = 0;
+    options.num_local_out = &num_local;
+
+    free(lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options));
+    const int unused = stats.cache_result;
+    lscm_cache_set_budget(256LL << 20);
+
+    // Cold, repeated, then uniformly scaled (same pins, new values)
+    int results[4];
+    float* first = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+    results[0] = stats.cache_result;
+    float* second = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+    results[1] = stats.cache_result;
+    for (int i = 0; i < 3 * mesh->num_vertices; i++) mesh->vertices[i] *= 1.5f;
+    float* reused = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+    results[2] = stats.cache_result;
+
+    // A budget too small for any entry evicts right after the solve, so
+    // this is a fresh analyzePattern + factorize of the scaled island
+    lscm_cache_set_budget(1);
+    float* fresh = lscm_parameterize_ex(mesh, faces, mesh->num_triangles, &options);
+    results[3] = stats.cache_result;
+    LSCMCacheStats after;
+    lscm_cache_get_stats(&after);
+    lscm_cache_set_budget(before.budget_bytes);
+
+    const size_t bytes = sizeof(float) * 2 * num_local;
+    int same = first && second && memcmp(first, second, bytes) == 0;
+    int same_reused = reused && fresh && memcmp(reused, fresh, bytes) == 0;
+
+    if (unused == LSCM_CACHE_UNUSED && before.budget_bytes == 0 && same && same_reused &&
+        results[0] == LSCM_CACHE_MISS && results[1] == LSCM_CACHE_NUMERIC_HIT &&
+        results[2] == LSCM_CACHE_SYMBOLIC_HIT && results[3] == LSCM_CACHE_MISS &&
+        after.entries == 0 && after.evictions >= 1) {
+        printf(" PASS (miss %lld, symbolic %lld, numeric %lld, evicted %lld)\n",
+               after.misses, after.symbolic_hits, after.numeric_hits, after.evictions);
+        tests_passed++;
+    } else {
+        printf(" FAIL\n");
+        printf("  Expected: off by default, then miss, numeric hit, symbolic hit, evicting miss;\n"
+               "            identical UVs with and without the reused pattern\n");
+        printf("  Got:      default budget %lld, %d, %d %d %d %d, %d entries, UVs %s / %s\n",
+               before.budget_bytes, unused, results[0], results[1], results[2], results[3],
+               after.entries, same ? "identical" : "different", same_reused ? "identical" : "different");
+        tests_failed++;
+    }
+
+    free(first);
+    free(second);
+    free(reused);
+    free(fresh);
+    free(faces);
+    free_mesh(mesh);
+}
+
+void test_seams(const char* mesh_name, int min_seams, int max_seams,
+                int method = SEAM_METHOD_SORTED_BFS) {
+    printf("[TEST] Seam Detection%s - %s...",
+           method == SEAM_METHOD_MST ? " (MST)" : "", mesh_name);
 
     char filename[256];
     snprintf(filename, sizeof(filename), "%s%s", TEST_DATA_DIR, mesh_name);
@@ -80,7 +1502,11 @@ void test_seams(const char* mesh_name, int min_seams, int max_seams) {
     }
 
     int num_seams;
-    int* seams = detect_seams(mesh, topo, 30.0f, &num_seams);
+    SeamOptions options;
+    memset(&options, 0, sizeof(options));
+    options.angle_threshold = 30.0f;
+    options.method = method;
+    int* seams = detect_seams_ex(mesh, topo, &options, &num_seams);
 
     if (!seams) {
         printf(" FAIL (seam detection failed)\n");
@@ -100,6 +1526,72 @@ void test_seams(const char* mesh_name, int min_seams, int max_seams) {
     free_mesh(mesh);
 }
 
+void test_extract_islands_threads(int n, int seam_period, int min_islands) {
+    printf("[TEST] Island extraction - %d x %d grid, 1 in %d edges seams, 1 / 2 / 8 threads...",
+           n, n, seam_period);
+
+    // A pseudo-random 1 / seam_period of the edges are seams. Dense seams
+    // leave islands of every size; sparse ones leave a few huge islands
+    // whose roots every union thread contends for
+    Mesh* mesh = make_grid_mesh(n);
+    TopologyInfo* topo = build_topology(mesh);
+    std::vector<int> seams;
+    for (int e = 0; topo && e < topo->num_edges; e++) {
+        if (((unsigned)e * 2654435761u >> 16) % (unsigned)seam_period == 0) seams.push_back(e);
+    }
+
+    // Parallel runs repeat: a racy find only shows up on some schedules
+    const int runs = 6;
+    int thread_counts[runs] = {1, 2, 8, 8, 8, 8};
+    int num_islands[runs] = {0};
+    int* ids[runs] = {NULL};
+    int* offsets[runs] = {NULL};
+    int* faces[runs] = {NULL};
+    for (int k = 0; topo && k < runs; k++) {
+        ids[k] = extract_islands(mesh, topo, seams.data(), (int)seams.size(), thread_counts[k],
+                                 &num_islands[k], &offsets[k], &faces[k]);
+    }
+
+    const size_t F = (size_t)mesh->num_triangles;
+    int differ = 0;
+    for (int k = 1; k < runs; k++) {
+        if (!ids[0] || !ids[k] || num_islands[k] != num_islands[0] ||
+            memcmp(ids[k], ids[0], sizeof(int) * F) != 0 ||
+            memcmp(offsets[k], offsets[0], sizeof(int) * (num_islands[0] + 1)) != 0 ||
+            memcmp(faces[k], faces[0], sizeof(int) * F) != 0) differ++;
+    }
+    int out_of_range = 0;
+    for (size_t f = 0; ids[0] && f < F; f++) {
+        if (ids[0][f] < 0 || ids[0][f] >= num_islands[0]) out_of_range++;
+    }
+
+    if (!topo || !ids[0]) {
+        printf(" FAIL (extraction failed)\n");
+        tests_failed++;
+    } else if (differ) {
+        printf(" FAIL (%d parallel run%s differ from serial)\n", differ, differ == 1 ? "" : "s");
+        tests_failed++;
+    } else if (out_of_range) {
+        printf(" FAIL (%d face%s outside the island ids)\n", out_of_range, out_of_range == 1 ? "" : "s");
+        tests_failed++;
+    } else if (num_islands[0] < min_islands) {
+        printf(" FAIL (%d island%s, expected at least %d)\n", num_islands[0],
+               num_islands[0] == 1 ? "" : "s", min_islands);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d island%s)\n", num_islands[0], num_islands[0] == 1 ? "" : "s");
+        tests_passed++;
+    }
+
+    for (int k = 0; k < runs; k++) {
+        free(ids[k]);
+        free(offsets[k]);
+        free(faces[k]);
+    }
+    free_topology(topo);
+    free_mesh(mesh);
+}
+
 void test_unwrap(const char* mesh_name, float max_stretch_threshold) {
     printf("[TEST] Unwrap - %s...", mesh_name);
 
@@ -114,6 +1606,7 @@ void test_unwrap(const char* mesh_name, float max_stretch_threshold) {
     }
 
     UnwrapParams params;
+    memset(&params, 0, sizeof(params));
     params.angle_threshold = 30.0f;
     params.min_island_faces = 5;
     params.pack_islands = 1;
@@ -138,10 +1631,24 @@ void test_unwrap(const char* mesh_name, float max_stretch_threshold) {
         return;
     }
 
+    // Island→faces index must list every face once, under its own island
+    int index_errors = (!result->island_face_offsets || !result->island_faces) ? 1 : 0;
+    for (int i = 0; i < result->num_islands && !index_errors; i++) {
+        for (int k = result->island_face_offsets[i]; k < result->island_face_offsets[i + 1]; k++) {
+            if (result->face_island_ids[result->island_faces[k]] != i) index_errors++;
+        }
+    }
+    if (!index_errors && result->island_face_offsets[result->num_islands] != mesh->num_triangles) {
+        index_errors++;
+    }
+
     // Check quality
     float stretch = result->max_stretch;
 
-    if (stretch > max_stretch_threshold) {
+    if (index_errors) {
+        printf(" FAIL (island face index inconsistent)\n");
+        tests_failed++;
+    } else if (stretch > max_stretch_threshold) {
         printf(" FAIL (stretch=%.2f > %.2f)\n", stretch, max_stretch_threshold);
         tests_failed++;
     } else {
@@ -154,6 +1661,581 @@ void test_unwrap(const char* mesh_name, float max_stretch_threshold) {
     free_mesh(mesh);
 }
 
+/**
+ * @brief Grids of the given sizes in a chain, each sharing its last vertex
+ *        with the next grid's first, so the islands meet at single vertices
+ */
+static Mesh* make_grid_chain(const std::vector<int>& sizes) {
+    int V = 1, F = 0;
+    for (int n : sizes) {
+        V += (n + 1) * (n + 1) - 1;
+        F += 2 * n * n;
+    }
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = V;
+    mesh->num_triangles = F;
+    mesh->vertices = (float*)malloc(sizeof(float) * 3 * V);
+    mesh->triangles = (int*)malloc(sizeof(int) * 3 * F);
+    mesh->uvs = NULL;
+
+    int v_offset = 0, f_offset = 0;
+    float origin[3] = {0.0f, 0.0f, 0.0f};
+    for (int n : sizes) {
+        // Grid vertex 0 sits at the local origin and lands on the previous
+        // grid's last vertex
+        Mesh* grid = make_grid_mesh(n);
+        for (int v = 0; v < grid->num_vertices; v++) {
+            float* p = mesh->vertices + 3 * (v_offset + v);
+            for (int c = 0; c < 3; c++) p[c] = origin[c] + grid->vertices[3*v + c];
+        }
+        for (int k = 0; k < 3 * grid->num_triangles; k++) {
+            mesh->triangles[3 * f_offset + k] = v_offset + grid->triangles[k];
+        }
+        v_offset += grid->num_vertices - 1;
+        f_offset += grid->num_triangles;
+        for (int c = 0; c < 3; c++) origin[c] = mesh->vertices[3 * v_offset + c];
+        free_mesh(grid);
+    }
+    return mesh;
+}
+
+void test_unwrap_threads() {
+    printf("[TEST] Unwrap - grid chain, 1 / 3 / 16 threads...");
+
+    // Islands of different sizes meeting at shared vertices, which islands
+    // solved on different threads both write; seams also cut single faces
+    // off the wavy grids, which are skipped but still packed
+    std::vector<int> sizes = {12, 5, 1, 20, 8, 3, 16};
+    Mesh* mesh = make_grid_chain(sizes);
+
+    UnwrapParams params;
+    memset(&params, 0, sizeof(params));
+    params.angle_threshold = 30.0f;
+    params.min_island_faces = 5;
+    params.pack_islands = 1;
+    params.island_margin = 0.02f;
+
+    int thread_counts[] = {1, 3, 16};
+    Mesh* unwrapped[3] = {NULL, NULL, NULL};
+    UnwrapResult* results[3] = {NULL, NULL, NULL};
+    for (int k = 0; k < 3; k++) {
+        params.num_threads = thread_counts[k];
+        unwrapped[k] = unwrap_mesh(mesh, &params, &results[k]);
+    }
+
+    const size_t V = (size_t)mesh->num_vertices;
+    int differ = 0;
+    for (int k = 1; k < 3; k++) {
+        if (!unwrapped[0] || !unwrapped[k] ||
+            memcmp(unwrapped[k]->uvs, unwrapped[0]->uvs, sizeof(float) * 2 * V) != 0 ||
+            memcmp(results[k]->vertex_island_ids, results[0]->vertex_island_ids, sizeof(int) * V) != 0) differ++;
+    }
+
+    // Every used vertex must carry the UVs of one of its own islands
+    int bad_owner = 0;
+    if (unwrapped[0]) {
+        const int* owner = results[0]->vertex_island_ids;
+        std::vector<char> seen(V, 0);
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            for (int j = 0; j < 3; j++) {
+                int v = mesh->triangles[3*f + j];
+                if (owner[v] == results[0]->face_island_ids[f]) seen[v] = 1;
+            }
+        }
+        for (int f = 0; f < mesh->num_triangles; f++) {
+            for (int j = 0; j < 3; j++) {
+                if (!seen[mesh->triangles[3*f + j]]) bad_owner++;
+            }
+        }
+    }
+
+    if (!unwrapped[0]) {
+        printf(" FAIL (unwrapping failed)\n");
+        tests_failed++;
+    } else if (differ) {
+        printf(" FAIL (%d thread count%s differ from serial)\n", differ, differ == 1 ? "" : "s");
+        tests_failed++;
+    } else if (bad_owner) {
+        printf(" FAIL (%d corners on a vertex owned by another island)\n", bad_owner);
+        tests_failed++;
+    } else if (results[0]->num_islands < 2) {
+        printf(" FAIL (only %d island)\n", results[0]->num_islands);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d islands)\n", results[0]->num_islands);
+        tests_passed++;
+    }
+
+    for (int k = 0; k < 3; k++) {
+        free_unwrap_result(results[k]);
+        free_mesh(unwrapped[k]);
+    }
+    free_mesh(mesh);
+}
+
+void test_unwrap_invalid_faces() {
+    printf("[TEST] Unwrap - faces with out-of-range corners...");
+
+    // build_topology skips these faces, so each becomes its own (skipped)
+    // island; unwrapping, density equalization and packing must not index
+    // vertices through them
+    Mesh* mesh = make_grid_mesh(8);
+    const int bad[] = {3, 40, 77};
+    mesh->triangles[3*bad[0] + 1] = -1;
+    mesh->triangles[3*bad[1]] = mesh->num_vertices;
+    mesh->triangles[3*bad[2] + 2] = mesh->num_vertices + 1000;
+
+    UnwrapParams params;
+    memset(&params, 0, sizeof(params));
+    params.angle_threshold = 30.0f;
+    params.min_island_faces = 2;
+    params.pack_islands = 1;
+    params.island_margin = 0.02f;
+    UnwrapResult* result = NULL;
+    Mesh* unwrapped = unwrap_mesh(mesh, &params, &result);
+
+    int finite = unwrapped != NULL;
+    for (int i = 0; unwrapped && i < 2 * mesh->num_vertices; i++) {
+        if (!isfinite(unwrapped->uvs[i])) finite = 0;
+    }
+
+    if (!unwrapped || !result) {
+        printf(" FAIL (unwrapping failed)\n");
+        tests_failed++;
+    } else if (!finite) {
+        printf(" FAIL (non-finite UVs)\n");
+        tests_failed++;
+    } else {
+        printf(" PASS (%d islands)\n", result->num_islands);
+        tests_passed++;
+    }
+
+    free_unwrap_result(result);
+    free_mesh(unwrapped);
+    free_mesh(mesh);
+}
+
+/**
+ * @brief Mesh of axis-aligned boxes (two triangles each, own vertices) with
+ *        matching UVs; box b = boxes[4b .. 4b+3] (x0, y0, x1, y1) belongs to
+ *        island box_island[b]
+ */
+static Mesh* make_box_mesh(const std::vector<float>& boxes, const std::vector<int>& box_island,
+                           int num_islands, UnwrapResult* result) {
+    const int num_boxes = (int)box_island.size();
+    Mesh* mesh = (Mesh*)malloc(sizeof(Mesh));
+    mesh->num_vertices = 4 * num_boxes;
+    mesh->num_triangles = 2 * num_boxes;
+    mesh->vertices = (float*)calloc(3 * (size_t)mesh->num_vertices, sizeof(float));
+    mesh->triangles = (int*)malloc(sizeof(int) * 3 * mesh->num_triangles);
+    mesh->uvs = (float*)malloc(sizeof(float) * 2 * mesh->num_vertices);
+
+    memset(result, 0, sizeof(*result));
+    result->num_islands = num_islands;
+    result->face_island_ids = (int*)malloc(sizeof(int) * mesh->num_triangles);
+
+    for (int b = 0; b < num_boxes; b++) {
+        const float* box = &boxes[4 * b];
+        float corners[4][2] = {{box[0], box[1]}, {box[2], box[1]}, {box[2], box[3]}, {box[0], box[3]}};
+        for (int c = 0; c < 4; c++) {
+            mesh->uvs[2 * (4*b + c) + 0] = corners[c][0];
+            mesh->uvs[2 * (4*b + c) + 1] = corners[c][1];
+        }
+        int* tri = mesh->triangles + 6*b;
+        tri[0] = 4*b; tri[1] = 4*b + 1; tri[2] = 4*b + 2;
+        tri[3] = 4*b; tri[4] = 4*b + 2; tri[5] = 4*b + 3;
+        result->face_island_ids[2*b] = result->face_island_ids[2*b + 1] = box_island[b];
+    }
+    return mesh;
+}
+
+/**
+ * @brief Box mesh of one random rectangle per island at the origin, w0 ..
+ *        w0 + dw wide and h0 .. h0 + dh high
+ */
+static Mesh* make_random_box_mesh(int num_islands, unsigned& seed, float w0, float dw, float h0, float dh,
+                                  UnwrapResult* result) {
+    std::vector<float> boxes;
+    std::vector<int> box_island;
+    for (int i = 0; i < num_islands; i++) {
+        const float w = w0 + dw * random01(seed);
+        const float h = h0 + dh * random01(seed);
+        boxes.insert(boxes.end(), {0.0f, 0.0f, w, h});
+        box_island.push_back(i);
+    }
+    return make_box_mesh(boxes, box_island, num_islands, result);
+}
+
+/** @brief UV bounding box (u0, v0, u1, v1) of every island, from its faces */
+static std::vector<float> island_uv_boxes(const Mesh* mesh, const UnwrapResult& result) {
+    std::vector<float> box(4 * (size_t)result.num_islands);
+    for (int i = 0; i < result.num_islands; i++) {
+        box[4*i] = box[4*i + 1] = 1e30f;
+        box[4*i + 2] = box[4*i + 3] = -1e30f;
+    }
+    for (int f = 0; f < mesh->num_triangles; f++) {
+        float* b = &box[4 * result.face_island_ids[f]];
+        for (int c = 0; c < 3; c++) {
+            const float* uv = mesh->uvs + 2 * mesh->triangles[3*f + c];
+            b[0] = fminf(b[0], uv[0]); b[1] = fminf(b[1], uv[1]);
+            b[2] = fmaxf(b[2], uv[0]); b[3] = fmaxf(b[3], uv[1]);
+        }
+    }
+    return box;
+}
+
+/** @brief Pairs of boxes (from island_uv_boxes) that overlap with positive area */
+static int count_box_overlaps(const std::vector<float>& box) {
+    const int n = (int)(box.size() / 4);
+    int overlaps = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) {
+            const float* a = &box[4*i];
+            const float* b = &box[4*j];
+            float ox = fminf(a[2], b[2]) - fmaxf(a[0], b[0]);
+            float oy = fminf(a[3], b[3]) - fmaxf(a[1], b[1]);
+            if (ox > 1e-6f && oy > 1e-6f) overlaps++;
+        }
+    }
+    return overlaps;
+}
+
+/** @brief UVs outside [0,1]², with a 1e-4 tolerance */
+static int count_uvs_outside_unit(const Mesh* mesh) {
+    int outside = 0;
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        const float* uv = mesh->uvs + 2 * v;
+        if (uv[0] < -1e-4f || uv[0] > 1.0f + 1e-4f || uv[1] < -1e-4f || uv[1] > 1.0f + 1e-4f) outside++;
+    }
+    return outside;
+}
+
+void test_packing(int num_islands, int method, int no_rotation, float min_coverage) {
+    printf("[TEST] Packing - %d rect islands (method %d%s)...", num_islands, method,
+           no_rotation ? ", no rotation" : "");
+
+    // Random rectangles, one per island
+    unsigned seed = 777u;
+    UnwrapResult result;
+    Mesh* mesh = make_random_box_mesh(num_islands, seed, 0.1f, 1.0f, 0.1f, 1.0f, &result);
+
+    PackOptions options;
+    memset(&options, 0, sizeof(options));
+    options.margin = 0.002f;
+    options.method = method;
+    options.no_rotation = no_rotation;
+    pack_uv_islands_ex(mesh, &result, &options);
+    compute_quality_metrics(mesh, &result);
+
+    // Boxes are packed with a margin, so any positive-area overlap is a bug
+    const int out_of_range = count_uvs_outside_unit(mesh);
+    const int overlaps = count_box_overlaps(island_uv_boxes(mesh, result));
+
+    if (out_of_range) {
+        printf(" FAIL (%d UVs outside [0,1])\n", out_of_range);
+        tests_failed++;
+    } else if (overlaps) {
+        printf(" FAIL (%d overlapping islands)\n", overlaps);
+        tests_failed++;
+    } else if (result.coverage < min_coverage) {
+        printf(" FAIL (coverage=%.1f%% < %.1f%%)\n", 100.0f * result.coverage,
+               100.0f * min_coverage);
+        tests_failed++;
+    } else {
+        printf(" PASS (coverage=%.1f%%)\n", 100.0f * result.coverage);
+        tests_passed++;
+    }
+
+    free(result.face_island_ids);
+    free_mesh(mesh);
+}
+
+void test_raster_nesting() {
+    printf("[TEST] Raster packing - island nests in a frame's hole...");
+
+    // A 1 x 1 frame of width 0.2 (four boxes) and a 0.4 x 0.4 square: the
+    // square only fits the 0.6 x 0.6 hole, which box packers never use
+    std::vector<float> boxes = {
+        0.0f, 0.0f, 1.0f, 0.2f,   0.0f, 0.8f, 1.0f, 1.0f,
+        0.0f, 0.2f, 0.2f, 0.8f,   0.8f, 0.2f, 1.0f, 0.8f,
+        0.0f, 0.0f, 0.4f, 0.4f,
+    };
+    std::vector<int> box_island = {0, 0, 0, 0, 1};
+    UnwrapResult result;
+    Mesh* mesh = make_box_mesh(boxes, box_island, 2, &result);
+
+    PackOptions options;
+    memset(&options, 0, sizeof(options));
+    options.margin = 0.01f;
+    options.method = PACK_METHOD_RASTER;
+    options.raster_resolution = 128;
+    pack_uv_islands_ex(mesh, &result, &options);
+
+    const std::vector<float> island_box = island_uv_boxes(mesh, result);
+    const float* box[2] = {&island_box[0], &island_box[4]};
+
+    // Frame and square are unit-scaled together; the hole is the middle 60%
+    const float side = box[0][2] - box[0][0];
+    const float hole[4] = {box[0][0] + 0.2f * side, box[0][1] + 0.2f * side,
+                           box[0][2] - 0.2f * side, box[0][3] - 0.2f * side};
+    const bool nested = box[1][0] >= hole[0] - 1e-4f && box[1][1] >= hole[1] - 1e-4f &&
+                        box[1][2] <= hole[2] + 1e-4f && box[1][3] <= hole[3] + 1e-4f;
+
+    if (!nested) {
+        printf(" FAIL (square at [%.3f, %.3f] - [%.3f, %.3f], hole [%.3f, %.3f] - [%.3f, %.3f])\n",
+               box[1][0], box[1][1], box[1][2], box[1][3], hole[0], hole[1], hole[2], hole[3]);
+        tests_failed++;
+    } else if (side < 0.99f) {
+        printf(" FAIL (frame side %.3f, expected it to span [0,1])\n", side);
+        tests_failed++;
+    } else {
+        printf(" PASS\n");
+        tests_passed++;
+    }
+
+    free(result.face_island_ids);
+    free_mesh(mesh);
+}
+
+void test_raster_coverage(int num_islands, float min_coverage) {
+    printf("[TEST] Raster packing - %d rectangles, L shapes and frames...", num_islands);
+
+    // A third each of rectangles, L shapes (two boxes) and square-cornered
+    // frames (four boxes) with sides of 0.1 - 1.1 and arms a quarter of the
+    // shorter side thick: the boxes of the last two are mostly empty
+    std::vector<float> boxes;
+    std::vector<int> box_island;
+    unsigned seed = 777u;
+    auto add_box = [&](int island, float x0, float y0, float x1, float y1) {
+        boxes.insert(boxes.end(), {x0, y0, x1, y1});
+        box_island.push_back(island);
+    };
+    for (int i = 0; i < num_islands; i++) {
+        const float w = 0.1f + random01(seed), h = 0.1f + random01(seed);
+        const float t = 0.25f * fminf(w, h);
+        if (i % 3 == 1) {
+            add_box(i, 0, 0, w, t);
+            add_box(i, 0, t, t, h);
+        } else if (i % 3 == 2) {
+            add_box(i, 0, 0, w, t);
+            add_box(i, 0, h - t, w, h);
+            add_box(i, 0, t, t, h - t);
+            add_box(i, w - t, t, w, h - t);
+        } else {
+            add_box(i, 0, 0, w, h);
+        }
+    }
+    UnwrapResult result;
+    Mesh* mesh = make_box_mesh(boxes, box_island, num_islands, &result);
+
+    PackOptions options;
+    memset(&options, 0, sizeof(options));
+    options.margin = 0.002f;
+    options.method = PACK_METHOD_RASTER;   // default resolution
+    pack_uv_islands_ex(mesh, &result, &options);
+    compute_quality_metrics(mesh, &result);
+
+    const int out_of_range = count_uvs_outside_unit(mesh);
+
+    if (out_of_range) {
+        printf(" FAIL (%d UVs outside [0,1])\n", out_of_range);
+        tests_failed++;
+    } else if (result.coverage < min_coverage) {
+        printf(" FAIL (coverage=%.1f%% < %.1f%%)\n", 100.0f * result.coverage, 100.0f * min_coverage);
+        tests_failed++;
+    } else {
+        printf(" PASS (coverage=%.1f%%)\n", 100.0f * result.coverage);
+        tests_passed++;
+    }
+
+    free(result.face_island_ids);
+    free_mesh(mesh);
+}
+
+void test_orient_islands(int num_islands) {
+    printf("[TEST] Orient islands - %d rotated rectangles...", num_islands);
+
+    // Rectangles turned by random angles; island 0 stays axis-aligned
+    std::vector<float> boxes;
+    std::vector<int> box_island;
+    std::vector<float> angles(num_islands), areas(num_islands);
+    unsigned seed = 4242u;
+    for (int i = 0; i < num_islands; i++) {
+        float w = 0.2f + random01(seed), h = 0.05f + 0.2f * random01(seed);
+        boxes.insert(boxes.end(), {0.0f, 0.0f, w, h});
+        box_island.push_back(i);
+        angles[i] = i == 0 ? 0.0f : 3.14159265f * random01(seed);
+        areas[i] = w * h;
+    }
+    UnwrapResult result;
+    Mesh* mesh = make_box_mesh(boxes, box_island, num_islands, &result);
+
+    for (int i = 0; i < num_islands; i++) {
+        float c = cosf(angles[i]), s = sinf(angles[i]);
+        for (int k = 0; k < 4; k++) {
+            float* uv = mesh->uvs + 2 * (4*i + k);
+            float u = uv[0], v = uv[1];
+            uv[0] = c * u - s * v;
+            uv[1] = s * u + c * v;
+        }
+    }
+    const std::vector<float> rotated_box = island_uv_boxes(mesh, result);
+    double before = 0.0, after = 0.0;
+    for (int i = 0; i < num_islands; i++) {
+        const float* b = &rotated_box[4*i];
+        before += (double)(b[2] - b[0]) * (b[3] - b[1]);
+        after += areas[i];
+    }
+    std::vector<float> island0(mesh->uvs, mesh->uvs + 8);
+
+    float saved = orient_uv_islands(mesh, &result, NULL);
+
+    // Every island's box should now be its rectangle
+    const std::vector<float> box = island_uv_boxes(mesh, result);
+    int loose = 0;
+    for (int i = 0; i < num_islands; i++) {
+        const float* b = &box[4*i];
+        if ((b[2] - b[0]) * (b[3] - b[1]) > areas[i] * 1.001f) loose++;
+    }
+    const float expected = (float)((before - after) / before);
+
+    if (loose) {
+        printf(" FAIL (%d islands not tight)\n", loose);
+        tests_failed++;
+    } else if (fabsf(saved - expected) > 1e-3f) {
+        printf(" FAIL (saved %.4f, expected %.4f)\n", saved, expected);
+        tests_failed++;
+    } else if (memcmp(island0.data(), mesh->uvs, sizeof(float) * 8) != 0) {
+        printf(" FAIL (axis-aligned island was moved)\n");
+        tests_failed++;
+    } else {
+        printf(" PASS (saved %.1f%%)\n", 100.0f * saved);
+        tests_passed++;
+    }
+
+    free(result.face_island_ids);
+    free_mesh(mesh);
+}
+
+void test_udim_packing(int num_islands, float texel_density, int tile_resolution) {
+    printf("[TEST] UDIM packing - %d rect islands at %.0f texels/unit, %d px tiles...",
+           num_islands, texel_density, tile_resolution);
+
+    // Random rectangles in mesh units, each parameterized at its own scale;
+    // island 0 is too long for one tile
+    std::vector<float> boxes;
+    std::vector<int> box_island;
+    std::vector<float> long_side(num_islands);
+    unsigned seed = 1001u;
+    for (int i = 0; i < num_islands; i++) {
+        float w = i == 0 ? 1.0f : 0.05f + 0.2f * random01(seed);
+        float h = i == 0 ? 0.2f : 0.05f + 0.2f * random01(seed);
+        boxes.insert(boxes.end(), {0.0f, 0.0f, w, h});
+        box_island.push_back(i);
+        long_side[i] = fmaxf(w, h);
+    }
+    UnwrapResult result;
+    Mesh* mesh = make_box_mesh(boxes, box_island, num_islands, &result);
+    for (int v = 0; v < mesh->num_vertices; v++) {
+        const float f = 0.5f + (float)(v / 4 % 7);
+        mesh->vertices[3*v] = mesh->uvs[2*v];
+        mesh->vertices[3*v + 1] = mesh->uvs[2*v + 1];
+        mesh->uvs[2*v] *= f;
+        mesh->uvs[2*v + 1] *= f;
+    }
+
+    std::vector<int> tiles(num_islands, -2);
+    PackOptions options;
+    memset(&options, 0, sizeof(options));
+    options.margin = 0.004f;
+    options.texel_density = texel_density;
+    options.tile_resolution = tile_resolution;
+    options.island_tiles = tiles.data();
+    options.num_tiles_out = &result.num_tiles;
+    pack_uv_islands_ex(mesh, &result, &options);
+    result.island_tiles = tiles.data();
+    compute_quality_metrics(mesh, &result);
+
+    // Each island inside its own tile, at the requested density
+    const float uv_per_unit = texel_density / tile_resolution;
+    const std::vector<float> box = island_uv_boxes(mesh, result);
+    int outside = 0, off_density = 0;
+    for (int i = 0; i < num_islands; i++) {
+        const float* b = &box[4*i];
+        const int t = tiles[i];
+        const float tu = (float)(t % 10), tv = (float)(t / 10);
+        if (t < 0 || t >= result.num_tiles || b[0] < tu - 1e-4f || b[2] > tu + 1.0f + 1e-4f ||
+            b[1] < tv - 1e-4f || b[3] > tv + 1.0f + 1e-4f) outside++;
+        const float uv_long = fmaxf(b[2] - b[0], b[3] - b[1]);
+        if (i > 0 && fabsf(uv_long - long_side[i] * uv_per_unit) > 1e-3f * uv_long) off_density++;
+    }
+
+    const int overlaps = count_box_overlaps(box);
+
+    if (result.num_tiles < 2) {
+        printf(" FAIL (%d tile%s, expected several)\n", result.num_tiles, result.num_tiles == 1 ? "" : "s");
+        tests_failed++;
+    } else if (outside) {
+        printf(" FAIL (%d islands outside their tile)\n", outside);
+        tests_failed++;
+    } else if (overlaps) {
+        printf(" FAIL (%d overlapping islands)\n", overlaps);
+        tests_failed++;
+    } else if (off_density) {
+        printf(" FAIL (%d islands off the texel density)\n", off_density);
+        tests_failed++;
+    } else {
+        printf(" PASS (%d tiles, coverage=%.1f%%)\n", result.num_tiles, 100.0f * result.coverage);
+        tests_passed++;
+    }
+
+    free(result.face_island_ids);
+    free_mesh(mesh);
+}
+
+void test_equalize_density(int num_islands) {
+    printf("[TEST] Texel density - %d islands at unrelated UV scales...", num_islands);
+
+    // Random rectangles in mesh units, each parameterized at its own scale
+    unsigned seed = 2024u;
+    UnwrapResult result;
+    Mesh* mesh = make_random_box_mesh(num_islands, seed, 0.05f, 1.0f, 0.05f, 1.0f, &result);
+    float min_f = 1e30f, max_f = 0.0f;
+    for (int i = 0; i < num_islands; i++) {
+        const float f = 0.1f + 10.0f * random01(seed);
+        min_f = fminf(min_f, f);
+        max_f = fmaxf(max_f, f);
+        for (int v = 4*i; v < 4*i + 4; v++) {
+            mesh->vertices[3*v] = mesh->uvs[2*v];
+            mesh->vertices[3*v + 1] = mesh->uvs[2*v + 1];
+            mesh->uvs[2*v] *= f;
+            mesh->uvs[2*v + 1] *= f;
+        }
+    }
+
+    float spread_before = equalize_texel_density(mesh, &result, NULL);
+
+    std::vector<float> density(num_islands);
+    result.island_density = density.data();
+    pack_uv_islands(mesh, &result, 0.002f);
+    compute_quality_metrics(mesh, &result);
+
+    if (fabsf(spread_before - max_f / min_f) > 1e-3f * max_f / min_f) {
+        printf(" FAIL (spread before %.3f, expected %.3f)\n", spread_before, max_f / min_f);
+        tests_failed++;
+    } else if (fabsf(result.density_spread - 1.0f) > 1e-3f) {
+        printf(" FAIL (spread after packing %.4f)\n", result.density_spread);
+        tests_failed++;
+    } else {
+        printf(" PASS (spread %.1fx -> %.4fx, coverage=%.1f%%)\n", spread_before,
+               result.density_spread, 100.0f * result.coverage);
+        tests_passed++;
+    }
+
+    free(result.face_island_ids);
+    free_mesh(mesh);
+}
+
 int main() {
     printf("\n");
     printf("========================================\n");
@@ -163,6 +2245,49 @@ int main() {
     // Topology tests
     test_topology("01_cube.obj", 8, 18, 12);
     test_topology("03_sphere.obj", 42, 120, 80);
+    test_topology_hashed("04_torus.obj");
+    test_topology_parallel(370, 4);             // 273,800 faces: 4 threads of >= 65,536
+
+    // Sharp-edge classification: 12 cube edges at 90°, 6 flat diagonals
+    test_sharp_edges("01_cube.obj", 30.0f, 12);
+    test_sharp_edges("01_cube.obj", 100.0f, 0);
+    test_face_geometry_kernel();
+
+    // Half-edge mesh and CSR vertex adjacency: open (cylinder) and closed meshes
+    test_halfedge_invariants("02_cylinder.obj");
+    test_halfedge_invariants("04_torus.obj");
+    test_vertex_adjacency("01_cube.obj");
+    test_vertex_adjacency("02_cylinder.obj");
+    test_vertex_adjacency("04_torus.obj");
+
+    // LSCM solvers: LDLT on open islands, closed islands keep SparseLU
+    test_boundary_loops("02_cylinder.obj", 2);
+    test_boundary_loops("03_sphere.obj", 0);
+    test_farthest_pair_pins(500);
+    test_lscm_assembly("02_cylinder.obj", 0);
+    test_lscm_assembly("02_cylinder.obj", 1);
+    test_lscm_assembly("04_torus.obj", 0);      // Closed: pins fall back to vertices 0, 1
+    test_lscm_pin_elimination("02_cylinder.obj", 0);
+    test_lscm_pin_elimination("02_cylinder.obj", 1);
+    test_lscm_solver("02_cylinder.obj", LSCM_SOLVER_LDLT, LSCM_SOLVER_LDLT);
+    test_lscm_solver("02_cylinder.obj", LSCM_SOLVER_SPARSE_LU, LSCM_SOLVER_SPARSE_LU);
+    test_lscm_solver("01_cube.obj", LSCM_SOLVER_LDLT, LSCM_SOLVER_SPARSE_LU);
+    test_lscm_solver("02_cylinder.obj", LSCM_SOLVER_CG, LSCM_SOLVER_CG);
+    test_lscm_solver("02_cylinder.obj", LSCM_SOLVER_MULTIGRID, LSCM_SOLVER_MULTIGRID);
+    test_lscm_multigrid("02_cylinder.obj", 16, 0.05f);
+    test_lscm_multigrid_auto(60, 2000, 0.05f);  // 3,721 vertices
+    test_lscm_precision("02_cylinder.obj", LSCM_PRECISION_FLOAT, 1e-2f);
+    test_lscm_precision("02_cylinder.obj", LSCM_PRECISION_MIXED, 1e-5f);
+    test_lscm_warm_start("02_cylinder.obj", 5);
+    test_lscm_cache("02_cylinder.obj", LSCM_SOLVER_LDLT);
+    test_lscm_cache("02_cylinder.obj", LSCM_SOLVER_SPARSE_LU);
+
+    // ABF++: converges on the open cylinder, LSCM on closed islands or out of time
+    test_abf("02_cylinder.obj", 0.0, ABF_RESULT_ABF);
+    test_abf("02_cylinder.obj", 1e-9, ABF_RESULT_LSCM_FALLBACK);
+    test_abf("03_sphere.obj", 0.0, ABF_RESULT_LSCM_FALLBACK);
+    test_abf_lscm_options("02_cylinder.obj", 0.0);
+    test_abf_lscm_options("02_cylinder.obj", 1e-9);
 
     // Seam detection tests
     // Basic spanning tree should produce minimum seams
@@ -170,11 +2295,33 @@ int main() {
     test_seams("01_cube.obj", 7, 11);           // Basic: 7, refined: 7-11
     test_seams("03_sphere.obj", 1, 5);          // Sphere needs more seams due to curvature
     test_seams("02_cylinder.obj", 1, 3);        // Cylinder: 1-2 seams typically
+    test_seams("01_cube.obj", 7, 11, SEAM_METHOD_MST);
+
+    // Union-find island extraction: identical at every thread count
+    test_extract_islands_threads(300, 4, 2);    // ~270k edges: 4 union threads of >= 65,536
+    test_extract_islands_threads(300, 64, 1);   // One huge island: every thread contends
 
     // Full unwrap tests
     test_unwrap("01_cube.obj", 2.0f);           // Allow up to 2.0 stretch
     test_unwrap("03_sphere.obj", 2.0f);
     test_unwrap("02_cylinder.obj", 1.5f);       // Cylinder should be better
+    test_unwrap("04_torus.obj", 2.0f);          // Several islands at 30°
+    test_unwrap_threads();
+    test_unwrap_invalid_faces();
+
+    // Packers: in [0,1] without overlaps; MaxRects packs tightest
+    test_packing(200, PACK_METHOD_MAXRECTS, 0, 0.80f);
+    test_packing(200, PACK_METHOD_MAXRECTS, 1, 0.80f);
+    test_packing(200, PACK_METHOD_SKYLINE, 0, 0.60f);
+    test_packing(200, PACK_METHOD_SHELF, 0, 0.50f);
+    test_packing(200, PACK_METHOD_SHELF, 1, 0.50f);
+    test_packing(200, PACK_METHOD_RASTER, 0, 0.75f);
+    test_packing(200, PACK_METHOD_RASTER, 1, 0.75f);
+    test_raster_nesting();
+    test_raster_coverage(150, 0.75f);     // the raster packer's coverage target
+    test_orient_islands(50);
+    test_udim_packing(300, 1024.0f, 512);
+    test_equalize_density(100);
 
     printf("\n");
     printf("========================================\n");
@@ -101,6 +101,26 @@ class CUnwrapParams(ctypes.Structure):
         ('min_island_faces', ctypes.c_int),
         ('pack_islands', ctypes.c_int),
         ('island_margin', ctypes.c_float),
+        ('seam_method', ctypes.c_int),
+        ('num_threads', ctypes.c_int),
+        ('lscm_solver', ctypes.c_int),
+        ('cg_tolerance', ctypes.c_float),
+        ('cg_max_iterations', ctypes.c_int),
+        ('cg_preconditioner', ctypes.c_int),
+        ('warm_start', ctypes.c_int),
+        ('lscm_precision', ctypes.c_int),
+        ('param_method', ctypes.c_int),
+        ('abf_time_budget', ctypes.c_float),
+        ('pack_method', ctypes.c_int),
+        ('pack_no_rotation', ctypes.c_int),
+        ('pack_resolution', ctypes.c_int),
+        ('pack_time_budget', ctypes.c_float),
+        ('pack_no_orient', ctypes.c_int),
+        ('udim_texel_density', ctypes.c_float),
+        ('udim_tile_resolution', ctypes.c_int),
+        ('pack_no_equalize', ctypes.c_int),
+        ('lscm_multigrid_above', ctypes.c_int),
+        ('refine_tolerance', ctypes.c_float),
     ]
 
 
@@ -114,6 +134,14 @@ class CUnwrapResult(ctypes.Structure):
         ('avg_stretch', ctypes.c_float),
         ('max_stretch', ctypes.c_float),
         ('coverage', ctypes.c_float),
+        ('island_face_offsets', ctypes.POINTER(ctypes.c_int)),
+        ('island_faces', ctypes.POINTER(ctypes.c_int)),
+        ('bbox_area_saved', ctypes.c_float),
+        ('num_tiles', ctypes.c_int),
+        ('island_tiles', ctypes.POINTER(ctypes.c_int)),
+        ('island_density', ctypes.POINTER(ctypes.c_float)),
+        ('density_spread', ctypes.c_float),
+        ('vertex_island_ids', ctypes.POINTER(ctypes.c_int)),
     ]
 
 
@@ -345,6 +373,8 @@ def unwrap(mesh, params=None):
     c_params.min_island_faces = min_faces
     c_params.pack_islands = pack
     c_params.island_margin = margin
+    c_params.seam_method = int(p.get('seam_method', 0))
+    c_params.num_threads = int(p.get('num_threads', 0))
     c_out_mesh_ptr = ctypes.POINTER(CMesh)() # Initially null
     c_result = CUnwrapResult()
     # 3. Call C library unwrap_mesh function